@@ -45,7 +45,7 @@ namespace Plugins::Afk
 			return;
 		}
 
-		Hk::Message::FMsgS(systemId.value(), message);
+		global->broadcaster.ToSystem(systemId.value(), Broadcast::Payload(message));
 
 		PrintUserCmdText(client, L"Use the /back command to stop sending automatic replies to PMs.");
 	}
@@ -69,7 +69,7 @@ namespace Plugins::Afk
 			global->awayClients.erase(it);
 			const std::wstring playerName = reinterpret_cast<const wchar_t*>(Players.GetActiveCharacterName(client));
 			const auto message = Hk::Message::FormatMsg(MessageColor::Red, MessageFormat::Normal, playerName + L" has returned");
-			Hk::Message::FMsgS(systemId.value(), message);
+			global->broadcaster.ToSystem(systemId.value(), Broadcast::Payload(message));
 			return;
 		}
 	}
@@ -79,6 +79,24 @@ namespace Plugins::Afk
 	{
 		auto [first, last] = std::ranges::remove(global->awayClients, client);
 		global->awayClients.erase(first, last);
+		global->broadcaster.systems.Remove(client);
+	}
+
+	// Keep track of the system each player is in for the away messages, which are sent to everyone in the system
+	void UpdateSystem([[maybe_unused]] const uint& shipOrBase, ClientId& client)
+	{
+		global->broadcaster.systems.Update(client);
+	}
+
+	void JumpInComplete([[maybe_unused]] const SystemId& system, const ShipId& ship)
+	{
+		if (const auto client = Hk::Client::GetClientIdByShip(ship); client.has_value())
+			global->broadcaster.systems.Update(client.value());
+	}
+
+	void LoadSettings()
+	{
+		global->broadcaster.systems.Rebuild();
 	}
 
 	// Hook on chat being sent (This gets called twice with the client and to
@@ -111,7 +129,7 @@ namespace Plugins::Afk
 
 using namespace Plugins::Afk;
 
-DefaultDllMain();
+DefaultDllMainSettings(LoadSettings);
 // Functions to hook
 extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 {
@@ -125,4 +143,8 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 	pi->emplaceHook(HookedCall::FLHook__ClearClientInfo, &ClearClientInfo, HookStep::After);
 	pi->emplaceHook(HookedCall::IChat__SendChat, &Cb_SendChat);
 	pi->emplaceHook(HookedCall::IServerImpl__SubmitChat, &SubmitChat);
+	pi->emplaceHook(HookedCall::IServerImpl__PlayerLaunch, &UpdateSystem, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__BaseEnter, &UpdateSystem, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__JumpInComplete, &JumpInComplete, HookStep::After);
+	pi->emplaceHook(HookedCall::FLHook__LoadSettings, &LoadSettings, HookStep::After);
 }
@@ -4,6 +4,8 @@
 #include <FLHook.hpp>
 #include <plugin.h>
 
+#include "../common/Broadcast.h"
+
 namespace Plugins::Afk
 {
 	//! Global data for this plugin
@@ -13,5 +15,7 @@ namespace Plugins::Afk
 		ReturnCode returnCode = ReturnCode::Default;
 
 		std::vector<uint> awayClients;
+		//! Sends the away messages, encoded once, to everyone in the system
+		Broadcast::Broadcaster broadcaster;
 	};
 } // namespace Plugins::Afk
\ No newline at end of file
@@ -35,25 +35,84 @@ namespace Plugins::Autobuy
 {
 	const std::unique_ptr<Global> global = std::make_unique<Global>();
 
+	//! The keys the autobuy settings are stored under, in the order of the AutobuyInfo fields
+	constexpr std::array<std::pair<const char*, bool AutobuyInfo::*>, 8> AutobuyKeys = {{
+	    {"autobuy.missiles", &AutobuyInfo::missiles},
+	    {"autobuy.mines", &AutobuyInfo::mines},
+	    {"autobuy.torps", &AutobuyInfo::torps},
+	    {"autobuy.cd", &AutobuyInfo::cd},
+	    {"autobuy.cm", &AutobuyInfo::cm},
+	    {"autobuy.bb", &AutobuyInfo::bb},
+	    {"autobuy.repairs", &AutobuyInfo::repairs},
+	    {"autobuy.shells", &AutobuyInfo::shells},
+	}};
+
 	void LoadPlayerAutobuy(ClientId client)
 	{
+		// Read the character's section of flhookuser.ini once, every setting after that is served from memory
+		const CAccount* acc = Players.FindAccountFromClientID(client);
+		const auto fileName = Hk::Client::GetCharFileName(client);
+		if (!acc || !fileName.has_value())
+		{
+			global->autobuyInfo[client] = AutobuyInfo {};
+			return;
+		}
+
+		global->characterSettings.Load(client,
+		    CoreGlobals::c()->accPath + wstos(Hk::Client::GetAccountDirName(acc)) + "\\flhookuser.ini",
+		    "general_" + wstos(fileName.value()));
+
+		// Settings saved before they moved to flhookuser.ini are read from the character file one last time and written back with the next flush
+		const bool migrated = global->characterSettings.GetBool(client, "autobuy.migrated").value_or(false);
+
 		AutobuyInfo playerAutobuyInfo {};
-		playerAutobuyInfo.missiles = Hk::Ini::GetCharacterIniBool(client, L"autobuy.missiles");
-		playerAutobuyInfo.mines = Hk::Ini::GetCharacterIniBool(client, L"autobuy.mines");
-		playerAutobuyInfo.torps = Hk::Ini::GetCharacterIniBool(client, L"autobuy.torps");
-		playerAutobuyInfo.cd = Hk::Ini::GetCharacterIniBool(client, L"autobuy.cd");
-		playerAutobuyInfo.cm = Hk::Ini::GetCharacterIniBool(client, L"autobuy.cm");
-		playerAutobuyInfo.bb = Hk::Ini::GetCharacterIniBool(client, L"autobuy.bb");
-		playerAutobuyInfo.repairs = Hk::Ini::GetCharacterIniBool(client, L"autobuy.repairs");
-		playerAutobuyInfo.shells = Hk::Ini::GetCharacterIniBool(client, L"autobuy.shells");
+		for (const auto& [key, field] : AutobuyKeys)
+		{
+			if (migrated)
+				playerAutobuyInfo.*field = global->characterSettings.GetBool(client, key).value_or(false);
+			else
+			{
+				playerAutobuyInfo.*field = Hk::Ini::GetCharacterIniBool(client, stows(key));
+				global->characterSettings.SetBool(client, key, playerAutobuyInfo.*field);
+			}
+		}
+
+		global->characterSettings.SetBool(client, "autobuy.migrated", true);
 		global->autobuyInfo[client] = playerAutobuyInfo;
 	}
 
+	void SavePlayerAutobuy(ClientId client, const AutobuyInfo& info)
+	{
+		for (const auto& [key, field] : AutobuyKeys)
+			global->characterSettings.SetBool(client, key, info.*field);
+	}
+
 	void ClearClientInfo(ClientId& client)
 	{
+		if (!global->characterSettings.Unload(client))
+			AddLog(LogType::Normal, LogLevel::Err, std::format("Unable to write the character settings of client {}, retrying later", client));
 		global->autobuyInfo.erase(client);
 	}
 
+	/** @ingroup Autobuy
+	 * @brief Writes the changed settings of every player to disk, so little is lost if the server goes down
+	 */
+	void FlushCharacterSettings()
+	{
+		for (const auto& file : global->characterSettings.FlushAll())
+			AddLog(LogType::Normal, LogLevel::Err, std::format("Unable to write character settings to {}, retrying later", file.string()));
+	}
+
+	/** @ingroup Autobuy
+	 * @brief Shutdown hook. Writes the autobuy settings still pending.
+	 */
+	void Shutdown()
+	{
+		FlushCharacterSettings();
+	}
+
+	const std::vector<Timer> timers = {{FlushCharacterSettings, 60}};
+
 	int PlayerGetAmmoCount(const std::list<CARGO_INFO>& cargoList, uint itemArchId)
 	{
 		if (auto foundCargo = std::ranges::find_if(cargoList, [itemArchId](const CARGO_INFO& cargo) { return cargo.iArchId == itemArchId; });
@@ -439,9 +498,6 @@ namespace Plugins::Autobuy
 			return;
 		}
 
-		const auto fileName = Hk::Client::GetCharFileName(client);
-		std::string scSection = "autobuy_" + wstos(fileName.value());
-
 		bool enable = newState == L"on";
 		if (autobuyType == L"all")
 		{
@@ -453,54 +509,38 @@ namespace Plugins::Autobuy
 			autobuyInfo.cm = enable;
 			autobuyInfo.bb = enable;
 			autobuyInfo.repairs = enable;
-			Hk::Ini::SetCharacterIni(client, L"autobuy.missiles", stows(enable ? "true" : "false"));
-			Hk::Ini::SetCharacterIni(client, L"autobuy.mines", stows(enable ? "true" : "false"));
-			Hk::Ini::SetCharacterIni(client, L"autobuy.shells", stows(enable ? "true" : "false"));
-			Hk::Ini::SetCharacterIni(client, L"autobuy.torps", stows(enable ? "true" : "false"));
-			Hk::Ini::SetCharacterIni(client, L"autobuy.cd", stows(enable ? "true" : "false"));
-			Hk::Ini::SetCharacterIni(client, L"autobuy.cm", stows(enable ? "true" : "false"));
-			Hk::Ini::SetCharacterIni(client, L"autobuy.bb", stows(enable ? "true" : "false"));
-			Hk::Ini::SetCharacterIni(client, L"autobuy.repairs", stows(enable ? "true" : "false"));
 		}
 		else if (autobuyType == L"missiles")
 		{
 			autobuyInfo.missiles = enable;
-			Hk::Ini::SetCharacterIni(client, L"autobuy.missiles", stows(enable ? "true" : "false"));
 		}
 		else if (autobuyType == L"mines")
 		{
 			autobuyInfo.mines = enable;
-			Hk::Ini::SetCharacterIni(client, L"autobuy.mines", stows(enable ? "true" : "false"));
 		}
 		else if (autobuyType == L"shells")
 		{
 			autobuyInfo.shells = enable;
-			Hk::Ini::SetCharacterIni(client, L"autobuy.shells", stows(enable ? "true" : "false"));
 		}
 		else if (autobuyType == L"torps")
 		{
 			autobuyInfo.torps = enable;
-			Hk::Ini::SetCharacterIni(client, L"autobuy.torps", stows(enable ? "true" : "false"));
 		}
 		else if (autobuyType == L"cd")
 		{
 			autobuyInfo.cd = enable;
-			Hk::Ini::SetCharacterIni(client, L"autobuy.cd", stows(enable ? "true" : "false"));
 		}
 		else if (autobuyType == L"cm")
 		{
 			autobuyInfo.cm = enable;
-			Hk::Ini::SetCharacterIni(client, L"autobuy.cm", stows(enable ? "true" : "false"));
 		}
 		else if (autobuyType == L"bb")
 		{
 			autobuyInfo.bb = enable;
-			Hk::Ini::SetCharacterIni(client, L"autobuy.bb", stows(enable ? "true" : "false"));
 		}
 		else if (autobuyType == L"repairs")
 		{
 			autobuyInfo.repairs = enable;
-			Hk::Ini::SetCharacterIni(client, L"autobuy.repairs", stows(enable ? "true" : "false"));
 		}
 		else
 		{
@@ -508,7 +548,7 @@ namespace Plugins::Autobuy
 			return;
 		}
 
-		Hk::Player::SaveChar(client);
+		SavePlayerAutobuy(client, autobuyInfo);
 		PrintUserCmdText(client, L"OK");
 	}
 
@@ -542,5 +582,7 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 	pi->versionMinor(PluginMinorVersion::VERSION_00);
 	pi->emplaceHook(HookedCall::FLHook__LoadSettings, &LoadSettings, HookStep::After);
 	pi->emplaceHook(HookedCall::FLHook__ClearClientInfo, &ClearClientInfo, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__Shutdown, &Shutdown);
 	pi->emplaceHook(HookedCall::IServerImpl__BaseEnter, &OnBaseEnter, HookStep::After);
+	pi->timers(&timers);
 }
\ No newline at end of file
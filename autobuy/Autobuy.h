@@ -3,6 +3,8 @@
 #include <FLHook.hpp>
 #include <plugin.h>
 
+#include "../common/CharacterSettings.h"
+
 namespace Plugins::Autobuy
 {
 	//! A struct to represent each client
@@ -44,6 +46,8 @@ namespace Plugins::Autobuy
 	{
 		std::unique_ptr<Config> config = nullptr;
 		std::map<uint, AutobuyInfo> autobuyInfo;
+		//! The character's section of flhookuser.ini, read once and written back on disconnect or by the flush timer
+		CharacterSettings::Cache characterSettings;
 		ReturnCode returnCode = ReturnCode::Default;
 	};
 
@@ -91,16 +91,15 @@ namespace Plugins::BountyHunt
 		}
 
 		uint time = wcstol(timeString.c_str(), nullptr, 10);
-		const auto targetId = Hk::Client::GetClientIdFromCharName(target);
-
-		int rankTarget = Hk::Player::GetRank(targetId.value()).value();
-
-		if (targetId == UINT_MAX || Hk::Client::IsInCharSelectMenu(targetId.value()))
+		const auto targetId = global->onlinePlayers.Find(target);
+		if (!targetId || Hk::Client::IsInCharSelectMenu(targetId.value()))
 		{
 			PrintUserCmdText(client, std::format(L"{} is not online.", target));
 			return;
 		}
 
+		int rankTarget = Hk::Player::GetRank(targetId.value()).value();
+
 		if (rankTarget < global->config->levelProtect)
 		{
 			PrintUserCmdText(client, L"Low level players may not be hunted.");
@@ -283,6 +282,7 @@ namespace Plugins::BountyHunt
 	void DisConnect(ClientId& client, [[maybe_unused]] const enum EFLConnection& state)
 	{
 		checkIfPlayerFled(client);
+		global->onlinePlayers.Remove(client);
 	}
 
 	/** @ingroup BountyHunt
@@ -291,6 +291,8 @@ namespace Plugins::BountyHunt
 	void CharacterSelect([[maybe_unused]] const std::string& charFilename, ClientId& client)
 	{
 		checkIfPlayerFled(client);
+		if (const auto charName = (const wchar_t*)Players.GetActiveCharacterName(client))
+			global->onlinePlayers.Add(client, charName);
 	}
 
 	// Client command processing
@@ -306,6 +308,10 @@ namespace Plugins::BountyHunt
 	{
 		auto config = Serializer::JsonToObject<Config>();
 		global->config = std::make_unique<Config>(config);
+
+		global->onlinePlayers.Clear();
+		for (const auto& player : Hk::Admin::GetPlayers())
+			global->onlinePlayers.Add(player.client, player.character);
 	}
 } // namespace Plugins::BountyHunt
 
@@ -4,6 +4,8 @@
 #include <FLHook.hpp>
 #include <plugin.h>
 
+#include "../common/PlayerIndex.h"
+
 namespace Plugins::BountyHunt
 {
 	//! Structs
@@ -39,5 +41,7 @@ namespace Plugins::BountyHunt
 		std::unique_ptr<Config> config = nullptr;
 		ReturnCode returnCode = ReturnCode::Default;
 		std::vector<BountyHunt> bountyHunt;
+		//! The characters that are online by name, maintained on character select and disconnect
+		PlayerIndex::Index onlinePlayers;
 	};
 } // namespace Plugins::BountyHunt
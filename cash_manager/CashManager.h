@@ -3,6 +3,8 @@
 #include <FLHook.hpp>
 #include <plugin.h>
 
+#include "../common/Random.h"
+
 namespace Plugins::CashManager
 {
 	enum class BankCode
@@ -1,4 +1,3 @@
-#include <random>
 #include "CashManager.h"
 
 namespace Plugins::CashManager::Sql
@@ -28,12 +27,11 @@ namespace Plugins::CashManager::Sql
 	{
 		const std::vector letters = {
 		    'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z'};
-		std::random_device dev;
-		std::mt19937 r(dev());
-		std::uniform_int_distribution<std::size_t> randLetter(0, letters.size() - 1);
-		std::uniform_int_distribution<std::size_t> randNumber(0, 9);
+		// Passwords must never be reproducible, so every password gets a fresh stream seeded from std::random_device
+		Random::Stream passwordStream {"CashManager"};
 		std::stringstream ss;
-		ss << letters[randLetter(r)] << randNumber(r) << randNumber(r) << randNumber(r) << randNumber(r);
+		ss << letters[passwordStream.Below(static_cast<uint>(letters.size()))] << passwordStream.Below(10) << passwordStream.Below(10)
+		   << passwordStream.Below(10) << passwordStream.Below(10);
 		return ss.str();
 	}
 
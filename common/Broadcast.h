@@ -0,0 +1,162 @@
+#pragma once
+#include <FLHook.hpp>
+
+// Shared by several plugins through a relative include. Renders a chat message once and sends the same encoded bytes to every recipient, rather
+// than formatting and encoding it again for each of them.
+namespace Plugins::Broadcast
+{
+	//! How much was rendered compared to how much was sent, the difference being encoding work broadcasting saved
+	struct Counters final
+	{
+		uint64_t broadcasts = 0;
+		uint64_t bytesRendered = 0;
+		uint64_t recipients = 0;
+		uint64_t bytesSent = 0;
+	};
+
+	//! A chat message encoded once, ready to be sent to any number of clients
+	class Payload final
+	{
+	  public:
+		Payload() = default;
+
+		//! Encodes an XML message, e.g. one made by Hk::Message::FormatMsg. Leaves the payload empty if it does not encode.
+		explicit Payload(const std::wstring& xml)
+		{
+			char buffer[0x1000];
+			uint size;
+			if (Hk::Message::FMsgEncodeXML(xml, buffer, sizeof(buffer), size).has_error())
+				return;
+
+			encoded.assign(buffer, buffer + size);
+		}
+
+		//! Encodes plain text in the style PrintUserCmdText uses
+		static Payload FromUserText(const std::wstring& text)
+		{
+			return Payload(L"<TRA data=\"" + FLHookConfig::i()->messages.msgStyle.userCmdStyle + L"\" mask=\"-1\"/><TEXT>" + XMLText(text) + L"</TEXT>");
+		}
+
+		//! Encodes a configured line, which is sent as is if it is XML and as user command text otherwise
+		static Payload FromLine(const std::wstring& line) { return line.find(L"<TRA") == 0 ? Payload(line) : FromUserText(line); }
+
+		[[nodiscard]] bool Empty() const { return encoded.empty(); }
+		[[nodiscard]] uint Size() const { return static_cast<uint>(encoded.size()); }
+
+		void SendTo(ClientId client) const
+		{
+			// FMsgSendChat takes a mutable buffer, but only reads from it
+			Hk::Message::FMsgSendChat(client, const_cast<char*>(encoded.data()), Size());
+		}
+
+	  private:
+		std::vector<char> encoded;
+	};
+
+	//! The online clients of every system. Updated from the hooks that move a player between systems, so a system-wide message does not
+	//! need to look up the system of every online player.
+	class SystemMembership final
+	{
+	  public:
+		//! Files a client under the system it is currently in
+		void Update(ClientId client)
+		{
+			if (client < 1 || client > MaxClientId)
+				return;
+
+			const SystemId system = Players[client].systemId;
+			if (systemOfClient[client] == system)
+				return;
+
+			Remove(client);
+			if (system)
+			{
+				members[system].emplace_back(client);
+				systemOfClient[client] = system;
+			}
+		}
+
+		void Remove(ClientId client)
+		{
+			if (client < 1 || client > MaxClientId || !systemOfClient[client])
+				return;
+
+			std::erase(members[systemOfClient[client]], client);
+			systemOfClient[client] = 0;
+		}
+
+		//! Files every online client again, for when the plugin is loaded while players are online
+		void Rebuild()
+		{
+			members.clear();
+			systemOfClient.fill(0);
+
+			PlayerData* playerData = nullptr;
+			while ((playerData = Players.traverse_active(playerData)))
+				Update(playerData->iOnlineId);
+		}
+
+		[[nodiscard]] const std::vector<ClientId>& Members(SystemId system) const
+		{
+			static const std::vector<ClientId> none;
+			const auto found = members.find(system);
+			return found != members.end() ? found->second : none;
+		}
+
+	  private:
+		std::unordered_map<SystemId, std::vector<ClientId>> members;
+		std::array<SystemId, MaxClientId + 1> systemOfClient {};
+	};
+
+	//! Sends payloads to groups of clients and counts what that saved
+	class Broadcaster final
+	{
+	  public:
+		SystemMembership systems;
+
+		void ToSystem(SystemId system, const Payload& payload)
+		{
+			if (!Begin(payload))
+				return;
+
+			for (const ClientId client : systems.Members(system))
+			{
+				// The hooks keep the index current, checking the client is still there costs a read and guards against a missed move
+				if (Players[client].systemId == system)
+					Send(client, payload);
+			}
+		}
+
+		void ToAll(const Payload& payload)
+		{
+			if (!Begin(payload))
+				return;
+
+			PlayerData* playerData = nullptr;
+			while ((playerData = Players.traverse_active(playerData)))
+				Send(playerData->iOnlineId, payload);
+		}
+
+		[[nodiscard]] const Counters& GetCounters() const { return counters; }
+
+	  private:
+		bool Begin(const Payload& payload)
+		{
+			if (payload.Empty())
+				return false;
+
+			counters.broadcasts++;
+			counters.bytesRendered += payload.Size();
+			return true;
+		}
+
+		void Send(ClientId client, const Payload& payload)
+		{
+			payload.SendTo(client);
+			counters.recipients++;
+			counters.bytesSent += payload.Size();
+		}
+
+		Counters counters;
+	};
+} // namespace Plugins::Broadcast
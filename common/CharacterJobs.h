@@ -0,0 +1,433 @@
+#pragma once
+#include <FLHook.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Shared by several plugins through a relative include. Runs jobs that rewrite the files of offline characters on a worker thread, so the
+// file I/O of a rename or restart never stalls the game thread.
+namespace Plugins::CharacterJobs
+{
+	//! A character file read into memory. It is decoded once when read, edited in memory and encoded once when written.
+	class CharacterFile final
+	{
+	  public:
+		//! Reads a character file, whether it is encoded or not. Throws if it cannot be read.
+		explicit CharacterFile(const std::string& path)
+		{
+			const std::string work = path + ".job";
+			const bool decoded = FlcDecodeFile(path.c_str(), work.c_str());
+
+			std::ifstream in(decoded ? work : path, std::ios::binary);
+			if (!in)
+				throw std::runtime_error("cannot read " + path);
+
+			std::string line;
+			while (std::getline(in, line))
+			{
+				if (!line.empty() && line.back() == '\r')
+					line.pop_back();
+				lines.emplace_back(std::move(line));
+			}
+			in.close();
+
+			if (decoded)
+				::DeleteFileA(work.c_str());
+		}
+
+		//! The value of the first occurrence of a key in a section
+		[[nodiscard]] std::optional<std::string> Get(const std::string& section, const std::string& key) const
+		{
+			const auto line = FindKey(section, key);
+			if (!line)
+				return std::nullopt;
+
+			const std::string& text = lines[*line];
+			return Trim(text.substr(text.find('=') + 1));
+		}
+
+		//! Replaces the first occurrence of a key in a section, or adds it to the end of the section
+		void Set(const std::string& section, const std::string& key, const std::string& value)
+		{
+			// Keep the space around the equals sign, otherwise Ioncross Server Operator cannot read the file
+			const std::string line = key + " = " + value;
+			if (const auto existing = FindKey(section, key))
+			{
+				lines[*existing] = line;
+				return;
+			}
+
+			const auto header = FindSection(section);
+			if (!header)
+			{
+				lines.emplace_back("[" + section + "]");
+				lines.emplace_back(line);
+				return;
+			}
+
+			size_t end = *header + 1;
+			while (end < lines.size() && !IsSection(lines[end]))
+				end++;
+			lines.insert(lines.begin() + static_cast<std::ptrdiff_t>(end), line);
+		}
+
+		//! Sets a wide string as four hex digits per character, like IniWriteW does
+		void SetW(const std::string& section, const std::string& key, const std::wstring& value)
+		{
+			std::string encoded;
+			char digits[5];
+			for (const wchar_t c : value)
+			{
+				snprintf(digits, sizeof(digits), "%04X", static_cast<uint16_t>(c));
+				encoded += digits;
+			}
+			Set(section, key, encoded);
+		}
+
+		//! Writes the file next to path, encodes it unless character file encryption is disabled and moves it over path
+		void Write(const std::string& path) const
+		{
+			const std::string work = path + ".job";
+			{
+				std::ofstream out(work, std::ios::binary | std::ios::trunc);
+				for (const auto& line : lines)
+					out << line << "\r\n";
+				if (!out.flush())
+					throw std::runtime_error("cannot write " + work);
+			}
+
+			if (!FLHookConfig::i()->general.disableCharfileEncryption)
+				FlcEncodeFile(work.c_str(), work.c_str());
+
+			if (!::MoveFileExA(work.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+				throw std::runtime_error("cannot replace " + path);
+		}
+
+	  private:
+		static std::string Trim(const std::string& text)
+		{
+			const auto first = text.find_first_not_of(" \t");
+			if (first == std::string::npos)
+				return "";
+			return text.substr(first, text.find_last_not_of(" \t") - first + 1);
+		}
+
+		static bool IsSection(const std::string& line)
+		{
+			const std::string trimmed = Trim(line);
+			return !trimmed.empty() && trimmed.front() == '[' && trimmed.back() == ']';
+		}
+
+		[[nodiscard]] std::optional<size_t> FindSection(const std::string& section) const
+		{
+			for (size_t i = 0; i < lines.size(); i++)
+			{
+				if (IsSection(lines[i]) && _stricmp(Trim(lines[i]).c_str(), ("[" + section + "]").c_str()) == 0)
+					return i;
+			}
+			return std::nullopt;
+		}
+
+		[[nodiscard]] std::optional<size_t> FindKey(const std::string& section, const std::string& key) const
+		{
+			const auto header = FindSection(section);
+			if (!header)
+				return std::nullopt;
+
+			for (size_t i = *header + 1; i < lines.size() && !IsSection(lines[i]); i++)
+			{
+				const auto equals = lines[i].find('=');
+				if (equals != std::string::npos && _stricmp(Trim(lines[i].substr(0, equals)).c_str(), key.c_str()) == 0)
+					return i;
+			}
+			return std::nullopt;
+		}
+
+		std::vector<std::string> lines;
+	};
+
+	//! A unit of work on the files of offline characters. The plugin that submits it gives meaning to the kind and the arguments.
+	struct Job final
+	{
+		uint64_t id = 0;
+		std::string kind;
+		std::map<std::string, std::wstring> args;
+
+		//! An argument the job cannot run without. Throws if it is missing.
+		[[nodiscard]] const std::wstring& Arg(const std::string& name) const
+		{
+			const auto arg = args.find(name);
+			if (arg == args.end())
+				throw std::runtime_error("missing argument " + name);
+			return arg->second;
+		}
+	};
+
+	//! Accounts kept locked while a job rewrites the files of their characters, so nobody logs in and loads a file that is being written.
+	//! Only used from the game thread.
+	class AccountLocks final
+	{
+	  public:
+		//! Locks an account, kicking whoever is on it, until the job with this id is released. Logins are handled on the game thread, so
+		//! locking right after submitting the job still comes before anyone could log in again.
+		void Lock(uint64_t jobId, CAccount* account)
+		{
+			Hk::Client::LockAccountAccess(account, true);
+			locked[jobId].emplace_back(account);
+		}
+
+		//! Unlocks the accounts of a job once its completion has run. Jobs recovered from the journal never locked anything.
+		void Release(uint64_t jobId)
+		{
+			const auto accounts = locked.find(jobId);
+			if (accounts == locked.end())
+				return;
+
+			for (CAccount* account : accounts->second)
+				Hk::Client::UnlockAccountAccess(account);
+			locked.erase(accounts);
+		}
+
+	  private:
+		std::map<uint64_t, std::vector<CAccount*>> locked;
+	};
+
+	//! Runs jobs one at a time on a worker thread. A job is written to the journal before it runs and is only closed in the journal once its
+	//! completion has been handled on the game thread, so the jobs a crash interrupts run again on the next start. Jobs must therefore give the
+	//! same result when they run twice.
+	class Queue final
+	{
+	  public:
+		//! Runs a job on the worker thread. Failure is reported by throwing.
+		using Handler = std::function<void(const Job&)>;
+		//! Handles the outcome of a job on the game thread. The error is empty if the job succeeded.
+		using Completion = std::function<void(const Job&, const std::string& error)>;
+
+		//! Opens the journal, queues the jobs it holds that never completed and starts the worker
+		Queue(std::string journalPath, Handler handler, Completion completion)
+		    : journalPath(std::move(journalPath)), handler(std::move(handler)), completion(std::move(completion))
+		{
+			Recover();
+			journal.open(this->journalPath, std::ios::binary | std::ios::app);
+			thread = std::thread(&Queue::Run, this);
+		}
+
+		//! Stop has to be called from the game thread before the queue goes away. The queue is destroyed during DLL unload at the latest, where
+		//! joining the worker would wait on the loader lock the worker needs to exit.
+		~Queue()
+		{
+			if (thread.joinable())
+				thread.detach();
+		}
+
+		Queue(const Queue&) = delete;
+		Queue& operator=(const Queue&) = delete;
+
+		//! Journals a job and hands it to the worker. Returns the id the job was given.
+		uint64_t Submit(Job job)
+		{
+			uint64_t id;
+			{
+				std::scoped_lock lock(mutex);
+				id = job.id = nextId++;
+				journal << FormatJob(job) << '\n';
+				journal.flush();
+				outstanding++;
+				jobs.emplace_back(std::move(job));
+			}
+			wake.notify_one();
+			return id;
+		}
+
+		//! Hands the outcome of every finished job to the completion and closes them in the journal. Call it from a timer on the game thread.
+		void Drain()
+		{
+			std::deque<std::pair<Job, std::string>> done;
+			{
+				std::scoped_lock lock(mutex);
+				done.swap(finished);
+			}
+
+			for (const auto& [job, error] : done)
+				completion(job, error);
+
+			if (done.empty())
+				return;
+
+			std::scoped_lock lock(mutex);
+			for (const auto& [job, error] : done)
+				journal << "done\t" << job.id << '\n';
+			journal.flush();
+
+			// Once nothing is outstanding every line of the journal is settled, so start it over rather than letting it grow
+			outstanding -= done.size();
+			if (!outstanding)
+			{
+				journal.close();
+				journal.open(journalPath, std::ios::binary | std::ios::trunc);
+			}
+		}
+
+		//! Stops the worker once the job it is running has finished. Jobs that did not run stay in the journal for the next start. Call it from
+		//! the game thread, e.g. a shutdown hook.
+		void Stop()
+		{
+			{
+				std::scoped_lock lock(mutex);
+				stopping = true;
+			}
+			wake.notify_one();
+
+			if (thread.joinable())
+				thread.join();
+		}
+
+	  private:
+		static std::string FormatJob(const Job& job)
+		{
+			std::string line = "job\t" + std::to_string(job.id) + '\t' + job.kind;
+			char digits[5];
+			for (const auto& [name, value] : job.args)
+			{
+				line += '\t' + name + '=';
+				for (const wchar_t c : value)
+				{
+					snprintf(digits, sizeof(digits), "%04X", static_cast<uint16_t>(c));
+					line += digits;
+				}
+			}
+			return line;
+		}
+
+		static std::optional<Job> ParseJob(const std::vector<std::string>& fields)
+		{
+			if (fields.size() < 3 || fields[0] != "job")
+				return std::nullopt;
+
+			Job job;
+			job.id = std::strtoull(fields[1].c_str(), nullptr, 10);
+			job.kind = fields[2];
+			for (size_t i = 3; i < fields.size(); i++)
+			{
+				const auto equals = fields[i].find('=');
+				if (equals == std::string::npos || (fields[i].size() - equals - 1) % 4)
+					return std::nullopt;
+
+				std::wstring value;
+				for (size_t c = equals + 1; c < fields[i].size(); c += 4)
+					value += static_cast<wchar_t>(std::strtoul(fields[i].substr(c, 4).c_str(), nullptr, 16));
+				job.args.emplace(fields[i].substr(0, equals), std::move(value));
+			}
+			return job;
+		}
+
+		//! Queues the jobs of a previous run that were journaled but never closed
+		void Recover()
+		{
+			std::ifstream in(journalPath, std::ios::binary);
+			const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+			// Anything after the last line break was cut short by a crash mid-append and is ignored
+			std::map<uint64_t, Job> open;
+			for (size_t start = 0, end; (end = data.find('\n', start)) != std::string::npos; start = end + 1)
+			{
+				std::vector<std::string> fields;
+				for (size_t field = start;;)
+				{
+					const size_t tab = data.find('\t', field);
+					if (tab == std::string::npos || tab > end)
+					{
+						fields.emplace_back(data.substr(field, end - field));
+						break;
+					}
+					fields.emplace_back(data.substr(field, tab - field));
+					field = tab + 1;
+				}
+
+				if (fields.size() == 2 && fields[0] == "done")
+					open.erase(std::strtoull(fields[1].c_str(), nullptr, 10));
+				else if (auto job = ParseJob(fields))
+				{
+					nextId = std::max(nextId, job->id + 1);
+					open[job->id] = std::move(*job);
+				}
+			}
+
+			for (auto& job : open | std::views::values)
+				jobs.emplace_back(std::move(job));
+			outstanding = jobs.size();
+
+			// Cut the torn line off, otherwise the next record would be appended to it and be lost with it
+			if (const size_t complete = data.rfind('\n') + 1; complete != data.size())
+			{
+				in.close();
+				std::error_code ec;
+				std::filesystem::resize_file(journalPath, complete, ec);
+			}
+		}
+
+		void Run()
+		{
+			while (true)
+			{
+				Job job;
+				{
+					std::unique_lock lock(mutex);
+					wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+					if (stopping)
+						return;
+
+					job = std::move(jobs.front());
+					jobs.pop_front();
+				}
+
+				std::string error;
+				try
+				{
+					handler(job);
+				}
+				catch (const std::exception& ex)
+				{
+					error = ex.what();
+				}
+				catch (const char* ex)
+				{
+					error = ex;
+				}
+				catch (...)
+				{
+					error = "unknown error";
+				}
+
+				std::scoped_lock lock(mutex);
+				finished.emplace_back(std::move(job), std::move(error));
+			}
+		}
+
+		std::string journalPath;
+		Handler handler;
+		Completion completion;
+		std::ofstream journal;
+		uint64_t nextId = 1;
+		//! Jobs journaled but not yet closed, queued, running or finished
+		size_t outstanding = 0;
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::deque<Job> jobs;
+		std::deque<std::pair<Job, std::string>> finished;
+		bool stopping = false;
+		std::thread thread;
+	};
+} // namespace Plugins::CharacterJobs
@@ -0,0 +1,330 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <ranges>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Shared by several plugins through a relative include. It only depends on the standard library, so it can be built and exercised outside the server.
+namespace Plugins::CharacterSettings
+{
+	//! Case-insensitive ordering, as keys and sections in ini files are case-insensitive
+	struct CaseInsensitiveLess
+	{
+		bool operator()(const std::string& a, const std::string& b) const
+		{
+			return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), [](unsigned char x, unsigned char y) {
+				return std::tolower(x) < std::tolower(y);
+			});
+		}
+	};
+
+	inline bool EqualsIgnoreCase(const std::string& a, const std::string& b) { return !CaseInsensitiveLess()(a, b) && !CaseInsensitiveLess()(b, a); }
+
+	//! Write-back cache of one ini section per client. The section is read in a single pass when the character is selected, served from memory
+	//! after that, and changed keys are written back in a single rewrite of the file by Flush. Nothing is written on destruction, the owning
+	//! plugin flushes from its timers, ClearClientInfo and shutdown.
+	class Cache final
+	{
+	  public:
+		Cache() = default;
+		Cache(const Cache&) = delete;
+		Cache& operator=(const Cache&) = delete;
+
+		//! Reads the section for a client, replacing anything cached for it before once it has been flushed
+		void Load(uint32_t client, std::filesystem::path file, std::string section)
+		{
+			Retire(client);
+
+			Entry entry;
+			entry.file = std::move(file);
+			entry.section = std::move(section);
+			std::ifstream in(entry.file, std::ios::binary);
+			std::string line;
+			bool inSection = false;
+			while (std::getline(in, line))
+			{
+				Trim(line);
+				if (line.empty() || line[0] == ';')
+					continue;
+
+				if (line.front() == '[' && line.back() == ']')
+				{
+					inSection = EqualsIgnoreCase(line.substr(1, line.size() - 2), entry.section);
+					continue;
+				}
+
+				if (const auto equals = line.find('='); inSection && equals != std::string::npos)
+				{
+					std::string key = line.substr(0, equals);
+					std::string value = line.substr(equals + 1);
+					Trim(key);
+					Trim(value);
+					entry.values.emplace(std::move(key), std::move(value));
+				}
+			}
+
+			entries[client] = std::move(entry);
+		}
+
+		[[nodiscard]] bool IsLoaded(uint32_t client) const { return entries.contains(client); }
+
+		[[nodiscard]] std::optional<std::string> Get(uint32_t client, const std::string& key) const
+		{
+			const auto entry = entries.find(client);
+			if (entry == entries.end())
+				return std::nullopt;
+
+			const auto value = entry->second.values.find(key);
+			if (value == entry->second.values.end())
+				return std::nullopt;
+			return value->second;
+		}
+
+		//! Reads a boolean, accepting the yes/true/1 spellings the plugins have used
+		[[nodiscard]] std::optional<bool> GetBool(uint32_t client, const std::string& key) const
+		{
+			auto value = Get(client, key);
+			if (!value)
+				return std::nullopt;
+
+			std::ranges::transform(*value, value->begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+			return *value == "yes" || *value == "true" || *value == "1";
+		}
+
+		//! Reads a wide string stored as four hex digits per character, as IniWriteW does. A value that is not valid hex is treated as missing.
+		[[nodiscard]] std::optional<std::wstring> GetWString(uint32_t client, const std::string& key) const
+		{
+			const auto value = Get(client, key);
+			if (!value || value->size() % 4)
+				return std::nullopt;
+
+			std::wstring decoded;
+			for (size_t i = 0; i < value->size(); i += 4)
+			{
+				uint32_t unit = 0;
+				for (const char c : std::string_view(*value).substr(i, 4))
+				{
+					unit <<= 4;
+					if (c >= '0' && c <= '9')
+						unit |= c - '0';
+					else if (c >= 'A' && c <= 'F')
+						unit |= c - 'A' + 10;
+					else if (c >= 'a' && c <= 'f')
+						unit |= c - 'a' + 10;
+					else
+						return std::nullopt;
+				}
+				decoded += static_cast<wchar_t>(unit);
+			}
+			return decoded;
+		}
+
+		//! Changes a key in memory. It is written to disk by the next Flush.
+		void Set(uint32_t client, const std::string& key, std::string value)
+		{
+			const auto entry = entries.find(client);
+			if (entry == entries.end())
+				return;
+
+			auto [current, inserted] = entry->second.values.try_emplace(key);
+			if (!inserted && current->second == value)
+				return;
+
+			current->second = std::move(value);
+			entry->second.dirty.insert(key);
+		}
+
+		void SetBool(uint32_t client, const std::string& key, bool value) { Set(client, key, value ? "yes" : "no"); }
+
+		void SetWString(uint32_t client, const std::string& key, const std::wstring& value)
+		{
+			std::string encoded;
+			char digits[5];
+			for (const wchar_t c : value)
+			{
+				snprintf(digits, sizeof(digits), "%04X", static_cast<uint16_t>(c));
+				encoded += digits;
+			}
+			Set(client, key, std::move(encoded));
+		}
+
+		//! Writes the changed keys of a client in one rewrite of their file. Keys other plugins wrote in the meantime are kept, as the file is
+		//! read again right before it is rewritten. Returns false if the file could not be written, in which case the keys stay dirty.
+		bool Flush(uint32_t client)
+		{
+			const auto entry = entries.find(client);
+			return entry == entries.end() || Flush(entry->second);
+		}
+
+		//! Flushes every client, and retries the keys of clients that could not be written when they were unloaded. Returns the files that
+		//! could not be written.
+		std::vector<std::filesystem::path> FlushAll()
+		{
+			std::vector<std::filesystem::path> failed;
+			for (auto& entry : entries | std::views::values)
+			{
+				if (!Flush(entry))
+					failed.emplace_back(entry.file);
+			}
+
+			for (auto entry = unwritten.begin(); entry != unwritten.end();)
+			{
+				if (Flush(*entry))
+					entry = unwritten.erase(entry);
+				else
+					failed.emplace_back((entry++)->file);
+			}
+			return failed;
+		}
+
+		//! Writes the changed keys of a client and forgets them. Returns false if the file could not be written, in which case the keys are
+		//! kept and retried by FlushAll.
+		bool Unload(uint32_t client) { return Retire(client); }
+
+	  private:
+		struct Entry
+		{
+			std::filesystem::path file;
+			std::string section;
+			std::map<std::string, std::string, CaseInsensitiveLess> values;
+			std::set<std::string, CaseInsensitiveLess> dirty;
+		};
+
+		static bool Flush(Entry& entry)
+		{
+			if (entry.dirty.empty())
+				return true;
+
+			if (!Write(entry))
+				return false;
+
+			entry.dirty.clear();
+			return true;
+		}
+
+		//! Flushes a client and drops them from the cache, keeping the entry aside for FlushAll if it could not be written
+		bool Retire(uint32_t client)
+		{
+			const auto entry = entries.find(client);
+			if (entry == entries.end())
+				return true;
+
+			const bool written = Flush(entry->second);
+			if (!written)
+				unwritten.emplace_back(std::move(entry->second));
+
+			entries.erase(entry);
+			return written;
+		}
+
+		static void Trim(std::string& s)
+		{
+			const auto first = s.find_first_not_of(" \t\r\n");
+			if (first == std::string::npos)
+			{
+				s.clear();
+				return;
+			}
+			s = s.substr(first, s.find_last_not_of(" \t\r\n") - first + 1);
+		}
+
+		static bool Write(const Entry& entry)
+		{
+			std::vector<std::string> lines;
+			{
+				std::ifstream in(entry.file, std::ios::binary);
+				std::string line;
+				while (std::getline(in, line))
+				{
+					if (!line.empty() && line.back() == '\r')
+						line.pop_back();
+					lines.emplace_back(std::move(line));
+				}
+			}
+
+			// Replace the dirty keys where they already are in the section, and append the rest at the end of it
+			std::set<std::string, CaseInsensitiveLess> pending = entry.dirty;
+			std::optional<size_t> sectionEnd;
+			bool inSection = false;
+			for (size_t i = 0; i < lines.size(); i++)
+			{
+				std::string trimmed = lines[i];
+				Trim(trimmed);
+				if (!trimmed.empty() && trimmed.front() == '[' && trimmed.back() == ']')
+				{
+					if (inSection)
+						sectionEnd = i;
+					inSection = EqualsIgnoreCase(trimmed.substr(1, trimmed.size() - 2), entry.section);
+					continue;
+				}
+
+				const auto equals = trimmed.find('=');
+				if (!inSection || equals == std::string::npos)
+					continue;
+
+				std::string key = trimmed.substr(0, equals);
+				Trim(key);
+				if (const auto dirtyKey = pending.find(key); dirtyKey != pending.end())
+				{
+					lines[i] = *dirtyKey + "=" + entry.values.at(*dirtyKey);
+					pending.erase(dirtyKey);
+				}
+			}
+
+			std::vector<std::string> added;
+			for (const auto& key : pending)
+				added.emplace_back(key + "=" + entry.values.at(key));
+
+			if (!added.empty())
+			{
+				if (inSection)
+					lines.insert(lines.end(), added.begin(), added.end());
+				else if (sectionEnd)
+					lines.insert(lines.begin() + static_cast<std::ptrdiff_t>(*sectionEnd), added.begin(), added.end());
+				else
+				{
+					lines.emplace_back("[" + entry.section + "]");
+					lines.insert(lines.end(), added.begin(), added.end());
+				}
+			}
+
+			// Write next to the file and swap it in, so a crash never leaves a half written file behind
+			auto temporary = entry.file;
+			temporary += ".tmp";
+			std::error_code ec;
+			{
+				std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+				for (const auto& line : lines)
+					out << line << "\r\n";
+
+				if (!out.flush())
+				{
+					out.close();
+					std::filesystem::remove(temporary, ec);
+					return false;
+				}
+			}
+
+			std::filesystem::rename(temporary, entry.file, ec);
+			if (ec)
+			{
+				std::filesystem::remove(temporary, ec);
+				return false;
+			}
+			return true;
+		}
+
+		std::map<uint32_t, Entry> entries;
+		//! Clients that were unloaded while their file could not be written
+		std::vector<Entry> unwritten;
+	};
+} // namespace Plugins::CharacterSettings
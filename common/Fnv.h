@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Shared by several plugins through a relative include. It only depends on the standard library, so it can be built and exercised outside the server.
+namespace Plugins
+{
+	//! 32-bit FNV-1a hash, used as a checksum by the binary files the plugins write
+	inline uint32_t Fnv1a(const char* data, size_t size)
+	{
+		uint32_t hash = 2166136261u;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= static_cast<uint8_t>(data[i]);
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+} // namespace Plugins
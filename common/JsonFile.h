@@ -0,0 +1,48 @@
+#pragma once
+#include <FLHook.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Shared by several plugins through a relative include.
+namespace Plugins::JsonFile
+{
+	//! Writes a reflectable object to its file through a temporary file that is renamed into place, so a failed or interrupted write never
+	//! replaces the previous file with a torn one. Returns false if the file could not be written.
+	template<typename T>
+	bool Save(T& object)
+	{
+		const std::filesystem::path file = object.File();
+		auto temporary = file;
+		temporary += ".tmp";
+
+		std::error_code ec;
+		std::filesystem::remove(temporary, ec);
+		Serializer::SaveToJson(object, temporary.string());
+
+		// The serializer does not report failures, so make sure a complete document ended up on disk
+		bool complete = false;
+		if (std::ifstream written(temporary, std::ios::binary | std::ios::ate); written)
+		{
+			const auto size = static_cast<std::streamoff>(written.tellg());
+			std::string tail(static_cast<size_t>(std::min<std::streamoff>(size, 64)), '\0');
+			written.seekg(size - static_cast<std::streamoff>(tail.size()));
+			if (written.read(tail.data(), static_cast<std::streamsize>(tail.size())))
+			{
+				const auto last = tail.find_last_not_of(" \t\r\n");
+				complete = last != std::string::npos && tail[last] == '}';
+			}
+		}
+
+		if (!complete)
+		{
+			std::filesystem::remove(temporary, ec);
+			return false;
+		}
+
+		std::filesystem::rename(temporary, file, ec);
+		return !ec;
+	}
+} // namespace Plugins::JsonFile
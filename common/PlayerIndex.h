@@ -0,0 +1,185 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cwctype>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Shared by several plugins through a relative include. It only depends on the standard library, so it can be built and exercised outside the server.
+namespace Plugins::PlayerIndex
+{
+	//! Folds a character for case-insensitive comparison
+	inline wchar_t Fold(wchar_t c)
+	{
+		if (c >= L'A' && c <= L'Z')
+			return static_cast<wchar_t>(c + (L'a' - L'A'));
+		if (c < 0x80)
+			return c;
+		return static_cast<wchar_t>(std::towlower(static_cast<wint_t>(c)));
+	}
+
+	//! Compares the first characters of text with pattern, case-insensitively. Returns <0, 0 or >0 like wcsncmp, where 0 means text starts
+	//! with pattern.
+	inline int ComparePrefix(std::wstring_view text, std::wstring_view pattern)
+	{
+		const size_t length = std::min(text.size(), pattern.size());
+		for (size_t i = 0; i < length; i++)
+		{
+			const wchar_t a = Fold(text[i]);
+			const wchar_t b = Fold(pattern[i]);
+			if (a != b)
+				return a < b ? -1 : 1;
+		}
+		return text.size() < pattern.size() ? -1 : 0;
+	}
+
+	//! Index of the characters that are online, by name. Exact, prefix and tag (substring) lookups are case-insensitive and do not allocate.
+	class Index final
+	{
+	  public:
+		//! Adds a client under its character name, replacing the name it had before
+		void Add(uint32_t client, std::wstring_view name)
+		{
+			Remove(client);
+			if (name.empty())
+				return;
+
+			if (client >= names.size())
+				names.resize(client + 1);
+
+			std::wstring& folded = names[client];
+			folded.resize(name.size());
+			std::ranges::transform(name, folded.begin(), Fold);
+			byName.emplace(folded, client);
+
+			const Entry entry {client, 0};
+			sortedNames.insert(std::ranges::upper_bound(sortedNames, entry, Less {this}), entry);
+			for (uint16_t offset = 0; offset < folded.size(); offset++)
+			{
+				const Entry suffix {client, offset};
+				suffixes.insert(std::ranges::upper_bound(suffixes, suffix, Less {this}), suffix);
+			}
+		}
+
+		//! Removes a client, if it is in the index
+		void Remove(uint32_t client)
+		{
+			if (client >= names.size() || names[client].empty())
+				return;
+
+			byName.erase(names[client]);
+			std::erase_if(sortedNames, [client](const Entry& entry) { return entry.client == client; });
+			std::erase_if(suffixes, [client](const Entry& entry) { return entry.client == client; });
+			names[client].clear();
+		}
+
+		void Clear()
+		{
+			names.clear();
+			byName.clear();
+			sortedNames.clear();
+			suffixes.clear();
+		}
+
+		[[nodiscard]] size_t Size() const { return byName.size(); }
+
+		//! The client a character is online on
+		[[nodiscard]] std::optional<uint32_t> Find(std::wstring_view name) const
+		{
+			const auto entry = byName.find(name);
+			if (entry == byName.end())
+				return std::nullopt;
+			return entry->second;
+		}
+
+		//! Calls visitor with every client whose character name starts with prefix, in name order
+		template<typename Visitor>
+		void ForEachWithPrefix(std::wstring_view prefix, Visitor&& visitor) const
+		{
+			for (const auto& entry : EqualRange(sortedNames, prefix))
+				visitor(entry.client);
+		}
+
+		//! Calls visitor once with every client whose character name contains tag anywhere
+		template<typename Visitor>
+		void ForEachContaining(std::wstring_view tag, Visitor&& visitor) const
+		{
+			if (tag.empty())
+				return;
+
+			for (const auto& entry : EqualRange(suffixes, tag))
+			{
+				// A name that contains the tag more than once has a suffix for every occurrence, only report the first of them
+				if (FirstOccurrence(names[entry.client], tag) == entry.offset)
+					visitor(entry.client);
+			}
+		}
+
+	  private:
+		//! A client together with the offset into its folded name that an entry is sorted by
+		struct Entry
+		{
+			uint32_t client;
+			uint16_t offset;
+		};
+
+		struct Less
+		{
+			const Index* index;
+			bool operator()(const Entry& a, const Entry& b) const { return index->Text(a) < index->Text(b); }
+		};
+
+		struct FoldedHash
+		{
+			using is_transparent = void;
+			size_t operator()(std::wstring_view name) const
+			{
+				// FNV-1a over the folded characters, so the lookup key never has to be folded into a copy first
+				uint64_t hash = 14695981039346656037ull;
+				for (const wchar_t c : name)
+				{
+					hash ^= static_cast<uint64_t>(Fold(c));
+					hash *= 1099511628211ull;
+				}
+				return static_cast<size_t>(hash);
+			}
+		};
+
+		struct FoldedEqual
+		{
+			using is_transparent = void;
+			bool operator()(std::wstring_view a, std::wstring_view b) const { return a.size() == b.size() && ComparePrefix(a, b) == 0; }
+		};
+
+		[[nodiscard]] std::wstring_view Text(const Entry& entry) const { return std::wstring_view(names[entry.client]).substr(entry.offset); }
+
+		[[nodiscard]] std::ranges::subrange<std::vector<Entry>::const_iterator> EqualRange(const std::vector<Entry>& entries, std::wstring_view pattern) const
+		{
+			const auto first =
+			    std::ranges::partition_point(entries, [this, pattern](const Entry& entry) { return ComparePrefix(Text(entry), pattern) < 0; });
+			const auto last = std::partition_point(first, entries.end(), [this, pattern](const Entry& entry) { return ComparePrefix(Text(entry), pattern) == 0; });
+			return {first, last};
+		}
+
+		static size_t FirstOccurrence(std::wstring_view name, std::wstring_view tag)
+		{
+			for (size_t offset = 0; offset + tag.size() <= name.size(); offset++)
+			{
+				if (ComparePrefix(name.substr(offset), tag) == 0)
+					return offset;
+			}
+			return std::wstring_view::npos;
+		}
+
+		//! Folded character name by client, empty for clients that are not in the index
+		std::vector<std::wstring> names;
+		std::unordered_map<std::wstring, uint32_t, FoldedHash, FoldedEqual> byName;
+		//! Every client sorted by folded name, for prefix lookups
+		std::vector<Entry> sortedNames;
+		//! Every suffix of every folded name in sorted order, so the names containing a tag form one contiguous range
+		std::vector<Entry> suffixes;
+	};
+} // namespace Plugins::PlayerIndex
@@ -0,0 +1,105 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string_view>
+
+// Shared by several plugins through a relative include. It only depends on the standard library, so it can be built and exercised outside the server.
+namespace Plugins::Random
+{
+	//! xoshiro256** generator. Each plugin owns its own stream, so one plugin drawing numbers never shifts the sequence another one sees.
+	class Stream final
+	{
+	  public:
+		using result_type = uint64_t;
+
+		//! Seeds the stream from the given seed and stream name. A seed of 0 draws a fresh seed from std::random_device.
+		Stream(std::string_view name, uint64_t seed = 0) { Reseed(name, seed); }
+
+		void Reseed(std::string_view name, uint64_t seed)
+		{
+			if (!seed)
+			{
+				std::random_device device;
+				seed = (static_cast<uint64_t>(device()) << 32) | device();
+			}
+
+			// Mixing the name in gives each subsystem an independent sequence for the same configured seed
+			uint64_t mix = seed ^ HashName(name);
+			for (auto& word : state)
+				word = SplitMix64(mix);
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return UINT64_MAX; }
+
+		result_type operator()()
+		{
+			const uint64_t result = std::rotl(state[1] * 5, 7) * 9;
+			const uint64_t t = state[1] << 17;
+			state[2] ^= state[0];
+			state[3] ^= state[1];
+			state[1] ^= state[2];
+			state[0] ^= state[3];
+			state[2] ^= t;
+			state[3] = std::rotl(state[3], 45);
+			return result;
+		}
+
+		//! Uniform float in [0, 1)
+		float Float() { return static_cast<float>((*this)() >> 40) * 0x1.0p-24f; }
+
+		//! Uniform float in [a, b)
+		float FloatRange(float a, float b) { return a + (b - a) * Float(); }
+
+		//! Uniform integer in [0, bound), bound must be above 0
+		uint32_t Below(uint32_t bound)
+		{
+			// Lemire's multiply-shift with rejection of the biased low range
+			uint64_t product = ((*this)() >> 32) * bound;
+			if (static_cast<uint32_t>(product) < bound)
+			{
+				const uint32_t threshold = (0u - bound) % bound;
+				while (static_cast<uint32_t>(product) < threshold)
+					product = ((*this)() >> 32) * bound;
+			}
+			return static_cast<uint32_t>(product >> 32);
+		}
+
+		//! Fills the span with uniform floats in [a, b), two per generator step
+		void Fill(std::span<float> values, float a = 0.0f, float b = 1.0f)
+		{
+			const float scale = (b - a) * 0x1.0p-24f;
+			size_t i = 0;
+			for (; i + 1 < values.size(); i += 2)
+			{
+				const uint64_t bits = (*this)();
+				values[i] = a + static_cast<float>(bits >> 40) * scale;
+				values[i + 1] = a + static_cast<float>((bits >> 8) & 0xFFFFFF) * scale;
+			}
+			if (i < values.size())
+				values[i] = a + static_cast<float>((*this)() >> 40) * scale;
+		}
+
+	  private:
+		static uint64_t SplitMix64(uint64_t& x)
+		{
+			uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+			return z ^ (z >> 31);
+		}
+
+		static constexpr uint64_t HashName(std::string_view name)
+		{
+			uint64_t hash = 0xCBF29CE484222325ull;
+			for (const char c : name)
+				hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3ull;
+			return hash;
+		}
+
+		std::array<uint64_t, 4> state {};
+	};
+} // namespace Plugins::Random
@@ -0,0 +1,78 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// Shared by several plugins through a relative include. It only depends on the standard library, so it can be built and exercised outside the server.
+namespace Plugins
+{
+	//! Runs queued tasks one after another on a thread of its own, for file writes that must not stall the game thread. The owner calls Stop
+	//! from the game thread, usually a shutdown hook, as the destructor only detaches a thread that is still running: it may run inside
+	//! DllMain, where joining deadlocks on the loader lock.
+	class WorkerThread final
+	{
+	  public:
+		WorkerThread() : thread(&WorkerThread::Run, this) {}
+
+		~WorkerThread()
+		{
+			if (thread.joinable())
+				thread.detach();
+		}
+
+		WorkerThread(const WorkerThread&) = delete;
+		WorkerThread& operator=(const WorkerThread&) = delete;
+
+		//! Queues a task. Tasks run in the order they were posted.
+		void Post(std::function<void()> task)
+		{
+			{
+				std::scoped_lock lock(mutex);
+				tasks.emplace_back(std::move(task));
+			}
+			wake.notify_one();
+		}
+
+		//! Runs everything still queued and stops the thread
+		void Stop()
+		{
+			{
+				std::scoped_lock lock(mutex);
+				stopping = true;
+			}
+			wake.notify_one();
+
+			if (thread.joinable())
+				thread.join();
+		}
+
+	  private:
+		void Run()
+		{
+			while (true)
+			{
+				std::function<void()> task;
+				{
+					std::unique_lock lock(mutex);
+					wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+					if (tasks.empty())
+						return;
+
+					task = std::move(tasks.front());
+					tasks.pop_front();
+				}
+
+				task();
+			}
+		}
+
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::deque<std::function<void()>> tasks;
+		bool stopping = false;
+		//! Declared last so everything the thread uses exists before it starts
+		std::thread thread;
+	};
+} // namespace Plugins
@@ -0,0 +1,47 @@
+// Benchmark of drawing loot counts from a Random::Stream against the std::mt19937 and uniform_real_distribution the plugins used before:
+//   g++ -std=c++20 -O2 -o random_benchmark RandomBenchmark.cpp
+//   ./random_benchmark
+
+#include "../Random.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	constexpr size_t Draws = 10'000'000;
+
+	template<typename Draw>
+	void Run(const char* name, Draw draw)
+	{
+		int64_t total = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < Draws; i++)
+			total += static_cast<int>(draw() * 0.375f * 32.0f);
+		const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		std::printf("%-28s %6.2f ns/draw (checksum %lld)\n", name, elapsed / Draws, static_cast<long long>(total));
+	}
+} // namespace
+
+int main()
+{
+	std::mt19937 mt {12345};
+	std::uniform_real_distribution<float> distribution {0.0f, 1.0f};
+	Run("mt19937 + distribution", [&] { return distribution(mt); });
+
+	Plugins::Random::Stream stream {"MiningControl", 12345};
+	Run("Random::Stream::Float", [&] { return stream.Float(); });
+
+	std::vector<float> batch(1024);
+	size_t next = batch.size();
+	Run("Random::Stream::Fill", [&] {
+		if (next == batch.size())
+		{
+			stream.Fill(batch);
+			next = 0;
+		}
+		return batch[next++];
+	});
+	return 0;
+}
@@ -0,0 +1,122 @@
+// Determinism tests for the per-plugin random streams:
+//   g++ -std=c++20 -O2 -o random_test RandomTest.cpp
+//   ./random_test
+// Exits with the number of failed checks.
+
+#include "../Random.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace Plugins::Random;
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			failures++;
+		}
+	}
+
+	//! Loot counts as MiningControl's SPMunitionCollision draws them, one Float per hit on a lootable zone
+	std::vector<int> LootSequence(Stream& stream, size_t hits)
+	{
+		constexpr float genericFactor = 1.0f;
+		constexpr float zoneBonus = 0.25f;
+		constexpr float playerBonus = 1.5f;
+		constexpr float dynamicLootCount = 32.0f;
+
+		std::vector<int> counts;
+		counts.reserve(hits);
+		for (size_t i = 0; i < hits; i++)
+			counts.push_back(static_cast<int>(stream.Float() * genericFactor * zoneBonus * playerBonus * dynamicLootCount));
+		return counts;
+	}
+
+	void TestSameSeedSameLoot()
+	{
+		Stream first {"MiningControl", 12345};
+		Stream second {"MiningControl", 12345};
+		Check(LootSequence(first, 10000) == LootSequence(second, 10000), "the same seed gives the same loot sequence");
+
+		Stream reseeded {"MiningControl", 999};
+		reseeded.Float();
+		reseeded.Reseed("MiningControl", 12345);
+		Stream fresh {"MiningControl", 12345};
+		Check(LootSequence(reseeded, 1000) == LootSequence(fresh, 1000), "reseeding restarts the sequence");
+	}
+
+	void TestStreamsAreIndependent()
+	{
+		Stream mining {"MiningControl", 12345};
+		Stream solar {"SolarControl", 12345};
+		Check(LootSequence(mining, 1000) != LootSequence(solar, 1000), "streams with the same seed but different names differ");
+
+		Stream otherSeed {"MiningControl", 12346};
+		Stream seed {"MiningControl", 12345};
+		Check(LootSequence(seed, 1000) != LootSequence(otherSeed, 1000), "different seeds give different sequences");
+
+		// Drawing from one plugin's stream must not shift another's
+		Stream a {"MiningControl", 7};
+		Stream b {"MiningControl", 7};
+		Stream other {"SoundManager", 7};
+		std::vector<int> interleaved;
+		for (int i = 0; i < 1000; i++)
+		{
+			other.Below(100);
+			interleaved.push_back(LootSequence(a, 1)[0]);
+		}
+		Check(interleaved == LootSequence(b, 1000), "drawing from another stream leaves the sequence alone");
+	}
+
+	void TestRandomSeed()
+	{
+		Stream first {"CashManager"};
+		Stream second {"CashManager"};
+		Check(first() != second() || first() != second(), "a seed of 0 draws a fresh seed every time");
+	}
+
+	void TestRanges()
+	{
+		Stream stream {"Ranges", 42};
+		bool inRange = true;
+		for (int i = 0; i < 100000; i++)
+		{
+			const float f = stream.Float();
+			const float ranged = stream.FloatRange(-5.0f, 5.0f);
+			const uint32_t below = stream.Below(7);
+			inRange &= f >= 0.0f && f < 1.0f && ranged >= -5.0f && ranged < 5.0f && below < 7;
+		}
+		Check(inRange, "Float, FloatRange and Below stay in range");
+
+		Stream filled {"Ranges", 42};
+		std::vector<float> values(1001);
+		filled.Fill(values, 10.0f, 20.0f);
+		bool filledInRange = true;
+		for (const float value : values)
+			filledInRange &= value >= 10.0f && value < 20.0f;
+		Check(filledInRange, "Fill stays in range, including an odd count");
+
+		Stream again {"Ranges", 42};
+		std::vector<float> repeated(1001);
+		again.Fill(repeated, 10.0f, 20.0f);
+		Check(values == repeated, "Fill is reproducible from the seed");
+	}
+} // namespace
+
+int main()
+{
+	TestSameSeedSameLoot();
+	TestStreamsAreIndependent();
+	TestRandomSeed();
+	TestRanges();
+
+	if (!failures)
+		std::printf("All random stream tests passed.\n");
+	return failures;
+}
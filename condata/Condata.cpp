@@ -7,11 +7,11 @@
  *
  * @paragraph cmds Player Commands
  * All commands are prefixed with '/' unless explicitly specified.
- * - ping - This shows connection data to the player.
+ * - ping [detail] - This shows connection data to the player. With detail it also shows the 50th, 95th and 99th percentile and highest ping.
  *
  * @paragraph adminCmds Admin Commands
  * All commands are prefixed with '.' unless explicitly specified.
- * - getstats - Gets connection stats on all connected clients.
+ * - getstats - Gets connection stats on all connected clients, followed by ping percentiles across all of them.
  * - kick <character> - Kicks the specified character.
  *
  * @paragraph configuration Configuration
@@ -21,6 +21,10 @@
  * - ReceiveData - See function documentation below
  * - ReceiveException - See function documentation below
  *
+ * @paragraph analyzer Connection Log
+ * With recordConnections enabled the ping, loss and lag of every client is appended to ConnectionLog.bin in the user data folder each second.
+ * analyzer/ConDataAnalyzer.cpp reads these logs and prints per session percentiles and how they correlate with the server load.
+ *
  * @paragraph optional Optional Plugin Dependencies
  * This plugin uses the "Tempban" plugin.
  */
@@ -47,31 +51,33 @@ namespace Plugins::ConData
 	 */
 	void ClearConData(ClientId client)
 	{
-		auto con = global->connections[client];
-		con.averageLoss = 0;
-		con.averagePing = 0;
-		con.lastLoss = 0;
-		con.lastPacketsDropped = 0;
-		con.lastPacketsReceived = 0;
-		con.lastPacketsSent = 0;
-		con.pingFluctuation = 0;
-		con.lossList.clear();
-		con.pingList.clear();
-		con.objUpdateIntervalsList.clear();
-		con.lags = 0;
-		con.lastObjUpdate = 0;
-		con.lastObjTimestamp = 0;
-
-		con.exception = false;
-		con.exceptionReason = "";
+		auto& con = global->connections;
+		con.lastPing[client] = 0;
+		con.averageLoss[client] = 0;
+		con.averagePing[client] = 0;
+		con.lastLoss[client] = 0;
+		con.lastPacketsDropped[client] = 0;
+		con.lastPacketsReceived[client] = 0;
+		con.lastPacketsSent[client] = 0;
+		con.pingFluctuation[client] = 0;
+		con.lossWindow[client].Clear();
+		con.pingWindow[client].Clear();
+		con.lagEstimator[client].Reset();
+		con.pingHistogram[client].Clear();
+		con.lags[client] = 0;
+		con.kickReasons[client] = 0;
+
+		con.exception[client] = false;
+		con.exceptionReason[client] = "";
 	}
 
 	/** @ingroup Condata
-	 * @brief ClearClientInfo hook. Calls ClearConData().
+	 * @brief ClearClientInfo hook. Calls ClearConData() and ends the client's session in the connection log.
 	 */
 	void ClearClientInfo(ClientId& client)
 	{
 		ClearConData(client);
+		global->connections.sessionStartInMs[client] = 0;
 	}
 
 	/** @ingroup Condata
@@ -81,40 +87,52 @@ namespace Plugins::ConData
 	{
 		if (CoreGlobals::c()->serverLoadInMs > global->config->kickThreshold)
 		{
+			auto& con = global->connections;
+
+			// A disabled check gets a threshold nothing can exceed, so the loop below has no branches and can be vectorised
+			const uint lossKick = global->config->lossKick ? global->config->lossKick : UINT_MAX;
+			const uint pingKick = global->config->pingKick ? global->config->pingKick : UINT_MAX;
+			const uint fluctKick = global->config->fluctKick ? global->config->fluctKick : UINT_MAX;
+			const uint lagKick = global->config->lagKick ? global->config->lagKick : UINT_MAX;
+			for (size_t i = 0; i < con.kickReasons.size(); i++)
+			{
+				con.kickReasons[i] = static_cast<uint8_t>((con.averageLoss[i] > lossKick) * KickForLoss | (con.averagePing[i] > pingKick) * KickForPing |
+				    (con.pingFluctuation[i] > fluctKick) * KickForFluctuation | (con.lags[i] > lagKick) * KickForLag);
+			}
+
 			// for all players
 			struct PlayerData* playerData = nullptr;
 			while ((playerData = Players.traverse_active(playerData)))
 			{
 				ClientId client = playerData->iOnlineId;
-				if (client < 1 || client > MaxClientId)
+				if (client < 1 || client > MaxClientId || !con.kickReasons[client])
 					continue;
 
-				auto& con = global->connections[client];
-
-				if (global->config->lossKick && con.averageLoss > global->config->lossKick)
+				const uint8_t reasons = con.kickReasons[client];
+				if (reasons & KickForLoss)
 				{
-					con.lossList.clear();
+					con.lossWindow[client].Clear();
 					AddKickLog(client, "High loss");
 					TempBanManager::i()->AddTempBan(client, 60, L"High loss");
 				}
 
-				if (global->config->pingKick && con.averagePing > (global->config->pingKick))
+				if (reasons & KickForPing)
 				{
-					con.pingList.clear();
+					con.pingWindow[client].Clear();
 					AddKickLog(client, "High ping");
 					TempBanManager::i()->AddTempBan(client, 60, L"High ping");
 				}
 
-				if (global->config->fluctKick && con.pingFluctuation > (global->config->fluctKick))
+				if (reasons & KickForFluctuation)
 				{
-					con.pingList.clear();
+					con.pingWindow[client].Clear();
 					AddKickLog(client, "High fluct");
 					TempBanManager::i()->AddTempBan(client, 60, L"High ping fluctuation");
 				}
 
-				if (global->config->lagKick && con.lags > (global->config->lagKick))
+				if (reasons & KickForLag)
 				{
-					con.objUpdateIntervalsList.clear();
+					con.lagEstimator[client].Reset();
 
 					AddKickLog(client, "High Lag");
 					TempBanManager::i()->AddTempBan(client, 60, L"High lag");
@@ -143,6 +161,10 @@ namespace Plugins::ConData
 	 */
 	void TimerUpdatePingData()
 	{
+		std::vector<ConnectionLog::Record> records;
+		const int64_t now = global->connectionLog ? Hk::Time::GetUnixMiliseconds() : 0;
+		const auto serverLoad = static_cast<uint16_t>(std::min<uint64_t>(CoreGlobals::c()->serverLoadInMs, UINT16_MAX));
+
 		// for all players
 		struct PlayerData* playerData = nullptr;
 		while ((playerData = Players.traverse_active(playerData)))
@@ -152,36 +174,43 @@ namespace Plugins::ConData
 			if (client < 1 || client > MaxClientId || ClientInfo[client].tmF1TimeDisconnect || connectionInfo.has_error())
 				continue;
 
-			auto& con = global->connections[client];
+			auto& con = global->connections;
 
 			///////////////////////////////////////////////////////////////
 			// update ping data
-			if (con.pingList.size() >= global->config->pingKickFrame)
+			if (con.pingWindow[client].Size() >= global->config->pingKickFrame)
 			{
-				// calculate average ping and ping fluctuation
-				unsigned int lastPing = 0;
-				con.averagePing = 0;
-				con.pingFluctuation = 0;
-				for (const auto& ping : con.pingList)
-				{
-					con.averagePing += ping;
-					if (lastPing != 0)
-					{
-						con.pingFluctuation += static_cast<uint>(sqrt(pow(static_cast<float>(ping) - static_cast<float>(lastPing), 2)));
-					}
-					lastPing = ping;
-				}
-
-				con.pingFluctuation /= con.pingList.size();
-				con.averagePing /= con.pingList.size();
+				// average ping and ping fluctuation, kept up to date by the window as samples come and go
+				con.pingFluctuation[client] = con.pingWindow[client].Fluctuation() / con.pingWindow[client].Size();
+				con.averagePing[client] = con.pingWindow[client].Sum() / con.pingWindow[client].Size();
 			}
 
-			// remove old pingdata
-			while (con.pingList.size() >= global->config->pingKickFrame)
-				con.pingList.pop_back();
+			// the oldest sample is evicted once the window is full
+			con.lastPing[client] = connectionInfo->dwRoundTripLatencyMS;
+			con.pingWindow[client].Push(con.lastPing[client]);
 
-			con.pingList.push_front(connectionInfo->dwRoundTripLatencyMS);
+			con.pingHistogram[client].Record(con.lastPing[client]);
+			if (con.pingHistogram[client].Total() >= global->config->pingHistogramDecaySamples)
+				con.pingHistogram[client].Decay();
+
+			if (global->connectionLog)
+			{
+				if (!con.sessionStartInMs[client])
+					con.sessionStartInMs[client] = now;
+
+				records.push_back({now,
+				    con.sessionStartInMs[client],
+				    static_cast<uint16_t>(client),
+				    con.lastPing[client],
+				    static_cast<uint16_t>(con.lastLoss[client]),
+				    static_cast<uint16_t>(con.lags[client]),
+				    serverLoad});
+			}
 		}
+
+		// The records are encoded and written on the log's own thread
+		if (global->connectionLog)
+			global->connectionLog->Append(std::move(records));
 	}
 
 	/** @ingroup Condata
@@ -206,29 +235,21 @@ namespace Plugins::ConData
 				continue;
 			const auto& connInfo = connectionInfo.value();
 
-			auto& con = global->connections[client];
+			auto& con = global->connections;
 
 			///////////////////////////////////////////////////////////////
 			// update loss data
-			if (con.lossList.size() >= (global->config->lossKickFrame / LossInterval))
+			if (con.lossWindow[client].Size() >= (global->config->lossKickFrame / LossInterval))
 			{
 				// calculate average loss
-				con.averageLoss = 0;
-				for (const auto& loss : con.lossList)
-					con.averageLoss += loss;
-
-				con.averageLoss /= con.lossList.size();
+				con.averageLoss[client] = con.lossWindow[client].Sum() / con.lossWindow[client].Size();
 			}
 
-			// remove old lossdata
-			while (con.lossList.size() >= (global->config->lossKickFrame / LossInterval))
-				con.lossList.pop_back();
-
 			// sum of Drops = Drops guaranteed + drops non-guaranteed
-			const uint newDrops = (connInfo.dwPacketsRetried + connInfo.dwPacketsDropped) - con.lastPacketsDropped;
+			const uint newDrops = (connInfo.dwPacketsRetried + connInfo.dwPacketsDropped) - con.lastPacketsDropped[client];
 
 			// % of Packets Lost = Drops / (sent+received) * 100
-			if (const uint newSent = (connInfo.dwPacketsSentGuaranteed + connInfo.dwPacketsSentNonGuaranteed) - con.lastPacketsSent;
+			if (const uint newSent = (connInfo.dwPacketsSentGuaranteed + connInfo.dwPacketsSentNonGuaranteed) - con.lastPacketsSent[client];
 			    newSent > 0) // division by zero check
 				lossPercentage = static_cast<float>(newDrops) / static_cast<float>(newSent) * 100.0f;
 			else
@@ -238,77 +259,60 @@ namespace Plugins::ConData
 				lossPercentage = 100;
 
 			// add last loss to List lossList and put current value into lastLoss
-			con.lossList.push_front(con.lastLoss);
-			con.lastLoss = static_cast<uint>(lossPercentage);
+			con.lossWindow[client].Push(con.lastLoss[client]);
+			con.lastLoss[client] = static_cast<uint>(lossPercentage);
 
 			// Fill new ClientInfo-variables with current values
-			con.lastPacketsSent = connInfo.dwPacketsSentGuaranteed + connInfo.dwPacketsSentNonGuaranteed;
-			con.lastPacketsDropped = connInfo.dwPacketsRetried + connInfo.dwPacketsDropped;
+			con.lastPacketsSent[client] = connInfo.dwPacketsSentGuaranteed + connInfo.dwPacketsSentNonGuaranteed;
+			con.lastPacketsDropped[client] = connInfo.dwPacketsRetried + connInfo.dwPacketsDropped;
 		}
 	}
 
 	/** @ingroup Condata
-	 * @brief Hook on PlayerLaunch. Sets lastObjUpdate to 0.
+	 * @brief Hook on PlayerLaunch. Starts lag detection over, since the time spent docked is not lag.
 	 */
 	void PlayerLaunch([[maybe_unused]] ShipId& ship, ClientId& client)
 	{
-		global->connections[client].lastObjUpdate = 0;
+		global->connections.lagEstimator[client].Restart();
 	}
 
 	/** @ingroup Condata
-	 * @brief Hook on SPObjUpdate. Updates timestamps for lag detection.
+	 * @brief Milliseconds on the steady clock, which object updates are timed against
+	 */
+	int64_t GetMonotonicTimeInMs()
+	{
+		return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/** @ingroup Condata
+	 * @brief Hook on SPObjUpdate. Feeds the update into the client's lag estimator. This runs for every position update, so it does not allocate.
 	 */
 	void SPObjUpdate(struct SSPObjUpdateInfo const& ui, ClientId& client)
 	{
-		// lag detection
-		if (const auto ins = Hk::Client::GetInspect(client); ins.has_error())
-			return; // ??? 8[
+		if (client < 1 || client > MaxClientId)
+			return;
 
-		const mstime timeNow = Hk::Time::GetUnixMiliseconds();
-		const auto timestamp = static_cast<mstime>(ui.fTimestamp * 1000);
+		const int64_t timeNow = GetMonotonicTimeInMs();
+		const auto timestamp = static_cast<int64_t>(ui.fTimestamp * 1000);
 
-		auto& con = global->connections[client];
+		auto& estimator = global->connections.lagEstimator[client];
 
-		if (global->config->lagDetectionFrame && con.lastObjUpdate && (Hk::Client::GetEngineState(client) != ES_TRADELANE) && (ui.cState != 7))
+		// Updates in trade lanes or while in state 7 are not representative, only their times are kept
+		if (!global->config->lagDetectionFrame || ui.cState == 7 || Hk::Client::GetEngineState(client) == ES_TRADELANE)
 		{
-			const auto timeDiff = static_cast<uint>(timeNow - con.lastObjUpdate);
-			const auto timestampDiff = static_cast<uint>(timestamp - con.lastObjTimestamp);
-			auto diff = static_cast<int>(sqrt(pow(static_cast<long double>(static_cast<int>(timeDiff) - static_cast<int>(timestampDiff)), 2)));
-			diff -= CoreGlobals::c()->serverLoadInMs;
-			if (diff < 0)
-				diff = 0;
-
-			uint perc;
-			if (timestampDiff != 0)
-				perc = static_cast<uint>(static_cast<float>(diff) / static_cast<float>(timestampDiff) * 100.0f);
-			else
-				perc = 0;
-
-			if (con.objUpdateIntervalsList.size() >= global->config->lagDetectionFrame)
-			{
-				uint lags = 0;
-				for (const auto& iv : con.objUpdateIntervalsList)
-				{
-					if (iv > global->config->lagDetectionMin)
-						lags++;
-				}
-
-				con.lags = (lags * 100) / global->config->lagDetectionFrame;
-				while (con.objUpdateIntervalsList.size() >= global->config->lagDetectionFrame)
-					con.objUpdateIntervalsList.pop_front();
-			}
-
-			con.objUpdateIntervalsList.push_back(perc);
+			estimator.Skip(timeNow, timestamp);
+			return;
 		}
 
-		con.lastObjUpdate = timeNow;
-		con.lastObjTimestamp = timestamp;
+		estimator.Update(timeNow, timestamp, CoreGlobals::c()->serverLoadInMs, global->config->lagDetectionMin, global->config->lagDetectionFrame);
+		if (estimator.Ready(global->config->lagDetectionFrame))
+			global->connections.lags[client] = estimator.LagPercent();
 	}
 
 	/** @ingroup Condata
 	 * @brief Gets called when the player types /ping
 	 */
-	void UserCmdPing(ClientId& client, [[maybe_unused]] const std::wstring& param)
+	void UserCmdPing(ClientId& client, const std::wstring& param)
 	{
 		if (!global->config->allowPing)
 		{
@@ -331,14 +335,14 @@ namespace Plugins::ConData
 			}
 		}
 
-		const auto& con = global->connections[clientTarget];
+		const auto& con = global->connections;
 
 		response += L": ";
-		if (con.pingList.size() < global->config->pingKickFrame)
+		if (con.pingWindow[clientTarget].Size() < global->config->pingKickFrame)
 			response += L"n/a Fluct: n/a ";
 		else
 		{
-			response += std::to_wstring(con.averagePing);
+			response += std::to_wstring(con.averagePing[clientTarget]);
 			response += L"ms ";
 			if (global->config->pingKick > 0)
 			{
@@ -347,7 +351,7 @@ namespace Plugins::ConData
 				response += L"ms) ";
 			}
 			response += L"Fluct: ";
-			response += std::to_wstring(con.pingFluctuation);
+			response += std::to_wstring(con.pingFluctuation[clientTarget]);
 			response += L"ms ";
 			if (global->config->fluctKick > 0)
 			{
@@ -358,11 +362,11 @@ namespace Plugins::ConData
 		}
 
 		response += L"Loss: ";
-		if (con.lossList.size() < (global->config->lossKickFrame / LossInterval))
+		if (con.lossWindow[clientTarget].Size() < (global->config->lossKickFrame / LossInterval))
 			response += L"n/a ";
 		else
 		{
-			response += std::to_wstring(con.averageLoss);
+			response += std::to_wstring(con.averageLoss[clientTarget]);
 			response += L"% ";
 			if (global->config->lossKick > 0)
 			{
@@ -373,11 +377,11 @@ namespace Plugins::ConData
 		}
 
 		response += L"Lag: ";
-		if (con.objUpdateIntervalsList.size() < global->config->lagDetectionFrame)
+		if (!con.lagEstimator[clientTarget].Ready(global->config->lagDetectionFrame))
 			response += L"n/a";
 		else
 		{
-			response += std::to_wstring(con.lags).c_str();
+			response += std::to_wstring(con.lags[clientTarget]).c_str();
 			response += L"% ";
 			if (global->config->lagKick > 0)
 			{
@@ -389,10 +393,28 @@ namespace Plugins::ConData
 
 		// Send the message to the user
 		PrintUserCmdText(client, response);
+
+		if (GetParam(param, ' ', 0) == L"detail")
+		{
+			const auto& histogram = con.pingHistogram[clientTarget];
+			if (!histogram.Total())
+				PrintUserCmdText(client, L"Ping percentiles: n/a");
+			else
+				PrintUserCmdText(client,
+				    std::format(L"Ping percentiles: p50 {}ms p95 {}ms p99 {}ms Highest: {}ms",
+				        histogram.Percentile(50),
+				        histogram.Percentile(95),
+				        histogram.Percentile(99),
+				        histogram.Max()));
+
+			const auto& estimator = con.lagEstimator[clientTarget];
+			PrintUserCmdText(client, std::format(L"Late updates: {} of {}", estimator.LateUpdates(), estimator.Samples()));
+		}
 	}
 
 	const std::vector commands = {{
-	    CreateUserCommand(L"/ping", L"", UserCmdPing, L"Gets the ping of your current target, if you have no player as a target it will return your ping."),
+	    CreateUserCommand(L"/ping", L"[detail]", UserCmdPing,
+	        L"Gets the ping of your current target, if you have no player as a target it will return your ping. Add detail to see ping percentiles."),
 	}};
 
 	/** @ingroup Condata
@@ -400,21 +422,27 @@ namespace Plugins::ConData
 	 */
 	void ReceiveExceptionData(const ConnectionDataException& exc)
 	{
-		global->connections[exc.client].exception = exc.isException;
-		global->connections[exc.client].exceptionReason = exc.reason;
-		if (!global->connections[exc.client].exception)
+		global->connections.exception[exc.client] = exc.isException;
+		global->connections.exceptionReason[exc.client] = exc.reason;
+		if (!global->connections.exception[exc.client])
 			ClearConData(exc.client);
 	}
 
 	/** @ingroup Condata
-	 * @brief Receive Connection data from inter-plugin communication.
+	 * @brief Receive Connection data from inter-plugin communication. Fills in the averages and ping percentiles of cd.client.
 	 */
 	void ReceiveConnectionData(ConnectionData& cd)
 	{
-		cd.averageLoss = global->connections[cd.client].averageLoss;
-		cd.averagePing = global->connections[cd.client].averagePing;
-		cd.lags = global->connections[cd.client].lags;
-		cd.pingFluctuation = global->connections[cd.client].pingFluctuation;
+		cd.averageLoss = global->connections.averageLoss[cd.client];
+		cd.averagePing = global->connections.averagePing[cd.client];
+		cd.lags = global->connections.lags[cd.client];
+		cd.pingFluctuation = global->connections.pingFluctuation[cd.client];
+
+		const auto& histogram = global->connections.pingHistogram[cd.client];
+		cd.pingP50 = histogram.Percentile(50);
+		cd.pingP95 = histogram.Percentile(95);
+		cd.pingP99 = histogram.Percentile(99);
+		cd.pingMax = histogram.Max();
 	}
 
 	/** @ingroup Condata
@@ -424,6 +452,7 @@ namespace Plugins::ConData
 	{
 		if (command == L"getstats")
 		{
+			LatencyHistogram serverPing;
 			struct PlayerData* playerData = nullptr;
 			while ((playerData = Players.traverse_active(playerData)))
 			{
@@ -435,19 +464,26 @@ namespace Plugins::ConData
 				if (!cdpClient)
 					continue;
 
-				auto& con = global->connections[client];
+				auto& con = global->connections;
 
 				auto saturation = static_cast<int>(cdpClient->GetLinkSaturation() * 100);
 				int txqueue = cdpClient->GetSendQSize();
 				classptr->Print(wstos(std::format(L"charname={} clientid={} loss={} lag={} pingfluct={} saturation={} txqueue={}\n",
 				    Hk::Client::GetCharacterNameByID(client).value(),
 				    client,
-				    con.averageLoss,
-				    con.lags,
-				    con.pingFluctuation,
+				    con.averageLoss[client],
+				    con.lags[client],
+				    con.pingFluctuation[client],
 				    saturation,
 				    txqueue)));
+				serverPing.Merge(con.pingHistogram[client]);
 			}
+			classptr->Print(std::format("server ping p50={} p95={} p99={} max={} samples={}\n",
+			    serverPing.Percentile(50),
+			    serverPing.Percentile(95),
+			    serverPing.Percentile(99),
+			    serverPing.Max(),
+			    serverPing.Total()));
 			classptr->Print("OK");
 			global->returncode = ReturnCode::SkipAll;
 			return true;
@@ -485,11 +521,39 @@ namespace Plugins::ConData
 		this->ReceiveException = ReceiveExceptionData;
 	}
 
+	/** @ingroup Condata
+	 * @brief Shutdown hook. Writes the connection log records still queued and stops its writer on the game thread.
+	 */
+	void Shutdown()
+	{
+		if (global->connectionLog)
+			global->connectionLog->Stop();
+	}
+
 	void LoadSettings()
 	{
 		auto config = Serializer::JsonToObject<Config>();
 		global->config = std::make_unique<Config>(config);
 
+		if (global->connectionLog)
+			global->connectionLog->Stop();
+		global->connectionLog.reset();
+		if (config.recordConnections)
+		{
+			char path[MAX_PATH];
+			GetUserDataPath(path);
+			global->connectionLog = std::make_unique<ConnectionLog::Writer>(
+			    std::string(path) + "\\ConnectionLog.bin", static_cast<uint64_t>(std::max(config.connectionLogSizeInMb, 1u)) * 1024 * 1024);
+		}
+
+		// size the sample windows to the configured frames
+		auto& con = global->connections;
+		for (ClientId client = 0; client <= MaxClientId; client++)
+		{
+			con.pingWindow[client].Configure(std::max(config.pingKickFrame, 1u));
+			con.lossWindow[client].Configure(std::max(config.lossKickFrame / LossInterval, 1u));
+		}
+
 		// check for logged in players and reset their connection data
 		struct PlayerData* playerData = nullptr;
 		while ((playerData = Players.traverse_active(playerData)))
@@ -516,7 +580,8 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 {
 	pi->name(ConDataCommunicator::pluginName);
 	pi->shortName("condata");
-	pi->mayUnload(true);
+	// The connection log writer thread cannot be joined safely while the DLL is being unloaded
+	pi->mayUnload(false);
 	pi->commands(&commands);
 	pi->timers(&timers);
 	pi->returnCode(&global->returncode);
@@ -524,6 +589,7 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 	pi->versionMinor(PluginMinorVersion::VERSION_00);
 	pi->emplaceHook(HookedCall::FLHook__ClearClientInfo, &ClearClientInfo, HookStep::After);
 	pi->emplaceHook(HookedCall::FLHook__LoadSettings, &LoadSettings, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__Shutdown, &Shutdown);
 	pi->emplaceHook(HookedCall::FLHook__TimerCheckKick, &TimerCheckKick);
 	pi->emplaceHook(HookedCall::IServerImpl__SPObjUpdate, &SPObjUpdate);
 	pi->emplaceHook(HookedCall::IServerImpl__PlayerLaunch, &PlayerLaunch);
@@ -2,17 +2,25 @@
 
 #include <FLHook.hpp>
 #include "plugin.h"
+#include "ConnectionLog.h"
+#include "LagEstimator.h"
+#include "LatencyHistogram.h"
+#include "SampleWindow.h"
 
 constexpr int LossInterval = 4;
 
 namespace Plugins::ConData
 {
+	//! Connection data as exchanged over IPC. The caller sets client and ReceiveData fills in the averages. The plugin itself keeps this data in
+	//! ConnectionTable. The layout is shared with plugins built against older versions of this header, so members are only ever added at the end.
 	struct ConnectionData
 	{
 		// connection data
+		//! Unused, kept so the layout stays compatible
 		std::list<uint> lossList;
 		uint lastLoss;
 		uint averageLoss;
+		//! Unused, kept so the layout stays compatible
 		std::list<uint> pingList;
 		uint averagePing;
 		//! Variation in minimal and maximum ping between client and server.
@@ -21,6 +29,7 @@ namespace Plugins::ConData
 		uint lastPacketsReceived;
 		uint lastPacketsDropped;
 		uint lags;
+		//! Unused, kept so the layout stays compatible
 		std::list<uint> objUpdateIntervalsList;
 		mstime lastObjUpdate;
 		mstime lastObjTimestamp;
@@ -31,6 +40,12 @@ namespace Plugins::ConData
 
 		// Client Id (for when receiving data)
 		uint client;
+
+		//! Ping percentiles and the highest ping seen, from the client's latency histogram
+		uint pingP50;
+		uint pingP95;
+		uint pingP99;
+		uint pingMax;
 	};
 
 	struct ConnectionDataException final
@@ -72,6 +87,52 @@ namespace Plugins::ConData
 		uint lagDetectionMin = 50;
 		uint kickThreshold = 0;
 		bool allowPing = true;
+		//! Number of ping samples after which a client's latency histogram is halved, so older samples fade out
+		uint pingHistogramDecaySamples = 600;
+		//! Whether every client's ping, loss and lag is written to ConnectionLog.bin each second, for analysis with the condata analyzer
+		bool recordConnections = false;
+		//! Size at which the connection log is rotated to ConnectionLog.1.bin
+		uint connectionLogSizeInMb = 64;
+	};
+
+	//! Reasons TimerCheckKick kicks a client for, as bits of ConnectionTable::kickReasons
+	enum KickReason : uint8_t
+	{
+		KickForLoss = 1 << 0,
+		KickForPing = 1 << 1,
+		KickForFluctuation = 1 << 2,
+		KickForLag = 1 << 3,
+	};
+
+	//! Connection data of every client, one array per field. The numbers the timers read every second sit in contiguous arrays so the kick
+	//! check is a single loop over all clients.
+	struct ConnectionTable final
+	{
+		template<typename T>
+		using PerClient = std::array<T, MaxClientId + 1>;
+
+		// hot: read by the timers and the kick check
+		PerClient<uint> lastPing {};
+		PerClient<uint> averagePing {};
+		//! Variation in minimal and maximum ping between client and server.
+		PerClient<uint> pingFluctuation {};
+		PerClient<uint> lastLoss {};
+		PerClient<uint> averageLoss {};
+		PerClient<uint> lags {};
+		PerClient<uint> lastPacketsSent {};
+		PerClient<uint> lastPacketsReceived {};
+		PerClient<uint> lastPacketsDropped {};
+		PerClient<uint8_t> kickReasons {};
+		//! When the client's session was first written to the connection log, 0 until then
+		PerClient<int64_t> sessionStartInMs {};
+
+		// cold: only touched by the client's own updates
+		PerClient<SampleWindow> pingWindow;
+		PerClient<SampleWindow> lossWindow;
+		PerClient<LagEstimator> lagEstimator;
+		PerClient<LatencyHistogram> pingHistogram;
+		PerClient<bool> exception {};
+		PerClient<std::string> exceptionReason;
 	};
 
 	//! Global data for this plugin
@@ -82,11 +143,15 @@ namespace Plugins::ConData
 		// Other fields
 		ReturnCode returncode = ReturnCode::Default;
 
-		ConnectionData connections[MaxClientId + 1];
+		ConnectionTable connections;
+
+		//! Writes the connection log when recordConnections is enabled
+		std::unique_ptr<ConnectionLog::Writer> connectionLog;
 
 		ConDataCommunicator* communicator = nullptr;
 	};
 }; // namespace Plugins::ConData
 
 REFL_AUTO(type(Plugins::ConData::Config), field(pingKick), field(pingKickFrame), field(fluctKick), field(lossKick), field(lossKickFrame), field(lagKick),
-    field(lagDetectionFrame), field(lagDetectionMin), field(kickThreshold), field(allowPing))
\ No newline at end of file
+    field(lagDetectionFrame), field(lagDetectionMin), field(kickThreshold), field(allowPing),
+    field(pingHistogramDecaySamples), field(recordConnections), field(connectionLogSizeInMb))
\ No newline at end of file
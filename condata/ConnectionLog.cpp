@@ -0,0 +1,158 @@
+#include "ConnectionLog.h"
+
+#include <cstring>
+#include <iterator>
+
+namespace Plugins::ConData::ConnectionLog
+{
+	// Layout (little endian):
+	//   char[4]  magic "FLCL"
+	//   uint32   version
+	//   records: int64 unix timestamp in ms, uint16 client, uint32 ping, uint16 loss, uint16 lag percent, uint16 server load in ms,
+	//            int64 unix session start in ms
+	constexpr char magic[4] = {'F', 'L', 'C', 'L'};
+	constexpr uint32_t version = 2;
+	constexpr size_t headerSize = sizeof(magic) + sizeof(version);
+	constexpr size_t recordSize = sizeof(int64_t) + sizeof(uint16_t) + sizeof(uint32_t) + sizeof(uint16_t) * 3 + sizeof(int64_t);
+
+	void Encode(std::vector<char>& out, const Record& record)
+	{
+		char encoded[recordSize];
+		std::memcpy(encoded, &record.timestampInMs, sizeof(int64_t));
+		std::memcpy(encoded + 8, &record.client, sizeof(uint16_t));
+		std::memcpy(encoded + 10, &record.ping, sizeof(uint32_t));
+		std::memcpy(encoded + 14, &record.loss, sizeof(uint16_t));
+		std::memcpy(encoded + 16, &record.lagPercent, sizeof(uint16_t));
+		std::memcpy(encoded + 18, &record.serverLoadInMs, sizeof(uint16_t));
+		std::memcpy(encoded + 20, &record.sessionStartInMs, sizeof(int64_t));
+		out.insert(out.end(), std::begin(encoded), std::end(encoded));
+	}
+
+	std::vector<Record> Decode(const std::vector<char>& data)
+	{
+		std::vector<Record> records;
+
+		uint32_t fileVersion;
+		if (data.size() < headerSize || std::memcmp(data.data(), magic, sizeof(magic)) != 0)
+			return records;
+
+		std::memcpy(&fileVersion, data.data() + sizeof(magic), sizeof(fileVersion));
+		if (fileVersion != version)
+			return records;
+
+		records.reserve((data.size() - headerSize) / recordSize);
+		for (size_t offset = headerSize; data.size() - offset >= recordSize; offset += recordSize)
+		{
+			const char* encoded = data.data() + offset;
+			Record& record = records.emplace_back();
+			std::memcpy(&record.timestampInMs, encoded, sizeof(int64_t));
+			std::memcpy(&record.client, encoded + 8, sizeof(uint16_t));
+			std::memcpy(&record.ping, encoded + 10, sizeof(uint32_t));
+			std::memcpy(&record.loss, encoded + 14, sizeof(uint16_t));
+			std::memcpy(&record.lagPercent, encoded + 16, sizeof(uint16_t));
+			std::memcpy(&record.serverLoadInMs, encoded + 18, sizeof(uint16_t));
+			std::memcpy(&record.sessionStartInMs, encoded + 20, sizeof(int64_t));
+		}
+
+		return records;
+	}
+
+	std::vector<Record> Read(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			return {};
+
+		const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		return Decode(data);
+	}
+
+	std::filesystem::path RotatedPath(const std::filesystem::path& path)
+	{
+		auto rotated = path;
+		rotated.replace_extension(".1" + path.extension().string());
+		return rotated;
+	}
+
+	Writer::Writer(std::filesystem::path path, uint64_t maxBytes) : path(std::move(path)), maxBytes(maxBytes)
+	{
+		Open();
+	}
+
+	void Writer::Append(std::vector<Record> records)
+	{
+		if (records.empty())
+			return;
+
+		worker.Post([this, records = std::move(records)] {
+			buffer.clear();
+			for (const auto& record : records)
+				Encode(buffer, record);
+
+			if (bytesWritten + buffer.size() > maxBytes)
+				Rotate();
+
+			file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			file.flush();
+			bytesWritten += buffer.size();
+		});
+	}
+
+	void Writer::Stop()
+	{
+		worker.Stop();
+	}
+
+	//! Whether the file starts with the header of the current version
+	bool HasCurrentHeader(const std::filesystem::path& path)
+	{
+		char header[headerSize];
+		std::ifstream file(path, std::ios::binary);
+		if (!file.read(header, sizeof(header)))
+			return false;
+
+		uint32_t fileVersion;
+		std::memcpy(&fileVersion, header + sizeof(magic), sizeof(fileVersion));
+		return std::memcmp(header, magic, sizeof(magic)) == 0 && fileVersion == version;
+	}
+
+	void Writer::Open()
+	{
+		// Keep appending to the log of a previous run. A crash mid-append leaves part of a record at the end, which is cut off so the records
+		// that follow stay aligned.
+		std::error_code ec;
+		const auto existing = std::filesystem::file_size(path, ec);
+		if (!ec && existing >= headerSize && HasCurrentHeader(path))
+		{
+			const auto intact = existing - (existing - headerSize) % recordSize;
+			if (intact != existing)
+				std::filesystem::resize_file(path, intact, ec);
+
+			if (!ec)
+			{
+				file.open(path, std::ios::binary | std::ios::app);
+				bytesWritten = intact;
+				return;
+			}
+		}
+
+		// A log of another version or with a broken header is kept for the analyzer rather than overwritten
+		if (std::filesystem::exists(path, ec))
+			std::filesystem::rename(path, RotatedPath(path), ec);
+
+		file.open(path, std::ios::binary | std::ios::trunc);
+		file.write(magic, sizeof(magic));
+		file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+		bytesWritten = headerSize;
+	}
+
+	void Writer::Rotate()
+	{
+		file.close();
+
+		std::error_code ec;
+		std::filesystem::rename(path, RotatedPath(path), ec);
+		std::filesystem::remove(path, ec);
+		Open();
+	}
+} // namespace Plugins::ConData::ConnectionLog
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "../common/WorkerThread.h"
+
+// The connection log only depends on the standard library so the offline analyzer can read it outside of the server.
+namespace Plugins::ConData::ConnectionLog
+{
+	//! The connection quality of one client at one point in time
+	struct Record final
+	{
+		int64_t timestampInMs = 0;
+		//! When the client's session was first recorded. Client ids are reused after a disconnect, so only both together identify a session.
+		int64_t sessionStartInMs = 0;
+		uint16_t client = 0;
+		uint32_t ping = 0;
+		uint16_t loss = 0;
+		uint16_t lagPercent = 0;
+		uint16_t serverLoadInMs = 0;
+	};
+
+	//! Appends the encoded record to the buffer
+	void Encode(std::vector<char>& out, const Record& record);
+
+	//! Decodes the records of a log file. Decoding stops at the first incomplete record, which is what a crash mid-append leaves behind. Logs of
+	//! another version yield no records.
+	std::vector<Record> Decode(const std::vector<char>& data);
+
+	//! Reads every record of a log file. A missing file yields no records.
+	std::vector<Record> Read(const std::filesystem::path& path);
+
+	//! The file a log is moved to when it is rotated
+	std::filesystem::path RotatedPath(const std::filesystem::path& path);
+
+	//! Appends records to the log from a background thread. Once the log exceeds maxBytes it is moved to RotatedPath, replacing the previous
+	//! one, and started over. A log left by a previous run is appended to, and a log in another format is rotated out of the way. The owner
+	//! stops it with Stop before destroying it.
+	class Writer final
+	{
+	  public:
+		Writer(std::filesystem::path path, uint64_t maxBytes);
+
+		//! Queues records to be appended to the log
+		void Append(std::vector<Record> records);
+
+		//! Writes everything still queued and stops the writer thread
+		void Stop();
+
+	  private:
+		void Open();
+		void Rotate();
+
+		std::filesystem::path path;
+		uint64_t maxBytes;
+		uint64_t bytesWritten = 0;
+		std::ofstream file;
+		std::vector<char> buffer;
+		WorkerThread worker;
+	};
+} // namespace Plugins::ConData::ConnectionLog
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+
+// Header-only and dependent on the standard library alone, so it can be built and exercised outside the server.
+namespace Plugins::ConData
+{
+	//! Estimates how often a client's object updates arrive late, without allocating. Each update's lag is compared to the time the client says
+	//! passed since its previous update. The share of late updates is kept as an exponentially-weighted moving average in 16.16 fixed point.
+	class LagEstimator final
+	{
+	  public:
+		//! Remembers the times of an update without measuring it. Used for the first update after launch and updates that are not representative,
+		//! such as those sent in a trade lane.
+		void Skip(int64_t nowInMs, int64_t timestampInMs)
+		{
+			lastUpdateInMs = nowInMs;
+			lastTimestampInMs = timestampInMs;
+			hasPrevious = true;
+		}
+
+		//! Measures an update against the previous one. An update is late when its lag, less the server load, exceeds thresholdPercent of the
+		//! client's own interval. frame is the number of updates the average spans.
+		void Update(int64_t nowInMs, int64_t timestampInMs, uint32_t serverLoadInMs, uint32_t thresholdPercent, uint32_t frame)
+		{
+			if (!hasPrevious || !frame)
+			{
+				Skip(nowInMs, timestampInMs);
+				return;
+			}
+
+			const int64_t interval = nowInMs - lastUpdateInMs;
+			const int64_t clientInterval = timestampInMs - lastTimestampInMs;
+			Skip(nowInMs, timestampInMs);
+
+			int64_t lag = interval - clientInterval;
+			lag = (lag < 0 ? -lag : lag) - serverLoadInMs;
+			const bool late = clientInterval > 0 && lag > 0 && lag * 100 > static_cast<int64_t>(thresholdPercent) * clientInterval;
+
+			// The step is rounded rather than truncated, or the average stalls short of 0% and 100% as soon as the distance left is below frame
+			const int64_t target = late ? OneHundredPercent : 0;
+			const int64_t distance = target - average;
+			const int64_t divisor = frame;
+			average += (distance + (distance < 0 ? -divisor : divisor) / 2) / divisor;
+			samples++;
+			lateUpdates += late;
+		}
+
+		//! Forgets the previous update so the next one is only remembered, keeping the average. Used when the client launches.
+		void Restart() { hasPrevious = false; }
+
+		void Reset()
+		{
+			hasPrevious = false;
+			average = 0;
+			samples = 0;
+			lateUpdates = 0;
+		}
+
+		//! Whether enough updates were measured for the average to span the frame
+		[[nodiscard]] bool Ready(uint32_t frame) const { return samples >= frame; }
+
+		//! Moving average of late updates in percent, rounded to the nearest percent
+		[[nodiscard]] uint32_t LagPercent() const { return static_cast<uint32_t>((average + (OneHundredPercent / 200)) >> 16); }
+
+		[[nodiscard]] uint64_t Samples() const { return samples; }
+		[[nodiscard]] uint64_t LateUpdates() const { return lateUpdates; }
+
+	  private:
+		static constexpr int64_t OneHundredPercent = int64_t {100} << 16;
+
+		int64_t lastUpdateInMs = 0;
+		int64_t lastTimestampInMs = 0;
+		int64_t average = 0;
+		uint64_t samples = 0;
+		uint64_t lateUpdates = 0;
+		bool hasPrevious = false;
+	};
+} // namespace Plugins::ConData
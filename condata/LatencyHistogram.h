@@ -0,0 +1,99 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+// Header-only and dependent on the standard library alone, so it can be built and exercised outside the server.
+namespace Plugins::ConData
+{
+	//! Constant-memory log-linear histogram of latencies in milliseconds. Every power of two range is split into SubBuckets linear buckets, so a
+	//! recorded value is off by at most 1/SubBuckets of itself.
+	class LatencyHistogram final
+	{
+	  public:
+		static constexpr uint32_t SubBucketBits = 4;
+		static constexpr uint32_t SubBuckets = 1u << SubBucketBits;
+		//! Values above this are recorded as this
+		static constexpr uint32_t MaxTrackedValue = (1u << 20) - 1;
+		static constexpr uint32_t BucketCount = SubBuckets * (std::bit_width(MaxTrackedValue) - SubBucketBits + 1);
+
+		void Record(uint32_t value)
+		{
+			value = std::min(value, MaxTrackedValue);
+			counts[BucketOf(value)]++;
+			total++;
+			maxValue = std::max(maxValue, value);
+		}
+
+		//! Adds the samples of another histogram to this one
+		void Merge(const LatencyHistogram& other)
+		{
+			for (uint32_t i = 0; i < BucketCount; i++)
+				counts[i] += other.counts[i];
+			total += other.total;
+			maxValue = std::max(maxValue, other.maxValue);
+		}
+
+		//! Halves every count so older samples weigh less than new ones. The maximum is kept until Clear.
+		void Decay()
+		{
+			total = 0;
+			for (auto& count : counts)
+			{
+				count /= 2;
+				total += count;
+			}
+		}
+
+		void Clear()
+		{
+			counts.fill(0);
+			total = 0;
+			maxValue = 0;
+		}
+
+		//! The value at or below which the given percentage of samples fall, reported as the top of its bucket. 0 if nothing was recorded.
+		[[nodiscard]] uint32_t Percentile(double percentile) const
+		{
+			if (!total)
+				return 0;
+
+			const auto wanted = std::max<uint64_t>(1, static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total) + 0.5));
+			uint64_t seen = 0;
+			for (uint32_t i = 0; i < BucketCount; i++)
+			{
+				seen += counts[i];
+				if (seen >= wanted)
+					return std::min(HighestValueOf(i), maxValue);
+			}
+			return maxValue;
+		}
+
+		[[nodiscard]] uint32_t Max() const { return maxValue; }
+		[[nodiscard]] uint64_t Total() const { return total; }
+
+		[[nodiscard]] static constexpr uint32_t BucketOf(uint32_t value)
+		{
+			if (value < SubBuckets)
+				return value;
+
+			const uint32_t shift = std::bit_width(value) - SubBucketBits - 1;
+			return SubBuckets * (shift + 1) + ((value >> shift) - SubBuckets);
+		}
+
+		[[nodiscard]] static constexpr uint32_t HighestValueOf(uint32_t bucket)
+		{
+			if (bucket < SubBuckets)
+				return bucket;
+
+			const uint32_t shift = bucket / SubBuckets - 1;
+			return ((SubBuckets + bucket % SubBuckets + 1) << shift) - 1;
+		}
+
+	  private:
+		std::array<uint32_t, BucketCount> counts {};
+		uint64_t total = 0;
+		uint32_t maxValue = 0;
+	};
+} // namespace Plugins::ConData
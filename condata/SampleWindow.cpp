@@ -0,0 +1,71 @@
+#include "SampleWindow.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Plugins::ConData
+{
+	uint32_t SampleWindow::Difference(uint32_t newer, uint32_t older)
+	{
+		if (newer == 0)
+			return 0;
+
+		// Computed in float like the per-sample sqrt(pow()) it replaces, so large samples round the same way
+		return static_cast<uint32_t>(std::fabs(static_cast<float>(newer) - static_cast<float>(older)));
+	}
+
+	void SampleWindow::Configure(size_t capacity, uint32_t newThreshold)
+	{
+		if (capacity == samples.size() && newThreshold == threshold)
+			return;
+
+		const size_t kept = std::min(count, capacity);
+		std::vector<uint32_t> newest;
+		newest.reserve(kept);
+		for (size_t age = count - kept; age < count; age++)
+			newest.emplace_back(At(age));
+
+		samples.assign(capacity, 0);
+		threshold = newThreshold;
+		Clear();
+		for (const auto sample : newest)
+			Push(sample);
+	}
+
+	void SampleWindow::Push(uint32_t sample)
+	{
+		if (samples.empty())
+			return;
+
+		if (count == samples.size())
+		{
+			const uint32_t evicted = At(0);
+			sum -= evicted;
+			if (evicted > threshold)
+				aboveThreshold--;
+			if (count > 1)
+				fluctuation -= Difference(At(1), evicted);
+
+			oldest = (oldest + 1) % samples.size();
+			count--;
+		}
+
+		if (count)
+			fluctuation += Difference(sample, At(count - 1));
+		sum += sample;
+		if (sample > threshold)
+			aboveThreshold++;
+
+		samples[(oldest + count) % samples.size()] = sample;
+		count++;
+	}
+
+	void SampleWindow::Clear()
+	{
+		oldest = 0;
+		count = 0;
+		sum = 0;
+		fluctuation = 0;
+		aboveThreshold = 0;
+	}
+} // namespace Plugins::ConData
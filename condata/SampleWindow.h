@@ -0,0 +1,49 @@
+#pragma once
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The window only depends on the standard library, so it can be built and exercised outside the server.
+namespace Plugins::ConData
+{
+	//! Fixed-capacity ring of connection samples. The sum, the fluctuation and the count of samples above a threshold are updated as samples are
+	//! added and evicted, so reading them never walks the window.
+	class SampleWindow final
+	{
+	  public:
+		//! Sets the capacity and threshold, keeping the newest samples that still fit and recomputing the aggregates from them
+		void Configure(size_t capacity, uint32_t threshold = UINT_MAX);
+
+		//! Adds a sample as the newest, evicting the oldest one if the window is full
+		void Push(uint32_t sample);
+
+		void Clear();
+
+		[[nodiscard]] size_t Size() const { return count; }
+		[[nodiscard]] size_t Capacity() const { return samples.size(); }
+
+		//! Sum of all samples, wrapping like the unsigned accumulators it replaces
+		[[nodiscard]] uint32_t Sum() const { return sum; }
+
+		//! Sum of the absolute differences between neighbouring samples. A pair is skipped when its newer sample is 0.
+		[[nodiscard]] uint32_t Fluctuation() const { return fluctuation; }
+
+		//! Number of samples above the configured threshold
+		[[nodiscard]] uint32_t CountAboveThreshold() const { return aboveThreshold; }
+
+	  private:
+		//! Sample at the given age, 0 being the oldest
+		[[nodiscard]] uint32_t At(size_t age) const { return samples[(oldest + age) % samples.size()]; }
+
+		static uint32_t Difference(uint32_t newer, uint32_t older);
+
+		std::vector<uint32_t> samples;
+		size_t oldest = 0;
+		size_t count = 0;
+		uint32_t threshold = UINT_MAX;
+		uint32_t sum = 0;
+		uint32_t fluctuation = 0;
+		uint32_t aboveThreshold = 0;
+	};
+} // namespace Plugins::ConData
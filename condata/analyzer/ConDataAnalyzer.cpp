@@ -0,0 +1,133 @@
+// Offline analyzer for the connection logs ConData writes when recordConnections is enabled. It only depends on the standard library:
+//   g++ -std=c++20 -O2 -o condata_analyzer ConDataAnalyzer.cpp ../ConnectionLog.cpp
+//   ./condata_analyzer ConnectionLog.1.bin ConnectionLog.bin
+// Prints ping, loss and lag percentiles per client session, and how ping and lag correlate with the server load. Client ids are reused after a
+// disconnect, so a session is a client id together with the time it was first recorded.
+
+#include "../ConnectionLog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+
+using namespace Plugins::ConData;
+
+namespace
+{
+	uint32_t Percentile(std::vector<uint32_t>& values, double percentile)
+	{
+		if (values.empty())
+			return 0;
+
+		const auto index = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(values.size()))) - 1;
+		std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+		return values[index];
+	}
+
+	//! Pearson correlation of two equally long series, 0 when either does not vary
+	double Correlation(const std::vector<uint32_t>& x, const std::vector<uint32_t>& y)
+	{
+		const auto n = static_cast<double>(x.size());
+		if (x.size() < 2)
+			return 0.0;
+
+		double sumX = 0, sumY = 0;
+		for (size_t i = 0; i < x.size(); i++)
+		{
+			sumX += x[i];
+			sumY += y[i];
+		}
+
+		const double meanX = sumX / n, meanY = sumY / n;
+		double covariance = 0, varianceX = 0, varianceY = 0;
+		for (size_t i = 0; i < x.size(); i++)
+		{
+			const double dx = x[i] - meanX, dy = y[i] - meanY;
+			covariance += dx * dy;
+			varianceX += dx * dx;
+			varianceY += dy * dy;
+		}
+
+		if (varianceX == 0 || varianceY == 0)
+			return 0.0;
+		return covariance / std::sqrt(varianceX * varianceY);
+	}
+
+	struct Series
+	{
+		std::vector<uint32_t> ping;
+		std::vector<uint32_t> loss;
+		std::vector<uint32_t> lag;
+		std::vector<uint32_t> serverLoad;
+
+		void Add(const ConnectionLog::Record& record)
+		{
+			ping.emplace_back(record.ping);
+			loss.emplace_back(record.loss);
+			lag.emplace_back(record.lagPercent);
+			serverLoad.emplace_back(record.serverLoadInMs);
+		}
+
+		void Print(const char* label)
+		{
+			// Correlations first, the percentiles reorder the series
+			const double pingCorrelation = Correlation(ping, serverLoad);
+			const double lagCorrelation = Correlation(lag, serverLoad);
+			std::printf("%-16s %8zu %5u %5u %5u %5u %5u %5u %5u %+9.2f %+8.2f\n",
+			    label,
+			    ping.size(),
+			    Percentile(ping, 50),
+			    Percentile(ping, 95),
+			    Percentile(ping, 99),
+			    Percentile(loss, 50),
+			    Percentile(loss, 95),
+			    Percentile(lag, 50),
+			    Percentile(lag, 95),
+			    pingCorrelation,
+			    lagCorrelation);
+		}
+	};
+} // namespace
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "Usage: %s <connection log>...\n", argv[0]);
+		return 1;
+	}
+
+	std::map<std::pair<int64_t, uint16_t>, Series> sessions;
+	Series all;
+	int64_t first = INT64_MAX, last = INT64_MIN;
+	for (int i = 1; i < argc; i++)
+	{
+		for (const auto& record : ConnectionLog::Read(argv[i]))
+		{
+			sessions[{record.sessionStartInMs, record.client}].Add(record);
+			all.Add(record);
+			first = std::min(first, record.timestampInMs);
+			last = std::max(last, record.timestampInMs);
+		}
+	}
+
+	if (all.ping.empty())
+	{
+		std::fprintf(stderr, "No records found\n");
+		return 1;
+	}
+
+	std::printf("%zu records over %.1f minutes\n\n", all.ping.size(), static_cast<double>(last - first) / 60000.0);
+	std::printf("%-16s %8s %5s %5s %5s %5s %5s %5s %5s %9s %8s\n", "client@minute", "samples", "p50", "p95", "p99", "loss", "l95", "lag", "lag95",
+	    "ping~load", "lag~load");
+	for (auto& [session, series] : sessions)
+	{
+		const auto& [sessionStart, client] = session;
+		char label[32];
+		std::snprintf(label, sizeof(label), "%u@%.1f", client, static_cast<double>(sessionStart - first) / 60000.0);
+		series.Print(label);
+	}
+	all.Print("all");
+	return 0;
+}
@@ -0,0 +1,140 @@
+// Tests for the connection log: round trips, recovering from a torn record and rotating logs of another version out of the way:
+//   g++ -std=c++20 -O2 -o connection_log_test ConnectionLogTest.cpp ../ConnectionLog.cpp
+//   ./connection_log_test
+// Exits with the number of failed checks.
+
+#include "../ConnectionLog.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace Plugins::ConData;
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			failures++;
+		}
+	}
+
+	ConnectionLog::Record Sample(int i)
+	{
+		return {1'700'000'000'000 + i * 1000,
+		    1'699'999'990'000 + (i % 3),
+		    static_cast<uint16_t>(i % 7 + 1),
+		    static_cast<uint32_t>(100 + i),
+		    static_cast<uint16_t>(i % 5),
+		    static_cast<uint16_t>(i % 100),
+		    static_cast<uint16_t>(i % 50)};
+	}
+
+	bool Equal(const ConnectionLog::Record& a, const ConnectionLog::Record& b)
+	{
+		return a.timestampInMs == b.timestampInMs && a.sessionStartInMs == b.sessionStartInMs && a.client == b.client && a.ping == b.ping &&
+		       a.loss == b.loss && a.lagPercent == b.lagPercent && a.serverLoadInMs == b.serverLoadInMs;
+	}
+
+	void Write(const std::filesystem::path& path, int from, int to)
+	{
+		ConnectionLog::Writer writer(path, 1024 * 1024);
+		std::vector<ConnectionLog::Record> records;
+		for (int i = from; i < to; i++)
+			records.push_back(Sample(i));
+		writer.Append(std::move(records));
+		writer.Stop();
+	}
+
+	bool Matches(const std::vector<ConnectionLog::Record>& records, int from, int to)
+	{
+		if (records.size() != static_cast<size_t>(to - from))
+			return false;
+
+		for (int i = from; i < to; i++)
+		{
+			if (!Equal(records[i - from], Sample(i)))
+				return false;
+		}
+		return true;
+	}
+
+	void TestRoundTrip(const std::filesystem::path& path)
+	{
+		Write(path, 0, 100);
+		Write(path, 100, 150);
+		Check(Matches(ConnectionLog::Read(path), 0, 150), "records written by two runs read back in order");
+	}
+
+	void TestTornRecord(const std::filesystem::path& path)
+	{
+		Write(path, 0, 10);
+
+		// A crash mid-append leaves the first bytes of a record behind
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::app);
+			file.write("\x01\x02\x03\x04\x05", 5);
+		}
+		Check(Matches(ConnectionLog::Read(path), 0, 10), "a torn record is ignored when reading");
+
+		Write(path, 10, 20);
+		Check(Matches(ConnectionLog::Read(path), 0, 20), "the next run keeps the complete records and appends after them");
+		Check(!std::filesystem::exists(ConnectionLog::RotatedPath(path)), "a torn record does not rotate the log");
+	}
+
+	void TestOtherVersion(const std::filesystem::path& path)
+	{
+		// A log of an older version, whose records have no session start
+		std::vector<char> data = {'F', 'L', 'C', 'L', 1, 0, 0, 0};
+		const int64_t timestamp = 1'600'000'000'000;
+		const uint16_t client = 4;
+		const uint32_t ping = 250;
+		const uint16_t zero = 0;
+		const auto write = [&data](const auto& value) {
+			const auto* bytes = reinterpret_cast<const char*>(&value);
+			data.insert(data.end(), bytes, bytes + sizeof(value));
+		};
+		write(timestamp);
+		write(client);
+		write(ping);
+		write(zero);
+		write(zero);
+		write(zero);
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			file.write(data.data(), static_cast<std::streamsize>(data.size()));
+		}
+
+		Check(ConnectionLog::Read(path).empty(), "a log of another version is not read");
+
+		Write(path, 0, 5);
+		Check(Matches(ConnectionLog::Read(path), 0, 5), "a log of another version is started over");
+		Check(std::filesystem::file_size(ConnectionLog::RotatedPath(path)) == data.size(),
+		    "a log of another version is rotated instead of overwritten");
+	}
+} // namespace
+
+int main()
+{
+	const auto path = std::filesystem::temp_directory_path() / "connection_log_test.bin";
+	const auto clean = [&path] {
+		std::filesystem::remove(path);
+		std::filesystem::remove(ConnectionLog::RotatedPath(path));
+	};
+
+	clean();
+	TestRoundTrip(path);
+	clean();
+	TestTornRecord(path);
+	clean();
+	TestOtherVersion(path);
+	clean();
+
+	if (!failures)
+		std::printf("All connection log tests passed.\n");
+	return failures;
+}
@@ -0,0 +1,48 @@
+// Microbenchmark of LagEstimator::Update, which runs for every object update a client sends:
+//   g++ -std=c++20 -O2 -o lag_estimator_benchmark LagEstimatorBenchmark.cpp
+//   ./lag_estimator_benchmark
+
+#include "../LagEstimator.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Plugins::ConData;
+
+int main()
+{
+	constexpr size_t Clients = 255;
+	constexpr size_t UpdatesPerClient = 40000;
+
+	std::mt19937 rng {3};
+	std::uniform_int_distribution<int> jitter {-60, 60};
+	std::vector<int> jitters(1 << 16);
+	for (auto& value : jitters)
+		value = jitter(rng);
+
+	std::array<LagEstimator, Clients> estimators;
+	uint64_t updates = 0;
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < UpdatesPerClient; i++)
+	{
+		const int64_t timestamp = static_cast<int64_t>(i) * 100;
+		for (size_t client = 0; client < Clients; client++)
+		{
+			const int64_t now = 1'000'000 + timestamp + jitters[(i * Clients + client) & 0xFFFF];
+			estimators[client].Update(now, timestamp, 5, 50, 50);
+			updates++;
+		}
+	}
+	const double elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+	uint64_t checksum = 0;
+	for (const auto& estimator : estimators)
+		checksum += estimator.LagPercent() + estimator.LateUpdates();
+
+	std::printf("%llu updates, %.2f ns/update (checksum %llu)\n", static_cast<unsigned long long>(updates), elapsed / static_cast<double>(updates),
+	    static_cast<unsigned long long>(checksum));
+	return 0;
+}
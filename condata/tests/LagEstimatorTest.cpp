@@ -0,0 +1,154 @@
+// Replay tests for the ConData lag estimator. Update streams are replayed against the estimator and a floating point reference average:
+//   g++ -std=c++20 -O2 -o lag_estimator_test LagEstimatorTest.cpp
+//   ./lag_estimator_test
+// Exits with the number of failed checks.
+
+#include "../LagEstimator.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Plugins::ConData;
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			failures++;
+		}
+	}
+
+	constexpr uint32_t Threshold = 50;
+	constexpr uint32_t Frame = 50;
+	constexpr int64_t ClientInterval = 100;
+
+	//! An object update as the server received it
+	struct Update
+	{
+		int64_t nowInMs;
+		int64_t timestampInMs;
+		uint32_t serverLoadInMs;
+	};
+
+	//! Builds updates a client sends every ClientInterval ms, each one arriving late with the given probability
+	std::vector<Update> Trace(size_t count, double lateShare, uint32_t seed)
+	{
+		std::mt19937 rng {seed};
+		std::bernoulli_distribution late {lateShare};
+		std::vector<Update> updates;
+		int64_t now = 1'000'000;
+		int64_t timestamp = 5'000;
+		for (size_t i = 0; i < count; i++)
+		{
+			timestamp += ClientInterval;
+			// Late updates are alternately delayed and bunched up, which the estimator must treat the same
+			const int64_t jitter = late(rng) ? (i % 2 ? 80 : -70) : 10;
+			now += ClientInterval + jitter;
+			updates.push_back({now, timestamp, 0});
+			now -= jitter;
+		}
+		return updates;
+	}
+
+	//! Replays updates and returns the LagPercent after each one, alongside a double precision reference of the same average
+	uint32_t Replay(const std::vector<Update>& updates, double* reference = nullptr)
+	{
+		LagEstimator estimator;
+		double average = 0.0;
+		bool first = true;
+		int64_t lastNow = 0;
+		int64_t lastTimestamp = 0;
+		for (const auto& update : updates)
+		{
+			if (!first)
+			{
+				const int64_t clientInterval = update.timestampInMs - lastTimestamp;
+				int64_t lag = std::llabs(update.nowInMs - lastNow - clientInterval) - update.serverLoadInMs;
+				const bool late = clientInterval > 0 && lag > 0 && lag * 100 > Threshold * clientInterval;
+				average += ((late ? 100.0 : 0.0) - average) / Frame;
+			}
+			first = false;
+			lastNow = update.nowInMs;
+			lastTimestamp = update.timestampInMs;
+			estimator.Update(update.nowInMs, update.timestampInMs, update.serverLoadInMs, Threshold, Frame);
+		}
+
+		if (reference)
+			*reference = average;
+		return estimator.LagPercent();
+	}
+
+	void TestConstantLag()
+	{
+		Check(Replay(Trace(5000, 1.0, 1)) == 100, "a client lagging on every update reaches 100%");
+		Check(Replay(Trace(5000, 0.0, 1)) == 0, "a client that never lags stays at 0%");
+
+		// Recovering from constant lag must get all the way back down
+		auto updates = Trace(5000, 1.0, 2);
+		const auto recovery = Trace(5000, 0.0, 3);
+		const int64_t offset = updates.back().nowInMs - recovery.front().nowInMs + ClientInterval;
+		const int64_t timestampOffset = updates.back().timestampInMs - recovery.front().timestampInMs + ClientInterval;
+		for (const auto& update : recovery)
+			updates.push_back({update.nowInMs + offset, update.timestampInMs + timestampOffset, 0});
+		Check(Replay(updates) == 0, "a client that stops lagging returns to 0%");
+	}
+
+	void TestMatchesReference()
+	{
+		bool close = true;
+		for (const double share : {0.05, 0.25, 0.5, 0.75, 0.95})
+		{
+			for (uint32_t seed = 0; seed < 20; seed++)
+			{
+				double reference;
+				const uint32_t percent = Replay(Trace(2000, share, seed), &reference);
+				if (std::fabs(percent - reference) > 1.0)
+				{
+					std::printf("  share %.2f seed %u: estimator %u%%, reference %.2f%%\n", share, seed, percent, reference);
+					close = false;
+				}
+			}
+		}
+		Check(close, "the fixed point average stays within 1% of the floating point one");
+	}
+
+	void TestServerLoadAndSkip()
+	{
+		LagEstimator estimator;
+		estimator.Update(1000, 100, 0, Threshold, Frame);
+		Check(estimator.Samples() == 0, "the first update is only remembered");
+
+		// 80 ms of lag on a 100 ms interval, all of it explained by server load
+		estimator.Update(1180, 200, 80, Threshold, Frame);
+		Check(estimator.Samples() == 1 && estimator.LateUpdates() == 0, "lag caused by server load is not counted");
+
+		estimator.Update(1380, 300, 0, Threshold, Frame);
+		Check(estimator.LateUpdates() == 1, "lag above the threshold is counted");
+
+		estimator.Restart();
+		estimator.Update(5000, 9000, 0, Threshold, Frame);
+		Check(estimator.Samples() == 2, "the first update after a restart is only remembered");
+
+		Check(!estimator.Ready(Frame), "the estimator is not ready before the frame is filled");
+		estimator.Reset();
+		Check(estimator.Samples() == 0 && estimator.LagPercent() == 0, "reset forgets everything");
+	}
+} // namespace
+
+int main()
+{
+	TestConstantLag();
+	TestMatchesReference();
+	TestServerLoadAndSkip();
+
+	if (!failures)
+		std::printf("All lag estimator tests passed.\n");
+	return failures;
+}
@@ -0,0 +1,70 @@
+// Benchmark of merging per-client latency histograms into the server-wide one, as the getstats admin command does:
+//   g++ -std=c++20 -O2 -o latency_histogram_benchmark LatencyHistogramBenchmark.cpp
+//   ./latency_histogram_benchmark
+// Recording and percentile lookups are measured alongside for scale.
+
+#include "../LatencyHistogram.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Plugins::ConData;
+
+namespace
+{
+	constexpr int Clients = 255;
+	constexpr int Rounds = 2000;
+
+	double NanosecondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+} // namespace
+
+int main()
+{
+	std::mt19937 rng {1};
+	std::lognormal_distribution<double> latency {4.5, 0.8};
+
+	std::vector<LatencyHistogram> clients(Clients);
+	std::vector<uint32_t> samples(1 << 16);
+	for (auto& sample : samples)
+		sample = static_cast<uint32_t>(latency(rng));
+
+	auto start = std::chrono::steady_clock::now();
+	size_t recorded = 0;
+	for (auto& client : clients)
+	{
+		for (const uint32_t sample : samples)
+			client.Record(sample + static_cast<uint32_t>(recorded++ & 7));
+	}
+	const double record = NanosecondsSince(start) / static_cast<double>(recorded);
+
+	uint64_t checksum = 0;
+	start = std::chrono::steady_clock::now();
+	for (int round = 0; round < Rounds; round++)
+	{
+		LatencyHistogram server;
+		for (const auto& client : clients)
+			server.Merge(client);
+		checksum += server.Total();
+	}
+	const double merge = NanosecondsSince(start) / Rounds;
+
+	LatencyHistogram server;
+	for (const auto& client : clients)
+		server.Merge(client);
+	start = std::chrono::steady_clock::now();
+	for (int round = 0; round < Rounds; round++)
+		checksum += server.Percentile(50) + server.Percentile(95) + server.Percentile(99);
+	const double percentiles = NanosecondsSince(start) / Rounds;
+
+	std::printf("%u buckets, %zu bytes per histogram\n", LatencyHistogram::BucketCount, sizeof(LatencyHistogram));
+	std::printf("record                   %8.2f ns/sample\n", record);
+	std::printf("merge %d clients        %8.0f ns\n", Clients, merge);
+	std::printf("p50, p95 and p99         %8.0f ns\n", percentiles);
+	std::printf("checksum %llu\n", static_cast<unsigned long long>(checksum));
+	return 0;
+}
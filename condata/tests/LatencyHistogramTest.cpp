@@ -0,0 +1,161 @@
+// Tests for the ConData latency histogram: bucket boundaries, percentiles against exact ones, and merging:
+//   g++ -std=c++20 -O2 -o latency_histogram_test LatencyHistogramTest.cpp
+//   ./latency_histogram_test
+// Exits with the number of failed checks.
+
+#include "../LatencyHistogram.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Plugins::ConData;
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			failures++;
+		}
+	}
+
+	void TestBucketBoundaries()
+	{
+		using H = LatencyHistogram;
+
+		for (uint32_t value = 0; value < H::SubBuckets; value++)
+		{
+			if (H::BucketOf(value) != value || H::HighestValueOf(value) != value)
+			{
+				Check(false, "values below SubBuckets get a bucket of their own");
+				break;
+			}
+		}
+
+		Check(H::BucketOf(H::MaxTrackedValue) == H::BucketCount - 1, "the largest tracked value lands in the last bucket");
+		Check(H::HighestValueOf(H::BucketCount - 1) == H::MaxTrackedValue, "the last bucket ends at the largest tracked value");
+
+		bool contiguous = true;
+		bool contained = true;
+		bool precise = true;
+		for (uint32_t value = 1; value <= H::MaxTrackedValue; value++)
+		{
+			const uint32_t bucket = H::BucketOf(value);
+			const uint32_t previous = H::BucketOf(value - 1);
+
+			// Buckets follow each other without gaps, and a new bucket starts right after the previous one ends
+			if (bucket != previous && (bucket != previous + 1 || H::HighestValueOf(previous) != value - 1))
+				contiguous = false;
+
+			if (value > H::HighestValueOf(bucket))
+				contained = false;
+
+			// Reporting the top of the bucket is off by less than 1/SubBuckets of the value
+			if (H::HighestValueOf(bucket) - value >= std::max<uint32_t>(1, value / H::SubBuckets))
+				precise = false;
+		}
+
+		Check(contiguous, "buckets are contiguous");
+		Check(contained, "every value lies within its bucket");
+		Check(precise, "every value is recorded within 1/SubBuckets of itself");
+	}
+
+	void TestPercentiles()
+	{
+		LatencyHistogram empty;
+		Check(empty.Percentile(50) == 0 && empty.Max() == 0 && empty.Total() == 0, "an empty histogram reports 0");
+
+		LatencyHistogram single;
+		single.Record(123);
+		Check(single.Percentile(0) == 123 && single.Percentile(50) == 123 && single.Percentile(100) == 123, "a single sample is every percentile");
+
+		LatencyHistogram clamped;
+		clamped.Record(UINT32_MAX);
+		Check(clamped.Max() == LatencyHistogram::MaxTrackedValue && clamped.Percentile(99) == LatencyHistogram::MaxTrackedValue,
+		    "values above the tracked range are clamped");
+
+		std::mt19937 rng {2024};
+		std::lognormal_distribution<double> latency {4.5, 0.8};
+		std::vector<uint32_t> samples;
+		LatencyHistogram histogram;
+		for (int i = 0; i < 100000; i++)
+		{
+			const auto value = static_cast<uint32_t>(latency(rng));
+			samples.push_back(value);
+			histogram.Record(value);
+		}
+		std::sort(samples.begin(), samples.end());
+
+		bool accurate = true;
+		for (const double percentile : {1.0, 10.0, 50.0, 90.0, 95.0, 99.0, 99.9, 100.0})
+		{
+			const auto rank = std::max<size_t>(1, static_cast<size_t>(percentile / 100.0 * static_cast<double>(samples.size()) + 0.5));
+			const uint32_t exact = samples[rank - 1];
+			const uint32_t reported = histogram.Percentile(percentile);
+			if (reported < exact || reported - exact > std::max<uint32_t>(1, exact / LatencyHistogram::SubBuckets))
+			{
+				std::printf("  p%g: exact %u, reported %u\n", percentile, exact, reported);
+				accurate = false;
+			}
+		}
+		Check(accurate, "percentiles are at most one bucket above the exact percentile");
+		Check(histogram.Max() == samples.back() && histogram.Percentile(100) == samples.back(), "the maximum is exact");
+		Check(histogram.Total() == samples.size(), "every sample is counted");
+
+		histogram.Decay();
+		Check(histogram.Total() <= samples.size() / 2 + LatencyHistogram::BucketCount && histogram.Max() == samples.back(),
+		    "decay halves the counts and keeps the maximum");
+
+		histogram.Clear();
+		Check(histogram.Total() == 0 && histogram.Max() == 0 && histogram.Percentile(50) == 0, "clear forgets every sample");
+	}
+
+	void TestMerge()
+	{
+		std::mt19937 rng {7};
+		std::uniform_int_distribution<uint32_t> low {0, 200};
+		std::uniform_int_distribution<uint32_t> high {150, 5000};
+
+		LatencyHistogram first;
+		LatencyHistogram second;
+		LatencyHistogram combined;
+		for (int i = 0; i < 20000; i++)
+		{
+			const uint32_t a = low(rng);
+			const uint32_t b = high(rng);
+			first.Record(a);
+			second.Record(b);
+			combined.Record(a);
+			combined.Record(b);
+		}
+
+		LatencyHistogram merged = first;
+		merged.Merge(second);
+		bool same = merged.Total() == combined.Total() && merged.Max() == combined.Max();
+		for (double percentile = 0.5; percentile <= 100.0; percentile += 0.5)
+			same &= merged.Percentile(percentile) == combined.Percentile(percentile);
+		Check(same, "merging gives the same histogram as recording every sample into one");
+
+		LatencyHistogram withEmpty = first;
+		withEmpty.Merge(LatencyHistogram());
+		Check(withEmpty.Total() == first.Total() && withEmpty.Percentile(50) == first.Percentile(50) && withEmpty.Max() == first.Max(),
+		    "merging an empty histogram changes nothing");
+	}
+} // namespace
+
+int main()
+{
+	TestBucketBoundaries();
+	TestPercentiles();
+	TestMerge();
+
+	if (!failures)
+		std::printf("All latency histogram tests passed.\n");
+	return failures;
+}
@@ -0,0 +1,174 @@
+// Benchmark of the connection sample windows for 255 clients with 120 sample windows, against the std::list walks they replaced:
+//   g++ -std=c++20 -O2 -o sample_window_benchmark SampleWindowBenchmark.cpp ../SampleWindow.cpp
+//   ./sample_window_benchmark
+// Every tick each client gets a ping, a loss and an object update interval sample, and the average ping, ping fluctuation, average loss and
+// lag percentage are read, as the ping and loss timers and SPObjUpdate do. Both ways must give the same results.
+
+#include "../SampleWindow.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <list>
+#include <random>
+#include <vector>
+
+using namespace Plugins::ConData;
+
+namespace
+{
+	constexpr size_t Clients = 255;
+	constexpr uint32_t Frame = 120;
+	constexpr int Ticks = 2000;
+	constexpr uint32_t LagDetectionMin = 50;
+
+	struct Results
+	{
+		uint32_t averagePing = 0;
+		uint32_t pingFluctuation = 0;
+		uint32_t averageLoss = 0;
+		uint32_t lags = 0;
+
+		bool operator==(const Results&) const = default;
+	};
+
+	struct Samples
+	{
+		uint32_t ping;
+		uint32_t loss;
+		uint32_t interval;
+	};
+
+	//! The per-client lists and loops from before the windows
+	struct ListClient
+	{
+		std::list<uint32_t> pingList;
+		std::list<uint32_t> lossList;
+		std::list<uint32_t> objUpdateIntervalsList;
+		Results results;
+
+		void Update(const Samples& samples)
+		{
+			if (pingList.size() >= Frame)
+			{
+				uint32_t lastPing = 0;
+				results.averagePing = 0;
+				results.pingFluctuation = 0;
+				for (const auto& ping : pingList)
+				{
+					results.averagePing += ping;
+					if (lastPing != 0)
+						results.pingFluctuation += static_cast<uint32_t>(sqrt(pow(static_cast<float>(ping) - static_cast<float>(lastPing), 2)));
+					lastPing = ping;
+				}
+
+				results.pingFluctuation /= pingList.size();
+				results.averagePing /= pingList.size();
+			}
+			while (pingList.size() >= Frame)
+				pingList.pop_back();
+			pingList.push_front(samples.ping);
+
+			if (lossList.size() >= Frame)
+			{
+				results.averageLoss = 0;
+				for (const auto& loss : lossList)
+					results.averageLoss += loss;
+				results.averageLoss /= lossList.size();
+			}
+			while (lossList.size() >= Frame)
+				lossList.pop_back();
+			lossList.push_front(samples.loss);
+
+			if (objUpdateIntervalsList.size() >= Frame)
+			{
+				uint32_t lags = 0;
+				for (const auto& iv : objUpdateIntervalsList)
+				{
+					if (iv > LagDetectionMin)
+						lags++;
+				}
+
+				results.lags = (lags * 100) / Frame;
+				while (objUpdateIntervalsList.size() >= Frame)
+					objUpdateIntervalsList.pop_front();
+			}
+			objUpdateIntervalsList.push_back(samples.interval);
+		}
+	};
+
+	struct WindowClient
+	{
+		SampleWindow pingWindow;
+		SampleWindow lossWindow;
+		SampleWindow objUpdateWindow;
+		Results results;
+
+		WindowClient()
+		{
+			pingWindow.Configure(Frame);
+			lossWindow.Configure(Frame);
+			objUpdateWindow.Configure(Frame, LagDetectionMin);
+		}
+
+		void Update(const Samples& samples)
+		{
+			if (pingWindow.Size() >= Frame)
+			{
+				results.pingFluctuation = pingWindow.Fluctuation() / pingWindow.Size();
+				results.averagePing = pingWindow.Sum() / pingWindow.Size();
+			}
+			pingWindow.Push(samples.ping);
+
+			if (lossWindow.Size() >= Frame)
+				results.averageLoss = lossWindow.Sum() / lossWindow.Size();
+			lossWindow.Push(samples.loss);
+
+			if (objUpdateWindow.Size() >= Frame)
+				results.lags = (objUpdateWindow.CountAboveThreshold() * 100) / Frame;
+			objUpdateWindow.Push(samples.interval);
+		}
+	};
+
+	template<typename Client>
+	double NanosecondsPerClientTick(const std::vector<Samples>& samples, std::array<Client, Clients>& clients)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (int tick = 0; tick < Ticks; tick++)
+		{
+			for (size_t client = 0; client < Clients; client++)
+				clients[client].Update(samples[(tick * Clients + client) % samples.size()]);
+		}
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / (Ticks * Clients);
+	}
+} // namespace
+
+int main()
+{
+	std::mt19937 rng {13};
+	std::uniform_int_distribution<uint32_t> ping {0, 400};
+	std::uniform_int_distribution<uint32_t> loss {0, 30};
+	std::uniform_int_distribution<uint32_t> interval {0, 120};
+	std::vector<Samples> samples((1 << 16) + 1);
+	for (auto& sample : samples)
+		sample = {ping(rng) < 20 ? 0 : ping(rng), loss(rng), interval(rng)};
+
+	static std::array<ListClient, Clients> listClients;
+	static std::array<WindowClient, Clients> windowClients;
+	const double lists = NanosecondsPerClientTick(samples, listClients);
+	const double windows = NanosecondsPerClientTick(samples, windowClients);
+
+	size_t mismatches = 0;
+	for (size_t client = 0; client < Clients; client++)
+		mismatches += !(listClients[client].results == windowClients[client].results);
+
+	printf("%zu clients, %u sample windows\n", Clients, Frame);
+	printf("std::list walks: %8.1f ns per client tick\n", lists);
+	printf("sample windows:  %8.1f ns per client tick\n", windows);
+	printf("speedup:         %8.1fx\n", lists / windows);
+	if (mismatches)
+		printf("FAILED: %zu clients got different results\n", mismatches);
+	return mismatches != 0;
+}
@@ -50,6 +50,8 @@ namespace Plugins::DeathPenalty
 
 	void ClearClientInfo(ClientId& client)
 	{
+		if (!global->characterSettings.Unload(client))
+			AddLog(LogType::Normal, LogLevel::Err, std::format("Unable to write the character settings of client {}, retrying later", client));
 		global->MapClients.erase(client);
 	}
 
@@ -139,14 +141,15 @@ namespace Plugins::DeathPenalty
 		std::wstring dir = Hk::Client::GetAccountDirName(acc);
 		std::string scUserFile = CoreGlobals::c()->accPath + wstos(dir) + "\\flhookuser.ini";
 
-		// Get char filename and save setting to flhookuser.ini
+		// Get char filename and read the character's section of flhookuser.ini once
 		const auto wscFilename = Hk::Client::GetCharFileName(client);
 		std::string scFilename = wstos(wscFilename.value());
 		std::string scSection = "general_" + scFilename;
+		global->characterSettings.Load(client, scUserFile, scSection);
 
 		// read death penalty settings
 		CLIENT_DATA c;
-		c.bDisplayDPOnLaunch = IniGetB(scUserFile, scSection, "DPnotice", true);
+		c.bDisplayDPOnLaunch = global->characterSettings.GetBool(client, "DPnotice").value_or(true);
 		global->MapClients[client] = c;
 	}
 
@@ -230,20 +233,32 @@ namespace Plugins::DeathPenalty
 	}
 
 	/** @ingroup DeathPenalty
-	 * @brief This will save whether the player wants to receieve the /dp notice or not to the flhookuser.ini file
+	 * @brief This will save whether the player wants to receieve the /dp notice or not to the flhookuser.ini file once the settings are flushed
 	 */
-	void SaveDPNoticeToCharFile(ClientId client, const std::string& value)
+	void SaveDPNoticeToCharFile(ClientId client, bool value)
 	{
-		const CAccount* acc = Players.FindAccountFromClientID(client);
-		std::wstring dir = Hk::Client::GetAccountDirName(acc);
-		if (const auto file = Hk::Client::GetCharFileName(client); file.has_value())
-		{
-			std::string scUserFile = CoreGlobals::c()->accPath + wstos(dir) + "\\flhookuser.ini";
-			std::string scSection = "general_" + wstos(file.value());
-			IniWrite(scUserFile, scSection, "DPnotice", value);
-		}
+		global->characterSettings.SetBool(client, "DPnotice", value);
 	}
 
+	/** @ingroup DeathPenalty
+	 * @brief Writes the changed settings of every player to disk, so little is lost if the server goes down
+	 */
+	void FlushCharacterSettings()
+	{
+		for (const auto& file : global->characterSettings.FlushAll())
+			AddLog(LogType::Normal, LogLevel::Err, std::format("Unable to write character settings to {}, retrying later", file.string()));
+	}
+
+	/** @ingroup DeathPenalty
+	 * @brief Shutdown hook. Writes the death penalty notice settings still pending.
+	 */
+	void Shutdown()
+	{
+		FlushCharacterSettings();
+	}
+
+	const std::vector<Timer> timers = {{FlushCharacterSettings, 60}};
+
 	/** @ingroup DeathPenalty
 	 * @brief /dp command. Shows information about death penalty
 	 */
@@ -262,13 +277,13 @@ namespace Plugins::DeathPenalty
 			if (ToLower(Trim(param)) == L"off")
 			{
 				global->MapClients[client].bDisplayDPOnLaunch = false;
-				SaveDPNoticeToCharFile(client, "no");
+				SaveDPNoticeToCharFile(client, false);
 				PrintUserCmdText(client, L"Death penalty notices disabled.");
 			}
 			else if (ToLower(Trim(param)) == L"on")
 			{
 				global->MapClients[client].bDisplayDPOnLaunch = true;
-				SaveDPNoticeToCharFile(client, "yes");
+				SaveDPNoticeToCharFile(client, true);
 				PrintUserCmdText(client, L"Death penalty notices enabled.");
 			}
 			else
@@ -331,4 +346,6 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 	pi->emplaceHook(HookedCall::IServerImpl__PlayerLaunch, &PlayerLaunch);
 	pi->emplaceHook(HookedCall::FLHook__LoadCharacterSettings, &LoadUserCharSettings);
 	pi->emplaceHook(HookedCall::FLHook__ClearClientInfo, &ClearClientInfo, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__Shutdown, &Shutdown);
+	pi->timers(&timers);
 }
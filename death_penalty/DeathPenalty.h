@@ -3,6 +3,8 @@
 #include <FLHook.hpp>
 #include <plugin.h>
 
+#include "../common/CharacterSettings.h"
+
 namespace Plugins::DeathPenalty
 {
 	struct CLIENT_DATA
@@ -35,6 +37,9 @@ namespace Plugins::DeathPenalty
 
 		std::map<uint, CLIENT_DATA> MapClients;
 
+		//! The character's section of flhookuser.ini, read once on character load and written back on disconnect or by the flush timer
+		CharacterSettings::Cache characterSettings;
+
 		std::unique_ptr<Config> config = nullptr;
 
 		ReturnCode returncode = ReturnCode::Default;
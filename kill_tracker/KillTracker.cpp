@@ -203,7 +203,7 @@ namespace Plugins::KillTracker
 			std::wstring greatestDamageMessage = std::vformat(global->config->deathDamageTemplate, templateArgs);
 
 			greatestDamageMessage = Hk::Message::FormatMsg(MessageColor::Orange, MessageFormat::Normal, greatestDamageMessage);
-			Hk::Message::FMsgS(system, greatestDamageMessage);
+			global->broadcaster.ToSystem(system, Broadcast::Payload(greatestDamageMessage));
 		}
 
 		// Messages relating to kill streaks
@@ -226,7 +226,7 @@ namespace Plugins::KillTracker
 				std::wstring templateString = templateMessage->second;
 				killStreakMessage = std::vformat(templateString, templateArgs);
 				killStreakMessage = Hk::Message::FormatMsg(MessageColor::Orange, MessageFormat::Normal, killStreakMessage);
-				Hk::Message::FMsgS(system, killStreakMessage);
+				global->broadcaster.ToSystem(system, Broadcast::Payload(killStreakMessage));
 			}
 		}
 
@@ -245,7 +245,7 @@ namespace Plugins::KillTracker
 				std::wstring templateString = templateMessage->second;
 				milestoneMessage = std::vformat(templateString, templateArgs);
 				milestoneMessage = Hk::Message::FormatMsg(MessageColor::Orange, MessageFormat::Normal, milestoneMessage);
-				Hk::Message::FMsgS(system, milestoneMessage);
+				global->broadcaster.ToSystem(system, Broadcast::Payload(milestoneMessage));
 			}
 		}
 	}
@@ -255,6 +255,7 @@ namespace Plugins::KillTracker
 	 */
 	void Disconnect(ClientId& client, [[maybe_unused]] EFLConnection conn)
 	{
+		global->broadcaster.systems.Remove(client);
 		if (global->config->enableDamageTracking)
 		{
 			clearDamageTaken(client);
@@ -275,6 +276,7 @@ namespace Plugins::KillTracker
 	 */
 	void PlayerLaunch([[maybe_unused]] ShipId shipId, ClientId& client)
 	{
+		global->broadcaster.systems.Update(client);
 		if (global->config->enableDamageTracking)
 		{
 			clearDamageTaken(client);
@@ -292,6 +294,8 @@ namespace Plugins::KillTracker
 	 */
 	void CharacterSelect([[maybe_unused]] CHARACTER_ID const& cid, ClientId& client)
 	{
+		// The new character is filed under its system once it enters its base
+		global->broadcaster.systems.Remove(client);
 		if (global->config->enableDamageTracking)
 		{
 			clearDamageTaken(client);
@@ -299,6 +303,20 @@ namespace Plugins::KillTracker
 		}
 	}
 
+	/** @ingroup KillTracker
+	 * @brief Keep track of the system the player is in when they dock or jump, for the kill messages sent to a system
+	 */
+	void BaseEnter([[maybe_unused]] const uint& baseId, ClientId& client)
+	{
+		global->broadcaster.systems.Update(client);
+	}
+
+	void JumpInComplete([[maybe_unused]] const SystemId& system, const ShipId& ship)
+	{
+		if (const auto client = Hk::Client::GetClientIdByShip(ship); client.has_value())
+			global->broadcaster.systems.Update(client.value());
+	}
+
 	const std::vector commands = {{
 	    CreateUserCommand(L"/kills", L"[playerName]", UserCmd_Kills, L"Displays how many pvp kills you (or player you named) have."),
 	}};
@@ -310,6 +328,7 @@ namespace Plugins::KillTracker
 	{
 		auto config = Serializer::JsonToObject<Config>();
 		global->config = std::make_unique<Config>(config);
+		global->broadcaster.systems.Rebuild();
 		for (auto& subArray : global->damageArray)
 			subArray.fill(0.0f);
 		for (auto const& killStreakTemplate : global->config->killStreakTemplates) 
@@ -346,4 +365,6 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 	pi->emplaceHook(HookedCall::IServerImpl__DisConnect, &Disconnect);
 	pi->emplaceHook(HookedCall::IServerImpl__PlayerLaunch, &PlayerLaunch);
 	pi->emplaceHook(HookedCall::IServerImpl__CharacterSelect, &CharacterSelect);
+	pi->emplaceHook(HookedCall::IServerImpl__BaseEnter, &BaseEnter, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__JumpInComplete, &JumpInComplete, HookStep::After);
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <FLHook.hpp>
 #include <plugin.h>
 
+#include "../common/Broadcast.h"
+
 namespace Plugins::KillTracker
 {
 	//! Struct to hold the Kill Streaks
@@ -58,5 +60,7 @@ namespace Plugins::KillTracker
 		std::map<ClientId, uint> killStreaks;
 		std::map<int, std::wstring> killStreakTemplates;
 		std::map<int, std::wstring> milestoneTemplates;
+		//! Sends the kill messages, encoded once, to everyone in the system
+		Broadcast::Broadcaster broadcaster;
 	};
 } // namespace Plugins::KillTracker
@@ -0,0 +1,114 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Header-only and dependent on the standard library alone, so it can be built and exercised outside the server.
+namespace Plugins::Message
+{
+	//! The chat channels a message can be submitted to, each limited separately
+	enum class ChatChannel : uint8_t
+	{
+		Universe,
+		System,
+		Local,
+		Group,
+		Private,
+		Count
+	};
+
+	//! What a token bucket decided about a message
+	enum class ChatVerdict : uint8_t
+	{
+		Allowed,
+		//! Dropped, and the first message dropped on the channel since the client last got a message through on it
+		FloodStarted,
+		Dropped
+	};
+
+	//! Token bucket per client and channel. Every message costs a token, a bucket holds up to burst tokens and refills at perMinute tokens a
+	//! minute. State is a fixed array indexed by client, so checking a message never allocates.
+	template<size_t MaxClients>
+	class ChatLimiter final
+	{
+	  public:
+		static constexpr size_t ChannelCount = static_cast<size_t>(ChatChannel::Count);
+
+		//! Sets the limit of a channel. A burst of 0 leaves the channel unlimited.
+		void Configure(ChatChannel channel, uint32_t burst, uint32_t perMinute)
+		{
+			rates[Index(channel)] = {burst, perMinute};
+			for (auto& client : buckets)
+				client[Index(channel)] = {};
+		}
+
+		[[nodiscard]] ChatVerdict Check(size_t client, ChatChannel channel, uint64_t nowInMs)
+		{
+			const Rate& rate = rates[Index(channel)];
+			if (!rate.burst || client >= MaxClients)
+				return ChatVerdict::Allowed;
+
+			// Tokens are kept in 1/60000ths, so refilling perMinute tokens a minute adds perMinute for every elapsed millisecond
+			const uint64_t capacity = static_cast<uint64_t>(rate.burst) * TokenScale;
+			Bucket& bucket = buckets[client][Index(channel)];
+			if (!bucket.primed)
+				bucket = {capacity, nowInMs, true, false};
+			else if (nowInMs > bucket.lastRefillInMs)
+			{
+				const uint64_t refill = (nowInMs - bucket.lastRefillInMs) * rate.perMinute;
+				bucket.tokens = capacity - bucket.tokens > refill ? bucket.tokens + refill : capacity;
+				bucket.lastRefillInMs = nowInMs;
+			}
+
+			if (bucket.tokens >= TokenScale)
+			{
+				bucket.tokens -= TokenScale;
+				bucket.flooding = false;
+				return ChatVerdict::Allowed;
+			}
+
+			dropped[Index(channel)]++;
+			if (bucket.flooding)
+				return ChatVerdict::Dropped;
+
+			bucket.flooding = true;
+			return ChatVerdict::FloodStarted;
+		}
+
+		//! Forgets the buckets of a client, for when they disconnect
+		void Reset(size_t client)
+		{
+			if (client >= MaxClients)
+				return;
+
+			buckets[client] = {};
+		}
+
+		//! How many messages were dropped on a channel since the plugin was loaded
+		[[nodiscard]] uint64_t Dropped(ChatChannel channel) const { return dropped[Index(channel)]; }
+
+	  private:
+		static constexpr uint64_t TokenScale = 60000;
+
+		struct Rate
+		{
+			uint32_t burst = 0;
+			uint32_t perMinute = 0;
+		};
+
+		struct Bucket
+		{
+			uint64_t tokens = 0;
+			uint64_t lastRefillInMs = 0;
+			bool primed = false;
+			//! Set while messages on the channel are being dropped
+			bool flooding = false;
+		};
+
+		static constexpr size_t Index(ChatChannel channel) { return static_cast<size_t>(channel); }
+
+		std::array<Rate, ChannelCount> rates {};
+		std::array<std::array<Bucket, ChannelCount>, MaxClients> buckets {};
+		std::array<uint64_t, ChannelCount> dropped {};
+	};
+} // namespace Plugins::Message
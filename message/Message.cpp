@@ -24,7 +24,9 @@
  * - time - Prints the current server time.
  *
  * @paragraph adminCmds Admin Commands
- * There are no admin commands in this plugin.
+ * All commands are prefixed with '.' unless explicitly specified.
+ * - broadcaststats - Shows how many bytes of banners and system messages were encoded and how many were sent.
+ * - chatstats - Shows how many chat messages flood control dropped on each channel.
  *
  * @paragraph configuration Configuration
  * @code
@@ -36,12 +38,19 @@
  *     "EnableMe": true,
  *     "EnableSetMessage": false,
  *     "GreetingBannerLines": ["<TRA data="0xDA70D608" mask="-1"/><TEXT>Welcome to the server.</TEXT>"],
+ *     "GroupChatLimit": {"Burst": 0, "PerMinute": 0},
+ *     "LocalChatLimit": {"Burst": 0, "PerMinute": 0},
+ *     "PrivateChatLimit": {"Burst": 0, "PerMinute": 0},
  *     "SpecialBannerLines": ["<TRA data="0x40B60000" mask="-1"/><TEXT>This is a special banner.</TEXT>"],
  *     "SpecialBannerTimeout": 5,
  *     "StandardBannerLines": ["<TRA data="0x40B60000" mask="-1"/><TEXT>Here is a standard banner.</TEXT>"],
  *     "StandardBannerTimeout": 60,
  *     "SuppressMistypedCommands": true,
- *     "SwearWords": [""]
+ *     "SwearWords": [""],
+ *     "SwearWordsIgnoreSeparators": false,
+ *     "SwearWordsNormalizeLeetspeak": false,
+ *     "SystemChatLimit": {"Burst": 0, "PerMinute": 0},
+ *     "UniverseChatLimit": {"Burst": 0, "PerMinute": 0}
  * }
  * @endcode
  *
@@ -73,14 +82,40 @@ namespace Plugins::Message
 	 */
 	static void LoadMsgs(ClientId client)
 	{
-		// Load from disk the messages.
+		// Read the character's section of flhookuser.ini once, every setting after that is served from memory
+		auto& info = global->info[client];
+		const CAccount* acc = Players.FindAccountFromClientID(client);
+		const auto fileName = Hk::Client::GetCharFileName(client);
+		if (!acc || !fileName.has_value())
+		{
+			// The client still gets its slot, as if the character had nothing saved
+			info.slots.fill(L"");
+			info.showChatTime = false;
+			return;
+		}
+
+		auto& settings = global->characterSettings;
+		settings.Load(client, CoreGlobals::c()->accPath + wstos(Hk::Client::GetAccountDirName(acc)) + "\\flhookuser.ini", "general_" + wstos(fileName.value()));
+
+		// Messages saved before they moved to flhookuser.ini are read from the character file one last time and written back with the next flush
+		if (!settings.GetBool(client, "msg.migrated").value_or(false))
+		{
+			for (int msgSlot = 0; msgSlot < NumberOfSlots; msgSlot++)
+			{
+				if (const auto msg = Hk::Ini::GetCharacterIniString(client, L"msg." + std::to_wstring(msgSlot)); !msg.empty())
+					settings.SetWString(client, "msg." + std::to_string(msgSlot), msg);
+			}
+			settings.SetBool(client, "msg.chat_time", Hk::Ini::GetCharacterIniBool(client, L"msg.chat_time"));
+			settings.SetBool(client, "msg.migrated", true);
+		}
+
 		for (int msgSlot = 0; msgSlot < NumberOfSlots; msgSlot++)
 		{
-			global->info[client].slots[msgSlot] = Hk::Ini::GetCharacterIniString(client, L"msg." + std::to_wstring(msgSlot));
+			info.slots[msgSlot] = settings.GetWString(client, "msg." + std::to_string(msgSlot)).value_or(L"");
 		}
 
 		// Chat time settings.
-		global->info[client].showChatTime = Hk::Ini::GetCharacterIniBool(client, L"msg.chat_time");
+		info.showChatTime = settings.GetBool(client, "msg.chat_time").value_or(false);
 	}
 
 	/** @ingroup Message
@@ -102,6 +137,9 @@ namespace Plugins::Message
 	 */
 	static void PlayerLogin([[maybe_unused]] const std::string_view& charFilename, ClientId& client)
 	{
+		if (const auto charName = (const wchar_t*)Players.GetActiveCharacterName(client))
+			global->onlinePlayers.Add(client, charName);
+		global->broadcaster.systems.Update(client);
 		LoadMsgs(client);
 		ShowGreetingBanner(client);
 	}
@@ -111,18 +149,8 @@ namespace Plugins::Message
 	 */
 	static void ShowSpecialBanner()
 	{
-		PlayerData* playerData = nullptr;
-		while ((playerData = Players.traverse_active(playerData)))
-		{
-			ClientId client = playerData->iOnlineId;
-			for (const auto& line : global->config->specialBannerLines)
-			{
-				if (line.find(L"<TRA") == 0)
-					Hk::Message::FMsg(client, line);
-				else
-					PrintUserCmdText(client, line);
-			}
-		}
+		for (const auto& payload : global->specialBanner)
+			global->broadcaster.ToAll(payload);
 	}
 
 	/** @ingroup Message
@@ -130,23 +158,14 @@ namespace Plugins::Message
 	 */
 	static void ShowStandardBanner()
 	{
-		if (global->config->standardBannerLines.empty())
+		if (global->standardBanners.empty())
 			return;
 
 		static size_t curStandardBanner = 0;
-		if (++curStandardBanner >= global->config->standardBannerLines.size())
+		if (++curStandardBanner >= global->standardBanners.size())
 			curStandardBanner = 0;
 
-		PlayerData* playerData = nullptr;
-		while ((playerData = Players.traverse_active(playerData)))
-		{
-			ClientId client = playerData->iOnlineId;
-
-			if (global->config->standardBannerLines[curStandardBanner].find(L"<TRA") == 0)
-				Hk::Message::FMsg(client, global->config->standardBannerLines[curStandardBanner]);
-			else
-				PrintUserCmdText(client, global->config->standardBannerLines[curStandardBanner].c_str());
-		}
+		global->broadcaster.ToAll(global->standardBanners[curStandardBanner]);
 	}
 
 	/** @ingroup Message
@@ -285,19 +304,63 @@ namespace Plugins::Message
 	 */
 	void ClearClientInfo(ClientId& client)
 	{
+		if (!global->characterSettings.Unload(client))
+			AddLog(LogType::Normal, LogLevel::Err, std::format("Unable to write the character settings of client {}, retrying later", client));
+		global->onlinePlayers.Remove(client);
+		global->broadcaster.systems.Remove(client);
 		global->info.erase(client);
 	}
 
+	/** @ingroup Message
+	 * @brief Keep track of the system the player is in when they launch, dock or jump, for system-wide messages.
+	 */
+	void PlayerLaunch([[maybe_unused]] const uint& ship, ClientId& client)
+	{
+		global->broadcaster.systems.Update(client);
+	}
+
+	void BaseEnter([[maybe_unused]] const uint& baseId, ClientId& client)
+	{
+		global->broadcaster.systems.Update(client);
+	}
+
+	void JumpInComplete([[maybe_unused]] const SystemId& system, const ShipId& ship)
+	{
+		if (const auto client = Hk::Client::GetClientIdByShip(ship); client.has_value())
+			global->broadcaster.systems.Update(client.value());
+	}
+
 	/** @ingroup Message
 	 * @brief This function is called when the admin command rehash is called and when the module is loaded.
 	 */
 	void LoadSettings()
 	{
 		// For every active player load their msg settings.
+		global->onlinePlayers.Clear();
 		for (const auto& p : Hk::Admin::GetPlayers())
+		{
+			global->onlinePlayers.Add(p.client, p.character);
 			LoadMsgs(p.client);
+		}
+
+		global->broadcaster.systems.Rebuild();
 
 		auto config = Serializer::JsonToObject<Config>();
+		global->swearWordMatcher.Compile(config.swearWords, {config.swearWordsNormalizeLeetspeak, config.swearWordsIgnoreSeparators});
+
+		global->chatLimiter.Configure(ChatChannel::Universe, config.universeChatLimit.burst, config.universeChatLimit.perMinute);
+		global->chatLimiter.Configure(ChatChannel::System, config.systemChatLimit.burst, config.systemChatLimit.perMinute);
+		global->chatLimiter.Configure(ChatChannel::Local, config.localChatLimit.burst, config.localChatLimit.perMinute);
+		global->chatLimiter.Configure(ChatChannel::Group, config.groupChatLimit.burst, config.groupChatLimit.perMinute);
+		global->chatLimiter.Configure(ChatChannel::Private, config.privateChatLimit.burst, config.privateChatLimit.perMinute);
+
+		// Banners are encoded once here and the same bytes are sent to every player each time they are shown
+		global->standardBanners.clear();
+		for (const auto& line : config.standardBannerLines)
+			global->standardBanners.emplace_back(Broadcast::Payload::FromLine(line));
+		global->specialBanner.clear();
+		for (const auto& line : config.specialBannerLines)
+			global->specialBanner.emplace_back(Broadcast::Payload::FromLine(line));
 		global->config = std::make_unique<Config>(config);
 	}
 
@@ -319,7 +382,24 @@ namespace Plugins::Message
 		}
 	}
 
-	const std::vector<Timer> timers = {{OneSecondTimer, 1}};
+	/** @ingroup Message
+	 * @brief Writes the changed settings of every player to disk, so little is lost if the server goes down
+	 */
+	void FlushCharacterSettings()
+	{
+		for (const auto& file : global->characterSettings.FlushAll())
+			AddLog(LogType::Normal, LogLevel::Err, std::format("Unable to write character settings to {}, retrying later", file.string()));
+	}
+
+	/** @ingroup Message
+	 * @brief Shutdown hook. Writes the settings still pending before the server goes down.
+	 */
+	void Shutdown()
+	{
+		FlushCharacterSettings();
+	}
+
+	const std::vector<Timer> timers = {{OneSecondTimer, 1}, {FlushCharacterSettings, 60}};
 
 	/** @ingroup Message
 	 * @brief On client disconnect remove any references to this client.
@@ -335,6 +415,9 @@ namespace Plugins::Message
 				iter->second.targetClientId = -1;
 			++iter;
 		}
+		global->onlinePlayers.Remove(client);
+		global->broadcaster.systems.Remove(client);
+		global->chatLimiter.Reset(client);
 		global->info.erase(client);
 	}
 
@@ -374,7 +457,52 @@ namespace Plugins::Message
 	}
 
 	/** @ingroup Message
-	 * @brief Hook on SubmitChat. Suppresses swearing. Records the last user to PM.
+	 * @brief The channel a chat message is submitted to, for flood control. Returns nothing for submissions that are not chat.
+	 */
+	static std::optional<ChatChannel> GetChatChannel(uint cIdTo)
+	{
+		switch (cIdTo)
+		{
+			case 0x10000: return ChatChannel::Universe;
+			case 0x10001: return ChatChannel::System;
+			case 0x10002: return ChatChannel::Local;
+			case 0x10003: return ChatChannel::Group;
+			default: break;
+		}
+
+		if (cIdTo > 0 && cIdTo < 0x10000)
+			return ChatChannel::Private;
+		return std::nullopt;
+	}
+
+	/** @ingroup Message
+	 * @brief Warns a player about what they said in chat. Each offence has its own warning count, and a player who has been warned too often is
+	 * tempbanned. Returns true if the player was tempbanned.
+	 */
+	static bool WarnChatOffence(ClientId client, int& warnings, const std::wstring& warning, const std::wstring& offence, const std::wstring& details)
+	{
+		PrintUserCmdText(client, L"This is an automated message.");
+		PrintUserCmdText(client, warning);
+
+		if (++warnings <= 2)
+			return false;
+
+		const std::wstring charname = reinterpret_cast<const wchar_t*>(Players.GetActiveCharacterName(client));
+		AddLog(LogType::Kick,
+		    LogLevel::Info,
+		    wstos(std::format(L"{} tempban on {} ({}) reason='{}'",
+		        offence,
+		        charname,
+		        Hk::Client::GetAccountID(Hk::Client::GetAccountByCharName(charname).value()).value(),
+		        details)));
+
+		TempBanManager::i()->AddTempBan(
+		    client, global->config->swearingTempBanDuration, std::format(L"{} tempban for {} minutes.", offence, global->config->swearingTempBanDuration));
+		return true;
+	}
+
+	/** @ingroup Message
+	 * @brief Hook on SubmitChat. Drops chat floods, suppresses swearing. Records the last user to PM.
 	 */
 	bool SubmitChat(const ClientId& client, const unsigned long& msgSize, const void** rdlReader, const uint& cIdTo, const int [[maybe_unused]])
 	{
@@ -382,6 +510,25 @@ namespace Plugins::Message
 		if (cIdTo == 0x10004)
 			return false;
 
+		// Flood control comes before anything else, so a flood never costs more than this check
+		if (const auto channel = GetChatChannel(cIdTo); channel.has_value())
+		{
+			const auto now = static_cast<uint64_t>(
+			    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+			if (const auto verdict = global->chatLimiter.Check(client, channel.value(), now); verdict != ChatVerdict::Allowed)
+			{
+				global->returncode = ReturnCode::SkipAll;
+				// Floods are counted apart from swearing, so a flood never brings a swearing tempban closer
+				if (verdict == ChatVerdict::FloodStarted)
+					WarnChatOffence(client,
+					    global->info[client].floodWarnings,
+					    L"You are sending messages too fast, please slow down or you may be sanctioned.",
+					    L"Flooding",
+					    L"chat flood");
+				return true;
+			}
+		}
+
 		// Extract text from rdlReader
 		BinaryRDLReader rdl;
 		wchar_t wszBuf[1024];
@@ -393,38 +540,19 @@ namespace Plugins::Message
 		if (const bool isGroup = (cIdTo == 0x10003 || !chatMsg.find(L"/g ") || !chatMsg.find(L"/group ")); !isGroup)
 		{
 			// If a restricted word appears in the message take appropriate action.
-			for (const auto& word : global->config->swearWords)
+			if (global->swearWordMatcher.Matches(chatMsg))
 			{
-				if (chatMsg.find(word) != -1)
+				auto& warnings = global->info[client].swearWordWarnings;
+				if (WarnChatOffence(client, warnings, L"Please do not swear or you may be sanctioned.", L"Swearing", chatMsg) &&
+				    global->config->disconnectSwearingInSpaceRange > 0.0f)
 				{
-					PrintUserCmdText(client, L"This is an automated message.");
-					PrintUserCmdText(client, L"Please do not swear or you may be sanctioned.");
-
-					global->info[client].swearWordWarnings++;
-					if (global->info[client].swearWordWarnings > 2)
-					{
-						const std::wstring charname = reinterpret_cast<const wchar_t*>(Players.GetActiveCharacterName(client));
-						AddLog(LogType::Kick,
-						    LogLevel::Info,
-						    wstos(std::format(L"Swearing tempban on {} ({}) reason='{}'",
-						        charname,
-						        Hk::Client::GetAccountID(Hk::Client::GetAccountByCharName(charname).value()).value(),
-						        chatMsg.c_str())));
-
-						TempBanManager::i()->AddTempBan(client,
-						    global->config->swearingTempBanDuration,
-						    std::format(L"Swearing tempban for {} minutes.", global->config->swearingTempBanDuration));
-
-						if (global->config->disconnectSwearingInSpaceRange > 0.0f)
-						{
-							std::wstring msg = global->config->disconnectSwearingInSpaceMsg;
-							msg = ReplaceStr(msg, L"%time", GetTimeString(FLHookConfig::i()->messages.dieMsg));
-							msg = ReplaceStr(msg, L"%player", charname);
-							PrintLocalUserCmdText(client, msg, global->config->disconnectSwearingInSpaceRange);
-						}
-					}
-					return true;
+					const std::wstring charname = reinterpret_cast<const wchar_t*>(Players.GetActiveCharacterName(client));
+					std::wstring msg = global->config->disconnectSwearingInSpaceMsg;
+					msg = ReplaceStr(msg, L"%time", GetTimeString(FLHookConfig::i()->messages.dieMsg));
+					msg = ReplaceStr(msg, L"%player", charname);
+					PrintLocalUserCmdText(client, msg, global->config->disconnectSwearingInSpaceRange);
 				}
+				return true;
 			}
 		}
 
@@ -447,20 +575,7 @@ namespace Plugins::Message
 	 */
 	void RedText(const std::wstring& XMLMsg, uint systemId)
 	{
-		char szBuf[0x1000];
-		uint iRet;
-		if (const auto err = Hk::Message::FMsgEncodeXML(XMLMsg, szBuf, sizeof(szBuf), iRet); err.has_error())
-			return;
-
-		// Send to all players in system
-		PlayerData* playerData = nullptr;
-		while ((playerData = Players.traverse_active(playerData)))
-		{
-			ClientId client = playerData->iOnlineId;
-
-			if (SystemId iClientSystemId = Hk::Player::GetSystem(client).value(); systemId == iClientSystemId)
-				Hk::Message::FMsgSendChat(client, szBuf, iRet);
-		}
+		global->broadcaster.ToSystem(systemId, Broadcast::Payload(XMLMsg));
 	}
 
 	/** @ingroup Message
@@ -497,11 +612,17 @@ namespace Plugins::Message
 
 		if (global->info[client].showChatTime)
 		{
-			// Send time with gray color (BEBEBE) in small text (90) above the chat
-			// line.
+			// Send time with gray color (BEBEBE) in small text (90) above the chat line. The line is encoded once a second and the same bytes are
+			// sent to every player that has chat time on, rather than formatted and encoded for each of them.
+			if (const auto now = std::time(nullptr); now != global->chatTimeSecond)
+			{
+				global->chatTimeLine =
+				    Broadcast::Payload(L"<TRA data=\"0xBEBEBE90\" mask=\"-1\"/><TEXT>" + XMLText(GetTimeString(FLHookConfig::i()->messages.dieMsg)) + L"</TEXT>");
+				global->chatTimeSecond = now;
+			}
+
 			global->sendingTime = true;
-			Hk::Message::FMsg(
-			    client, L"<TRA data=\"0xBEBEBE90\" mask=\"-1\"/><TEXT>" + XMLText(GetTimeString(FLHookConfig::i()->messages.dieMsg)) + L"</TEXT>");
+			global->chatTimeLine.SendTo(client);
 			global->sendingTime = false;
 		}
 		return false;
@@ -528,7 +649,7 @@ namespace Plugins::Message
 			return;
 		}
 
-		Hk::Ini::SetCharacterIni(client, L"msg." + std::to_wstring(msgSlot), ViewToWString(msg));
+		global->characterSettings.SetWString(client, "msg." + std::to_string(msgSlot), msg);
 
 		// Update the character cache
 		global->info[client].slots[msgSlot] = msg;
@@ -713,15 +834,16 @@ namespace Plugins::Message
 			return;
 		}
 
-		if (!Hk::Client::GetAccountByCharName(targetCharname))
+		// Online characters are resolved from the index, only offline ones need their account looked up
+		const auto clientId = global->onlinePlayers.Find(targetCharname);
+		if (!clientId)
 		{
-			PrintUserCmdText(client, L"ERR charname does not exist");
-			return;
-		}
+			if (!Hk::Client::GetAccountByCharName(targetCharname))
+			{
+				PrintUserCmdText(client, L"ERR charname does not exist");
+				return;
+			}
 
-		const auto clientId = Hk::Client::GetClientIdFromCharName(targetCharname);
-		if (clientId.has_error())
-		{
 			MailManager::MailItem item;
 			item.author = wstos(charname);
 			item.subject = "Private Message";
@@ -775,17 +897,13 @@ namespace Plugins::Message
 
 		bool bSenderReceived = false;
 		bool bMsgSent = false;
-		for (const auto& player : Hk::Admin::GetPlayers())
-		{
-			if (ToLower(player.character).find(ToLower(charnamePrefix)) == std::string::npos)
-				continue;
-
-			if (player.client == client)
+		global->onlinePlayers.ForEachContaining(charnamePrefix, [&](uint player) {
+			if (player == client)
 				bSenderReceived = true;
 
-			Hk::Message::FormatSendChat(player.client, sender, ViewToWString(msg), L"FF7BFF");
+			Hk::Message::FormatSendChat(player, sender, ViewToWString(msg), L"FF7BFF");
 			bMsgSent = true;
-		}
+		});
 		if (!bSenderReceived)
 			Hk::Message::FormatSendChat(client, sender, ViewToWString(msg), L"FF7BFF");
 
@@ -812,7 +930,7 @@ namespace Plugins::Message
 
 		std::wstring charname = (const wchar_t*)Players.GetActiveCharacterName(client);
 
-		Hk::Ini::SetCharacterIni(client, L"msg.chat_time", bShowChatTime ? L"true" : L"false");
+		global->characterSettings.SetBool(client, "msg.chat_time", bShowChatTime);
 
 		// Update the client cache.
 		if (const auto iter = global->info.find(client); iter != global->info.end())
@@ -877,6 +995,58 @@ namespace Plugins::Message
 		}
 	}
 
+	/** @ingroup Message
+	 * @brief Admin command to show how much encoding broadcasting banners and system messages saved
+	 */
+	void AdminCmd_BroadcastStats(CCmds* cmds)
+	{
+		const auto& counters = global->broadcaster.GetCounters();
+		cmds->Print(std::format("broadcasts={} recipients={} bytesRendered={} bytesSent={}",
+		    counters.broadcasts,
+		    counters.recipients,
+		    counters.bytesRendered,
+		    counters.bytesSent));
+		cmds->Print("OK");
+	}
+
+	/** @ingroup Message
+	 * @brief Admin command to show how many chat messages flood control dropped on each channel
+	 */
+	void AdminCmd_ChatStats(CCmds* cmds)
+	{
+		const auto& limiter = global->chatLimiter;
+		cmds->Print(std::format("dropped universe={} system={} local={} group={} private={}",
+		    limiter.Dropped(ChatChannel::Universe),
+		    limiter.Dropped(ChatChannel::System),
+		    limiter.Dropped(ChatChannel::Local),
+		    limiter.Dropped(ChatChannel::Group),
+		    limiter.Dropped(ChatChannel::Private)));
+		cmds->Print("OK");
+	}
+
+	void CmdHelp_Callback(CCmds* classptr)
+	{
+		classptr->Print("broadcaststats");
+		classptr->Print("chatstats");
+	}
+
+	bool ExecuteCommandString_Callback(CCmds* cmds, const std::wstring& cmd)
+	{
+		if (cmd == L"broadcaststats")
+		{
+			global->returncode = ReturnCode::SkipAll;
+			AdminCmd_BroadcastStats(cmds);
+			return true;
+		}
+		else if (cmd == L"chatstats")
+		{
+			global->returncode = ReturnCode::SkipAll;
+			AdminCmd_ChatStats(cmds);
+			return true;
+		}
+		return false;
+	}
+
 	// Client command processing
 	const std::vector commands = {{
 	    CreateUserCommand(L"/setmsg", L"<n> <msg text>", UserCmd_SetMsg, L"Sets a preset message."),
@@ -913,9 +1083,12 @@ namespace Plugins::Message
 } // namespace Plugins::Message
 
 using namespace Plugins::Message;
+REFL_AUTO(type(ChatFloodLimit), field(burst), field(perMinute))
 REFL_AUTO(type(Config), field(greetingBannerLines), field(specialBannerLines), field(standardBannerLines), field(specialBannerTimeout),
     field(standardBannerTimeout), field(customHelp), field(suppressMistypedCommands), field(enableSetMessage), field(enableMe), field(enableDo),
-    field(disconnectSwearingInSpaceMsg), field(disconnectSwearingInSpaceRange), field(swearWords), field(swearingTempBanDuration))
+    field(disconnectSwearingInSpaceMsg), field(disconnectSwearingInSpaceRange), field(swearWords), field(swearingTempBanDuration),
+    field(swearWordsNormalizeLeetspeak), field(swearWordsIgnoreSeparators), field(universeChatLimit), field(systemChatLimit), field(localChatLimit),
+    field(groupChatLimit), field(privateChatLimit))
 
 DefaultDllMainSettings(LoadSettings);
 
@@ -935,5 +1108,12 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 	pi->emplaceHook(HookedCall::IServerImpl__SetTarget, &SetTarget);
 	pi->emplaceHook(HookedCall::IServerImpl__DisConnect, &DisConnect);
 	pi->emplaceHook(HookedCall::FLHook__ClearClientInfo, &ClearClientInfo, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__Shutdown, &Shutdown);
 	pi->emplaceHook(HookedCall::IServerImpl__CharacterSelect, &PlayerLogin, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__PlayerLaunch, &PlayerLaunch, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__BaseEnter, &BaseEnter, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__JumpInComplete, &JumpInComplete, HookStep::After);
+	pi->emplaceHook(HookedCall::FLHook__AdminCommand__Process, &ExecuteCommandString_Callback);
+	pi->emplaceHook(HookedCall::FLHook__AdminCommand__Help, &CmdHelp_Callback);
+	pi->timers(&timers);
 }
\ No newline at end of file
@@ -3,6 +3,12 @@
 #include <FLHook.hpp>
 #include <plugin.h>
 
+#include "ChatLimiter.h"
+#include "WordMatcher.h"
+#include "../common/Broadcast.h"
+#include "../common/CharacterSettings.h"
+#include "../common/PlayerIndex.h"
+
 namespace Plugins::Message
 {
 	//! Number of auto message slots
@@ -31,6 +37,20 @@ namespace Plugins::Message
 
 		//! Swear word warn level
 		int swearWordWarnings = 0;
+
+		//! Chat flood warn level, kept apart from the swearing warnings
+		int floodWarnings = 0;
+	};
+
+	//! How many chat messages a player may send on a channel before further messages are dropped
+	struct ChatFloodLimit final : Reflectable
+	{
+		//! Messages that can be sent in a row. 0 leaves the channel unlimited.
+		uint burst = 0;
+		//! Messages a minute the allowance refills by
+		uint perMinute = 0;
+		ChatFloodLimit(uint burstParam, uint perMinuteParam) : burst(burstParam), perMinute(perMinuteParam) {}
+		ChatFloodLimit() = default;
 	};
 
 	//! Config data for this plugin
@@ -80,6 +100,19 @@ namespace Plugins::Message
 
 		//! Vector of swear words
 		std::vector<std::wstring> swearWords;
+
+		//! Also match swear words with digits and symbols in place of letters, e.g. "sh1t"
+		bool swearWordsNormalizeLeetspeak = false;
+
+		//! Also match swear words split up by whitespace or punctuation, e.g. "s h.i-t"
+		bool swearWordsIgnoreSeparators = false;
+
+		//! Flood limits per chat channel, all unlimited unless configured. Messages over the limit are dropped, repeated floods lead to a tempban.
+		ChatFloodLimit universeChatLimit;
+		ChatFloodLimit systemChatLimit;
+		ChatFloodLimit localChatLimit;
+		ChatFloodLimit groupChatLimit;
+		ChatFloodLimit privateChatLimit;
 	};
 
 	//! Global data for this plugin
@@ -91,8 +124,29 @@ namespace Plugins::Message
 		//! Cache of preset messages for the online players (by client Id)
 		std::map<uint, ClientInfo> info;
 
+		//! The character's section of flhookuser.ini, read once on character select and written back on disconnect or by the flush timer
+		CharacterSettings::Cache characterSettings;
+
+		//! The characters that are online by name, maintained on character select and disconnect
+		PlayerIndex::Index onlinePlayers;
+
+		//! Chat flood control, checked before anything else is done with a message
+		ChatLimiter<MaxClientId + 1> chatLimiter;
+
+		//! Sends banners and system messages, encoded once, to every recipient
+		Broadcast::Broadcaster broadcaster;
+		std::vector<Broadcast::Payload> standardBanners;
+		std::vector<Broadcast::Payload> specialBanner;
+
 		//! This parameter is sent when we send a chat time line so that we don't print a time chat line recursively.
 		bool sendingTime = false;
+
+		//! The encoded chat time line and the second it shows, so it is encoded once a second however many players see it
+		Broadcast::Payload chatTimeLine;
+		std::time_t chatTimeSecond = 0;
+
+		//! The swear words compiled on load, so each chat message is scanned once whatever the number of words
+		WordMatcher swearWordMatcher;
 	};
 
 //! A random macro to make things easier
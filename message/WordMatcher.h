@@ -0,0 +1,191 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cwctype>
+#include <deque>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Header-only and dependent on the standard library alone, so it can be built and exercised outside the server.
+namespace Plugins::Message
+{
+	//! How WordMatcher normalises words and text before matching them
+	struct WordMatcherOptions
+	{
+		//! Reads digits and symbols commonly used in place of letters as those letters, e.g. "sh1t" as "shit"
+		bool normalizeLeetspeak = false;
+		//! Skips whitespace and the punctuation commonly used to split up a word, e.g. "s h.i-t" reads as "shit"
+		bool ignoreSeparators = false;
+	};
+
+	//! Aho-Corasick automaton over case-folded UTF-16 that finds whether any of a set of words appears in a text in a single pass
+	class WordMatcher final
+	{
+	  public:
+		//! Builds the automaton. Empty words, or words that consist only of skipped characters, are ignored.
+		void Compile(const std::vector<std::wstring>& words, WordMatcherOptions compileOptions = {})
+		{
+			options = compileOptions;
+			nodes.clear();
+			edges.clear();
+			rootTable.fill(0);
+
+			// Build the trie with ordered maps first, then flatten it into sorted edge ranges
+			std::vector<std::map<wchar_t, uint32_t>> trie(1);
+			std::vector<bool> terminal(1, false);
+			for (const auto& word : words)
+			{
+				uint32_t state = 0;
+				bool empty = true;
+				for (const wchar_t raw : word)
+				{
+					const wchar_t c = Normalize(raw);
+					if (!c)
+						continue;
+
+					empty = false;
+					auto [edge, inserted] = trie[state].try_emplace(c, static_cast<uint32_t>(trie.size()));
+					if (inserted)
+					{
+						trie.emplace_back();
+						terminal.emplace_back(false);
+					}
+					state = edge->second;
+				}
+
+				if (!empty)
+					terminal[state] = true;
+			}
+
+			nodes.resize(trie.size());
+			for (uint32_t i = 0; i < trie.size(); i++)
+			{
+				nodes[i].firstEdge = static_cast<uint32_t>(edges.size());
+				for (const auto& [c, next] : trie[i])
+					edges.push_back({c, next});
+				nodes[i].edgeCount = static_cast<uint32_t>(trie[i].size());
+				nodes[i].terminal = terminal[i];
+			}
+
+			for (const auto& edge : Edges(0))
+			{
+				if (static_cast<uint32_t>(edge.c) < rootTable.size())
+					rootTable[edge.c] = edge.next;
+			}
+
+			// Breadth first, so every failure link points at a node whose own links are already final
+			std::deque<uint32_t> queue;
+			for (const auto& edge : Edges(0))
+				queue.push_back(edge.next);
+
+			while (!queue.empty())
+			{
+				const uint32_t state = queue.front();
+				queue.pop_front();
+				for (const auto& edge : Edges(state))
+				{
+					uint32_t fallback = nodes[state].failure;
+					while (fallback && !Child(fallback, edge.c))
+						fallback = nodes[fallback].failure;
+
+					const uint32_t failure = Child(fallback, edge.c);
+					nodes[edge.next].failure = failure != edge.next ? failure : 0;
+					nodes[edge.next].terminal = nodes[edge.next].terminal || nodes[nodes[edge.next].failure].terminal;
+					queue.push_back(edge.next);
+				}
+			}
+		}
+
+		//! Whether any compiled word appears in the text
+		[[nodiscard]] bool Matches(std::wstring_view text) const
+		{
+			if (nodes.size() <= 1)
+				return false;
+
+			uint32_t state = 0;
+			for (const wchar_t raw : text)
+			{
+				const wchar_t c = Normalize(raw);
+				if (!c)
+					continue;
+
+				uint32_t next;
+				while (!(next = Child(state, c)) && state)
+					state = nodes[state].failure;
+
+				state = next;
+				if (nodes[state].terminal)
+					return true;
+			}
+			return false;
+		}
+
+		//! Folds a character to lower case, or returns 0 for a character that is skipped under the current options
+		[[nodiscard]] wchar_t Normalize(wchar_t c) const
+		{
+			if (options.ignoreSeparators && (std::iswspace(c) || c == L'.' || c == L'-' || c == L'_' || c == L'*' || c == L','))
+				return 0;
+
+			if (options.normalizeLeetspeak)
+			{
+				switch (c)
+				{
+					case L'0': return L'o';
+					case L'1':
+					case L'!': return L'i';
+					case L'3': return L'e';
+					case L'4':
+					case L'@': return L'a';
+					case L'5':
+					case L'$': return L's';
+					case L'7': return L't';
+					default: break;
+				}
+			}
+
+			if (c >= L'A' && c <= L'Z')
+				return static_cast<wchar_t>(c + (L'a' - L'A'));
+			if (c < 0x80)
+				return c;
+			return static_cast<wchar_t>(std::towlower(static_cast<wint_t>(c)));
+		}
+
+	  private:
+		struct Edge
+		{
+			wchar_t c;
+			uint32_t next;
+		};
+
+		struct Node
+		{
+			uint32_t firstEdge = 0;
+			uint32_t edgeCount = 0;
+			uint32_t failure = 0;
+			bool terminal = false;
+		};
+
+		[[nodiscard]] std::span<const Edge> Edges(uint32_t state) const { return {edges.data() + nodes[state].firstEdge, nodes[state].edgeCount}; }
+
+		//! The node reached from state over c, 0 if there is no such edge
+		[[nodiscard]] uint32_t Child(uint32_t state, wchar_t c) const
+		{
+			if (!state && static_cast<uint32_t>(c) < rootTable.size())
+				return rootTable[c];
+
+			const auto range = Edges(state);
+			const auto edge = std::lower_bound(range.begin(), range.end(), c, [](const Edge& e, wchar_t value) { return e.c < value; });
+			return edge != range.end() && edge->c == c ? edge->next : 0;
+		}
+
+		WordMatcherOptions options;
+		std::vector<Node> nodes;
+		std::vector<Edge> edges;
+		//! Root transitions for ASCII, which covers almost every first character
+		std::array<uint32_t, 128> rootTable {};
+	};
+} // namespace Plugins::Message
@@ -0,0 +1,169 @@
+// Microbenchmark of the /set chattime line in a busy system where every chat line is delivered to 100 recipients, formatting and encoding
+// the line for every recipient against the cached line that is encoded once a second:
+//   g++ -std=c++20 -O2 -o chat_time_benchmark ChatTimeBenchmark.cpp
+//   ./chat_time_benchmark
+// GetTimeString, XMLText and FMsgEncodeXML are modelled with the standard library so it builds outside the server. The encoder parses the
+// TRA and TEXT elements into a small render list, as the server's XML reader does. Sending copies the encoded bytes.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <cwchar>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+	constexpr int Recipients = 100;
+	constexpr int ChatLines = 20000;
+
+	std::wstring GetTimeString(bool localTime)
+	{
+		const std::time_t now = std::time(nullptr);
+		std::tm time {};
+		if (localTime)
+			localtime_r(&now, &time);
+		else
+			gmtime_r(&now, &time);
+
+		wchar_t buffer[32];
+		std::wcsftime(buffer, std::size(buffer), L"%d.%m.%Y %H:%M:%S", &time);
+		return buffer;
+	}
+
+	std::wstring XMLText(const std::wstring& text)
+	{
+		std::wstring escaped;
+		for (const wchar_t c : text)
+		{
+			switch (c)
+			{
+				case L'<': escaped += L"&#60;"; break;
+				case L'>': escaped += L"&#62;"; break;
+				case L'&': escaped += L"&#38;"; break;
+				default: escaped += c; break;
+			}
+		}
+		return escaped;
+	}
+
+	//! Turns <TRA data="..." mask="..."/> into a style record and the <TEXT> contents into UTF-16 text records
+	bool FMsgEncodeXML(const std::wstring& xml, char* buffer, size_t bufferSize, size_t& size)
+	{
+		size = 0;
+		const auto write = [&](const void* data, size_t length) {
+			if (size + length > bufferSize)
+				return false;
+			memcpy(buffer + size, data, length);
+			size += length;
+			return true;
+		};
+
+		for (size_t pos = 0; pos < xml.size();)
+		{
+			if (xml.compare(pos, 4, L"<TRA") == 0)
+			{
+				const size_t data = xml.find(L"data=\"", pos);
+				const size_t end = xml.find(L"/>", pos);
+				if (data == std::wstring::npos || end == std::wstring::npos)
+					return false;
+
+				const uint32_t type = 1;
+				const uint32_t style = static_cast<uint32_t>(std::wcstoul(xml.c_str() + data + 6, nullptr, 16));
+				if (!write(&type, sizeof(type)) || !write(&style, sizeof(style)))
+					return false;
+				pos = end + 2;
+			}
+			else if (xml.compare(pos, 6, L"<TEXT>") == 0)
+			{
+				const size_t end = xml.find(L"</TEXT>", pos);
+				if (end == std::wstring::npos)
+					return false;
+
+				const uint32_t type = 2;
+				const uint32_t length = static_cast<uint32_t>(end - pos - 6);
+				if (!write(&type, sizeof(type)) || !write(&length, sizeof(length)))
+					return false;
+				for (size_t i = pos + 6; i < end; i++)
+				{
+					const auto c = static_cast<uint16_t>(xml[i]);
+					if (!write(&c, sizeof(c)))
+						return false;
+				}
+				pos = end + 7;
+			}
+			else
+				return false;
+		}
+		return true;
+	}
+
+	//! Stand-in for FMsgSendChat, which copies the encoded line into the outgoing packet
+	uint64_t bytesSent = 0;
+	void FMsgSendChat(const char* data, size_t size)
+	{
+		char packet[0x1000];
+		memcpy(packet, data, size);
+		bytesSent += size + static_cast<uint8_t>(packet[0]);
+	}
+
+	//! What SendChat did for every recipient before the line was cached
+	void SendFormatted()
+	{
+		const std::wstring xml = L"<TRA data=\"0xBEBEBE90\" mask=\"-1\"/><TEXT>" + XMLText(GetTimeString(true)) + L"</TEXT>";
+		char buffer[0x1000];
+		size_t size;
+		if (FMsgEncodeXML(xml, buffer, sizeof(buffer), size))
+			FMsgSendChat(buffer, size);
+	}
+
+	//! The line encoded once a second and shared by every recipient
+	std::vector<char> chatTimeLine;
+	std::time_t chatTimeSecond = 0;
+
+	void SendCached()
+	{
+		if (const auto now = std::time(nullptr); now != chatTimeSecond)
+		{
+			const std::wstring xml = L"<TRA data=\"0xBEBEBE90\" mask=\"-1\"/><TEXT>" + XMLText(GetTimeString(true)) + L"</TEXT>";
+			char buffer[0x1000];
+			size_t size;
+			chatTimeLine.clear();
+			if (FMsgEncodeXML(xml, buffer, sizeof(buffer), size))
+				chatTimeLine.assign(buffer, buffer + size);
+			chatTimeSecond = now;
+		}
+
+		FMsgSendChat(chatTimeLine.data(), chatTimeLine.size());
+	}
+
+	template<typename Send>
+	double NanosecondsPerDelivery(Send&& send)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (int line = 0; line < ChatLines; line++)
+		{
+			for (int recipient = 0; recipient < Recipients; recipient++)
+				send();
+		}
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / (ChatLines * Recipients);
+	}
+} // namespace
+
+int main()
+{
+	const double formatted = NanosecondsPerDelivery(SendFormatted);
+	const uint64_t formattedBytes = bytesSent;
+	bytesSent = 0;
+	const double cached = NanosecondsPerDelivery(SendCached);
+
+	printf("%d chat lines to %d recipients each\n", ChatLines, Recipients);
+	printf("formatted per recipient: %8.1f ns per delivered line\n", formatted);
+	printf("cached once a second:    %8.1f ns per delivered line\n", cached);
+	printf("speedup:                 %8.1fx\n", formatted / cached);
+	return formattedBytes == 0 || bytesSent == 0;
+}
@@ -0,0 +1,101 @@
+// Benchmark of matching 200 character chat messages against 2,000 swear words, with the compiled automaton and with the per-word search
+// SubmitChat used to run:
+//   g++ -std=c++20 -O2 -o word_matcher_benchmark WordMatcherBenchmark.cpp
+//   ./word_matcher_benchmark
+// The old path lowercases the message and calls find for every word. Most chat is clean, which is the old path's worst case.
+
+#include "../WordMatcher.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace Plugins::Message;
+
+namespace
+{
+	constexpr int WordCount = 2000;
+	constexpr size_t MessageLength = 200;
+	constexpr int MessageCount = 2000;
+
+	std::wstring ToLower(std::wstring text)
+	{
+		for (auto& c : text)
+			c = static_cast<wchar_t>(std::towlower(static_cast<wint_t>(c)));
+		return text;
+	}
+
+	//! What SubmitChat did before the automaton
+	bool FindEachWord(const std::vector<std::wstring>& words, const std::wstring& message)
+	{
+		const std::wstring chatMsg = ToLower(message);
+		for (const auto& word : words)
+		{
+			if (chatMsg.find(word) != std::wstring::npos)
+				return true;
+		}
+		return false;
+	}
+
+	template<typename Match>
+	double MicrosecondsPerMessage(const std::vector<std::wstring>& messages, Match&& match, size_t& matched)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (const auto& message : messages)
+			matched += match(message);
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		return std::chrono::duration<double, std::micro>(elapsed).count() / static_cast<double>(messages.size());
+	}
+} // namespace
+
+int main()
+{
+	std::mt19937 rng {18};
+	const auto randomWord = [&rng](size_t minLength, size_t maxLength) {
+		std::wstring word(std::uniform_int_distribution<size_t> {minLength, maxLength}(rng), L'a');
+		for (auto& c : word)
+			c = static_cast<wchar_t>(L'a' + std::uniform_int_distribution<int> {0, 25}(rng));
+		return word;
+	};
+
+	std::vector<std::wstring> words(WordCount);
+	for (auto& word : words)
+		word = randomWord(5, 10);
+
+	// Chat made of short words in mixed case, with a swear word in one message out of fifty
+	std::vector<std::wstring> messages(MessageCount);
+	for (size_t i = 0; i < messages.size(); i++)
+	{
+		auto& message = messages[i];
+		while (message.size() < MessageLength)
+		{
+			auto word = randomWord(2, 7);
+			word[0] = static_cast<wchar_t>(std::towupper(static_cast<wint_t>(word[0])));
+			message += word + L' ';
+		}
+		if (i % 50 == 0)
+			message.replace(MessageLength / 2, words[i % words.size()].size(), words[i % words.size()]);
+		message.resize(MessageLength);
+	}
+
+	WordMatcher matcher;
+	const auto compileStart = std::chrono::steady_clock::now();
+	matcher.Compile(words);
+	const double compileTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - compileStart).count();
+
+	size_t foundMatches = 0;
+	size_t compiledMatches = 0;
+	const double found = MicrosecondsPerMessage(
+	    messages, [&words](const std::wstring& message) { return FindEachWord(words, message); }, foundMatches);
+	const double compiled = MicrosecondsPerMessage(
+	    messages, [&matcher](const std::wstring& message) { return matcher.Matches(message); }, compiledMatches);
+
+	printf("%d words, %zu character messages, %zu of %d messages matched\n", WordCount, MessageLength, compiledMatches, MessageCount);
+	printf("compiling the automaton: %9.2f ms\n", compileTime);
+	printf("find for every word:     %9.2f us per message\n", found);
+	printf("automaton:               %9.2f us per message\n", compiled);
+	printf("speedup:                 %9.1fx\n", found / compiled);
+	if (foundMatches != compiledMatches)
+		printf("FAILED: the automaton matched %zu messages, finding every word %zu\n", compiledMatches, foundMatches);
+	return foundMatches != compiledMatches;
+}
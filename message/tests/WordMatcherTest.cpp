@@ -0,0 +1,132 @@
+// Tests of the swear word matcher, checked against a brute force search over the normalised text:
+//   g++ -std=c++20 -O2 -o word_matcher_test WordMatcherTest.cpp
+//   ./word_matcher_test
+// Exits with the number of failed checks.
+
+#include "../WordMatcher.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+using namespace Plugins::Message;
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			failures++;
+		}
+	}
+
+	bool Matches(const std::vector<std::wstring>& words, std::wstring_view text, WordMatcherOptions options = {})
+	{
+		WordMatcher matcher;
+		matcher.Compile(words, options);
+		return matcher.Matches(text);
+	}
+
+	//! Normalises the text and every word the way the matcher does, then searches for each word in turn
+	bool BruteForce(const WordMatcher& matcher, const std::vector<std::wstring>& words, std::wstring_view text)
+	{
+		const auto normalize = [&matcher](std::wstring_view raw) {
+			std::wstring normalized;
+			for (const wchar_t c : raw)
+			{
+				if (const wchar_t folded = matcher.Normalize(c))
+					normalized += folded;
+			}
+			return normalized;
+		};
+
+		const std::wstring normalizedText = normalize(text);
+		return std::ranges::any_of(words, [&](const std::wstring& word) {
+			const std::wstring normalizedWord = normalize(word);
+			return !normalizedWord.empty() && normalizedText.find(normalizedWord) != std::wstring::npos;
+		});
+	}
+
+	void TestBasics()
+	{
+		const std::vector<std::wstring> words = {L"darn", L"heck", L"Blast"};
+		Check(Matches(words, L"oh darn it"), "a word in the middle of the text matches");
+		Check(Matches(words, L"heck"), "a word that is the whole text matches");
+		Check(Matches(words, L"what the HECK"), "matching ignores case in the text");
+		Check(Matches(words, L"blast"), "matching ignores case in the words");
+		Check(!Matches(words, L"nothing to see here"), "clean text does not match");
+		Check(!Matches(words, L"dar n"), "a split word does not match unless separators are ignored");
+		Check(!Matches(words, L""), "empty text does not match");
+		Check(!Matches({}, L"darn"), "no words never match");
+		Check(!Matches({L"", L"..."}, L"anything", {false, true}), "empty words and words of only separators are ignored");
+	}
+
+	void TestOverlaps()
+	{
+		// Words that are prefixes, suffixes or inside each other exercise the failure links
+		const std::vector<std::wstring> words = {L"he", L"she", L"hers", L"his"};
+		Check(Matches(words, L"ushers"), "overlapping words match");
+		Check(Matches({L"abcd", L"bc"}, L"xbcx"), "a word inside a longer word matches on its own");
+		Check(Matches({L"abcd", L"bce"}, L"abce"), "a failed longer word falls back to a word sharing its suffix");
+		Check(!Matches({L"aab"}, L"aaac"), "a repeated prefix without the end does not match");
+		Check(Matches({L"aab"}, L"aaab"), "a repeated prefix followed by the end matches");
+	}
+
+	void TestOptions()
+	{
+		const std::vector<std::wstring> words = {L"shit"};
+		Check(!Matches(words, L"sh1t"), "leetspeak does not match by default");
+		Check(Matches(words, L"sh1t", {true, false}), "leetspeak matches when normalised");
+		Check(Matches(words, L"$H!7", {true, false}), "symbols and digits are read as letters when normalised");
+		Check(!Matches(words, L"s h.i-t"), "separators are not skipped by default");
+		Check(Matches(words, L"s h.i-t", {false, true}), "separators are skipped when ignored");
+		Check(Matches(words, L"5 h-1 7", {true, true}), "both options combine");
+	}
+
+	void TestAgainstBruteForce()
+	{
+		// A tiny alphabet makes overlapping words and partial matches common
+		std::mt19937 rng {18};
+		const std::wstring alphabet = L"abAB1 .-";
+		const auto randomString = [&](size_t minLength, size_t maxLength) {
+			std::wstring s(std::uniform_int_distribution<size_t> {minLength, maxLength}(rng), L' ');
+			for (auto& c : s)
+				c = alphabet[std::uniform_int_distribution<size_t> {0, alphabet.size() - 1}(rng)];
+			return s;
+		};
+
+		size_t mismatches = 0;
+		for (int round = 0; round < 2000; round++)
+		{
+			std::vector<std::wstring> words(std::uniform_int_distribution<size_t> {1, 6}(rng));
+			for (auto& word : words)
+				word = randomString(1, 5);
+
+			const WordMatcherOptions options {(round & 1) != 0, (round & 2) != 0};
+			WordMatcher matcher;
+			matcher.Compile(words, options);
+			for (int text = 0; text < 10; text++)
+			{
+				const std::wstring message = randomString(0, 24);
+				mismatches += matcher.Matches(message) != BruteForce(matcher, words, message);
+			}
+		}
+		Check(mismatches == 0, "the automaton agrees with a brute force search on random words and texts");
+	}
+} // namespace
+
+int main()
+{
+	TestBasics();
+	TestOverlaps();
+	TestOptions();
+	TestAgainstBruteForce();
+
+	if (!failures)
+		std::printf("All word matcher tests passed.\n");
+	return failures;
+}
@@ -12,11 +12,17 @@
  * @paragraph adminCmds Admin Commands
  * All commands are prefixed with '.' unless explicitly specified.
  * - printminezones - Prints all the configured mining zones.
+ * - minestats - Prints how many mining hits produced ore and how many cargo deliveries were made for them.
+ * - minerate [charname|dump] - Prints the mining hit rate and hit interval histogram of a character, or writes those of every online miner to
+ * MiningRates.json.
  *
  * @paragraph configuration Configuration
  * @code
  * {
  *     "GenericFactor": 1.0,
+ *     "MaxMiningBurst": 8,
+ *     "MaxMiningRate": 2.0,
+ *     "OreDeliveryIntervalInSeconds": 2,
  *     "PlayerBonus": [
  *         {
  *             "Ammo": [
@@ -34,6 +40,8 @@
  *         }
  *     ],
  *     "PluginDebug": 0,
+ *     "RandomSeed": 0,
+ *     "ZoneCacheDistance": 500.0,
  *     "ZoneBonus": [
  *         {
  *             "Bonus": 0.0,
@@ -60,55 +68,6 @@ namespace Plugins::MiningControl
 {
 	const std::unique_ptr<Global> global = std::make_unique<Global>();
 
-	/** @ingroup MiningControl
-	 * @brief Return true if the cargo list contains the specified good.
-	 */
-	static bool ContainsEquipment(const std::list<CARGO_INFO>& cargoList, uint archId)
-	{
-		return std::ranges::any_of(cargoList, [archId](const CARGO_INFO& c) { return c.bMounted && c.iArchId == archId; });
-	}
-
-	/** @ingroup MiningControl
-	 * @brief Return the factor to modify a mining loot drop by.
-	 */
-	static float GetBonus(uint reputation, uint shipId, const std::list<CARGO_INFO>& cargoList, uint lootId)
-	{
-		if (!global->PlayerBonus.size())
-			return 0.0f;
-
-		// Get all player bonuses for this commodity.
-		auto start = global->PlayerBonus.lower_bound(lootId);
-		auto end = global->PlayerBonus.upper_bound(lootId);
-		for (; start != end; start++)
-		{
-			// Check for matching reputation if reputation is required.
-			if (start->second.RepId != -1 && reputation != start->second.RepId)
-				continue;
-
-			// Check for matching ship.
-			if (std::ranges::find(start->second.ShipIds, shipId) == start->second.ShipIds.end())
-				continue;
-
-			// Check that every simple item in the equipment list is present and
-			// mounted.
-			bool bEquipMatch = true;
-			for (auto item : start->second.ItemIds)
-			{
-				if (!ContainsEquipment(cargoList, item))
-				{
-					bEquipMatch = false;
-					break;
-				}
-			}
-
-			// This is a match.
-			if (bEquipMatch)
-				return start->second.Bonus;
-		}
-
-		return 0.0f;
-	}
-
 	/** @ingroup MiningControl
 	 * @brief Check if the client qualifies for bonuses
 	 */
@@ -144,23 +103,43 @@ namespace Plugins::MiningControl
 				}
 			}
 
+			// Collect the mounted equipment once, sorted so each bonus' item list can be matched in a single pass
+			std::vector<uint> mountedEquipment;
+			for (const auto& cargo : lstCargo.value())
+			{
+				if (cargo.bMounted)
+					mountedEquipment.emplace_back(cargo.iArchId);
+			}
+			std::ranges::sort(mountedEquipment);
+
 			// Check the player bonus list and if this player has the right ship and
 			// equipment then record the bonus and the weapon types that can be used
-			// to gather the ore.
-			global->Clients[client].LootBonus.clear();
-			global->Clients[client].LootAmmo.clear();
-			global->Clients[client].LootShip.clear();
-			for (const auto& [lootId, playerBonus] : global->PlayerBonus)
+			// to gather the ore. The first matching bonus for each commodity wins.
+			ClientData& cd = global->Clients[client];
+			cd.LootBonus.clear();
+			cd.LootAmmo.clear();
+			cd.LootShip.clear();
+			if (const auto bonuses = global->PlayerBonusByShip.find(shipId); bonuses != global->PlayerBonusByShip.end())
 			{
-				float bonus = GetBonus(repGroupId, shipId, lstCargo.value(), lootId);
-				if (bonus > 0.0f)
+				for (const auto& playerBonus : bonuses->second)
 				{
-					global->Clients[client].LootBonus[lootId] = bonus;
-					global->Clients[client].LootAmmo[lootId] = playerBonus.AmmoIds;
-					global->Clients[client].LootShip[lootId] = playerBonus.ShipIds;
+					// Check for matching reputation if reputation is required.
+					if (playerBonus.RepId != UINT_MAX && repGroupId != playerBonus.RepId)
+						continue;
+
+					if (cd.LootBonus.contains(playerBonus.LootId))
+						continue;
+
+					// Check that every simple item in the equipment list is present and mounted.
+					if (!std::ranges::includes(mountedEquipment, playerBonus.ItemIds))
+						continue;
+
+					cd.LootBonus[playerBonus.LootId] = playerBonus.Bonus;
+					cd.LootAmmo[playerBonus.LootId] = playerBonus.AmmoIds;
+					cd.LootShip[playerBonus.LootId] = playerBonus.ShipIds;
 					if (global->config->PluginDebug > 1)
 					{
-						Console::ConInfo(std::format("client={} LootId={} Bonus={}\n", client, lootId, bonus));
+						Console::ConInfo(std::format("client={} LootId={} Bonus={}\n", client, playerBonus.LootId, playerBonus.Bonus));
 					}
 				}
 			}
@@ -172,40 +151,196 @@ namespace Plugins::MiningControl
 	}
 
 	/** @ingroup MiningControl
-	 * @brief Timer hook to update mining stats to file
+	 * @brief Returns the slot of a zone in the dense zone bonus array. Zones without a configured bonus get a default entry the first time they are seen.
 	 */
-	void UpdateStatsFile()
+	uint GetZoneSlot(uint zoneId)
 	{
-		MiningStats stats;
-		// Recharge the fields
-		for (auto& [_, zoneBonus] : global->ZoneBonus)
+		if (const auto slot = global->ZoneSlots.find(zoneId); slot != global->ZoneSlots.end())
+			return slot->second;
+
+		const auto slot = static_cast<uint>(global->ZoneBonus.size());
+		global->ZoneBonus.emplace_back();
+		global->ZoneIds.emplace_back(zoneId);
+		global->ZoneSlots[zoneId] = slot;
+		return slot;
+	}
+
+	/** @ingroup MiningControl
+	 * @brief Returns the lootable zone the client is mining in. The result is cached per client and only looked up again once they have moved
+	 * ZoneCacheDistance away from where it was resolved or changed system.
+	 */
+	const Universe::IZone* ResolveMiningZone(ClientData& cd, SystemId system, const Vector& position)
+	{
+		if (cd.ZoneCacheValid && cd.CachedSystem == system)
 		{
-			zoneBonus.CurrentReserve += zoneBonus.RechargeRate;
-			if (zoneBonus.CurrentReserve > zoneBonus.MaxReserve)
-				zoneBonus.CurrentReserve = zoneBonus.MaxReserve;
+			const float dx = position.x - cd.CachedPosition.x;
+			const float dy = position.y - cd.CachedPosition.y;
+			const float dz = position.z - cd.CachedPosition.z;
+			if (dx * dx + dy * dy + dz * dz < global->config->ZoneCacheDistance * global->config->ZoneCacheDistance)
+				return cd.CachedZone;
+		}
+
+		cd.ZoneCacheValid = true;
+		cd.CachedSystem = system;
+		cd.CachedPosition = position;
+		cd.CachedZone = nullptr;
+
+		CmnAsteroid::CAsteroidSystem* csys = CmnAsteroid::Find(system);
+		if (!csys)
+			return nullptr;
+
+		// Find asteroid field that matches the best.
+		for (CmnAsteroid::CAsteroidField* cfield = csys->FindFirst(); cfield; cfield = csys->FindNext())
+		{
+			try
+			{
+				const Universe::IZone* zone = cfield->get_lootable_zone(position);
+				if (cfield->near_field(position) && zone && zone->lootableZone)
+				{
+					cd.CachedZone = zone;
+					cd.CachedZoneSlot = GetZoneSlot(zone->iZoneId);
+					break;
+				}
+			}
+			catch (...)
+			{
+			}
+		}
 
+		return cd.CachedZone;
+	}
+
+	/** @ingroup MiningControl
+	 * @brief Timer hook to hand the reserves of zones mined since the last flush to the reserve log writer
+	 */
+	void FlushReserveLog()
+	{
+		if (global->DirtyZones.empty() || !global->ReserveLogWriter)
+			return;
+
+		std::vector<ReserveLog::Entry> entries;
+		entries.reserve(global->DirtyZones.size());
+		for (const auto slot : global->DirtyZones)
+		{
+			const auto& zoneBonus = global->ZoneBonus[slot];
+			entries.push_back({global->ZoneIds[slot], zoneBonus.CurrentReserve, zoneBonus.Mined});
+		}
+		global->DirtyZones.clear();
+
+		global->ReserveLogWriter->Append(std::move(entries));
+	}
+
+	/** @ingroup MiningControl
+	 * @brief Returns the current state of every zone in the form stored in the mining stats file
+	 */
+	MiningStats BuildMiningStats()
+	{
+		MiningStats stats;
+		for (const auto& zoneBonus : global->ZoneBonus)
+		{
 			ZoneStats zs;
 			zs.CurrentReserve = zoneBonus.CurrentReserve;
 			zs.Mined = zoneBonus.Mined;
 			zs.Zone = zoneBonus.Zone;
 			stats.Stats.emplace_back(zs);
 		}
-		Serializer::SaveToJson(stats);
+		return stats;
+	}
+
+	/** @ingroup MiningControl
+	 * @brief Timer hook to recharge the fields and compact the reserve log into the mining stats file. The file is written by the reserve log writer thread.
+	 */
+	void UpdateStatsFile()
+	{
+		// Recharge the fields
+		for (auto& zoneBonus : global->ZoneBonus)
+		{
+			zoneBonus.CurrentReserve += zoneBonus.RechargeRate;
+			if (zoneBonus.CurrentReserve > zoneBonus.MaxReserve)
+				zoneBonus.CurrentReserve = zoneBonus.MaxReserve;
+		}
+
+		// Log the zones mined since the last flush, so they are kept even if the snapshot cannot be written
+		FlushReserveLog();
+
+		if (global->ReserveLogWriter)
+		{
+			global->ReserveLogWriter->Compact([stats = BuildMiningStats()]() mutable { return JsonFile::Save(stats); });
+		}
+		else if (auto stats = BuildMiningStats(); !JsonFile::Save(stats))
+		{
+			AddLog(LogType::Normal, LogLevel::Err, "Unable to write the mining stats file.");
+		}
+	}
+
+	/** @ingroup MiningControl
+	 * @brief Adds all ore pending for the client to their hold
+	 */
+	void DeliverPendingOre(ClientId client)
+	{
+		ClientData& cd = global->Clients[client];
+		for (const auto& [lootId, count] : cd.PendingLoot)
+		{
+			Hk::Player::AddCargo(client, lootId, count, false);
+			global->OreDeliveries++;
+		}
+
+		cd.PendingLoot.clear();
+		cd.HoldRemainingKnown = false;
+	}
+
+	/** @ingroup MiningControl
+	 * @brief Timer hook to deliver pending ore every OreDeliveryIntervalInSeconds
+	 */
+	void DeliverOreTimer()
+	{
+		if (!global->config || ++global->SecondsSinceOreDelivery < global->config->OreDeliveryIntervalInSeconds)
+			return;
+
+		global->SecondsSinceOreDelivery = 0;
+		for (ClientId client = 0; client <= MaxClientId; client++)
+		{
+			if (!global->Clients[client].PendingLoot.empty())
+				DeliverPendingOre(client);
+		}
+	}
+
+	/** @ingroup MiningControl
+	 * @brief Shutdown hook. Logs the zones mined in the last second and stops the reserve log writer on the game thread.
+	 */
+	void Shutdown()
+	{
+		FlushReserveLog();
+		if (global->ReserveLogWriter)
+			global->ReserveLogWriter->Stop();
 	}
 
-	const std::vector<Timer> timers = {{UpdateStatsFile, 60}};
+	const std::vector<Timer> timers = {{UpdateStatsFile, 60}, {FlushReserveLog, 1}, {DeliverOreTimer, 1}};
+
+	/** @ingroup MiningControl
+	 * @brief Milliseconds on the steady clock, which the mining rate is measured against
+	 */
+	int64_t GetMonotonicTimeInMs()
+	{
+		return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
 
 	/** @ingroup MiningControl
 	 * @brief Clear client info when a client connects.
 	 */
 	void ClearClientInfo(const uint& client)
 	{
+		// The character is gone by now, so ore still pending has nowhere to go. It is delivered on disconnect and docking.
+		global->Clients[client].PendingLoot.clear();
+		global->Clients[client].HoldRemainingKnown = false;
 		global->Clients[client].Setup = false;
 		global->Clients[client].LootBonus.clear();
 		global->Clients[client].LootAmmo.clear();
 		global->Clients[client].Debug = 0;
-		global->Clients[client].MineAsteroidEvents = 0;
-		global->Clients[client].MineAsteroidSampleStart = 0;
+		global->Clients[client].MiningRate.Reset();
+		global->Clients[client].LastRateWarningInMs = 0;
+		global->Clients[client].ZoneCacheValid = false;
+		global->Clients[client].CachedZone = nullptr;
 	}
 
 	/** @ingroup MiningControl
@@ -213,8 +348,16 @@ namespace Plugins::MiningControl
 	 */
 	void LoadSettingsAfterStartup()
 	{
+		// Finish any pending writes before the log is replayed
+		FlushReserveLog();
+		if (global->ReserveLogWriter)
+			global->ReserveLogWriter->Stop();
+		global->ReserveLogWriter.reset();
+
 		global->ZoneBonus.clear();
-		global->PlayerBonus.clear();
+		global->ZoneSlots.clear();
+		global->ZoneIds.clear();
+		global->PlayerBonusByShip.clear();
 
 		// Patch Archetype::GetEquipment & Archetype::GetShip to suppress annoying
 		// warnings flserver-errors.log
@@ -289,7 +432,17 @@ namespace Plugins::MiningControl
 				Console::ConErr(std::format("{}: ammo not valid", ammo));
 			}
 
-			global->PlayerBonus.insert(std::multimap<uint, PlayerBonus>::value_type(pb.LootId, pb));
+			CompiledPlayerBonus compiled;
+			compiled.LootId = pb.LootId;
+			compiled.Bonus = pb.Bonus;
+			compiled.RepId = pb.RepId;
+			compiled.ItemIds = pb.ItemIds;
+			std::ranges::sort(compiled.ItemIds);
+			compiled.ItemIds.erase(std::ranges::unique(compiled.ItemIds).begin(), compiled.ItemIds.end());
+			compiled.AmmoIds = pb.AmmoIds;
+			compiled.ShipIds = pb.ShipIds;
+			for (const auto shipId : pb.ShipIds)
+				global->PlayerBonusByShip[shipId].emplace_back(compiled);
 
 			if (config.PluginDebug)
 			{
@@ -321,7 +474,7 @@ namespace Plugins::MiningControl
 			if (zb.MaxReserve <= 0.0f)
 				zb.MaxReserve = 100000;
 
-			global->ZoneBonus[CreateID(zb.Zone.c_str())] = zb;
+			global->ZoneBonus[GetZoneSlot(CreateID(zb.Zone.c_str()))] = zb;
 
 			if (config.PluginDebug)
 			{
@@ -337,14 +490,28 @@ namespace Plugins::MiningControl
 
 		for (const auto miningStats = Serializer::JsonToObject<MiningStats>(); auto& zone : miningStats.Stats)
 		{
-			uint ZoneId = CreateID(zone.Zone.c_str());
-			if (global->ZoneBonus.contains(ZoneId))
+			if (const auto slot = global->ZoneSlots.find(CreateID(zone.Zone.c_str())); slot != global->ZoneSlots.end())
 			{
-				global->ZoneBonus[ZoneId].CurrentReserve = zone.CurrentReserve;
-				global->ZoneBonus[ZoneId].Mined = zone.Mined;
+				global->ZoneBonus[slot->second].CurrentReserve = zone.CurrentReserve;
+				global->ZoneBonus[slot->second].Mined = zone.Mined;
 			}
 		}
 
+		// Apply the changes logged since the stats file was last written
+		for (const auto& [zoneId, entry] : ReserveLog::Replay(GetReserveLogPath()))
+		{
+			if (const auto slot = global->ZoneSlots.find(zoneId); slot != global->ZoneSlots.end())
+			{
+				global->ZoneBonus[slot->second].CurrentReserve = entry.currentReserve;
+				global->ZoneBonus[slot->second].Mined = entry.mined;
+			}
+		}
+
+		// Fold the replayed changes into the stats file. The writer keeps the log until that has succeeded.
+		global->ReserveLogWriter = std::make_unique<ReserveLog::Writer>(GetReserveLogPath());
+		global->ReserveLogWriter->Compact([stats = BuildMiningStats()]() mutable { return JsonFile::Save(stats); });
+
+		global->RandomStream.Reseed("MiningControl", config.RandomSeed);
 		global->config = std::make_unique<Config>(config);
 
 		// Remove patch now that we've finished loading.
@@ -357,8 +524,13 @@ namespace Plugins::MiningControl
 		while ((playerData = Players.traverse_active(playerData)))
 		{
 			uint client = playerData->iOnlineId;
+			// The characters are still loaded on a reload, so hand out their ore before the client data is reset
+			DeliverPendingOre(client);
 			ClearClientInfo(client);
 		}
+		global->OnlinePlayers.Clear();
+		for (const auto& player : Hk::Admin::GetPlayers())
+			global->OnlinePlayers.Add(player.client, player.character);
 	}
 
 	/** @ingroup MiningControl
@@ -384,156 +556,293 @@ namespace Plugins::MiningControl
 		// already.
 		CheckClientSetup(client);
 
-		uint ship = Hk::Player::GetShip(client).value();
+		uint ship;
+		pub::Player::GetShip(client, ship);
+		if (!ship)
+			return;
+
+		Vector shipPosition;
+		Matrix shipRotation;
+		pub::SpaceObj::GetLocation(ship, shipPosition, shipRotation);
 
-		auto [shipPosition, _] = Hk::Solar::GetLocation(ship, IdType::Ship).value();
+		SystemId iClientSystemId;
+		pub::Player::GetSystem(client, iClientSystemId);
 
-		SystemId iClientSystemId = Hk::Player::GetSystem(client).value();
-		CmnAsteroid::CAsteroidSystem* csys = CmnAsteroid::Find(iClientSystemId);
-		if (csys)
+		ClientData& cd = global->Clients[client];
+		const Universe::IZone* zone = ResolveMiningZone(cd, iClientSystemId, shipPosition);
+		if (!zone)
+			return;
+
+		try
 		{
-			// Find asteroid field that matches the best.
-			for (CmnAsteroid::CAsteroidField* cfield = csys->FindFirst(); cfield; cfield = csys->FindNext())
+			ZoneBonus& zoneState = global->ZoneBonus[cd.CachedZoneSlot];
+
+			// Adjust the bonus based on the zone.
+			float zoneBonus = 0.25f;
+			if (zoneState.Bonus != 0.0f)
+				zoneBonus = zoneState.Bonus;
+
+			// If the field is getting mined out, reduce the bonus
+			zoneBonus *= zoneState.CurrentReserve / zoneState.MaxReserve;
+
+			uint lootId = zone->lootableZone->dynamic_loot_commodity;
+			uint crateId = zone->lootableZone->dynamic_loot_container;
+
+			// Change the commodity if appropriate.
+			if (zoneState.ReplacementLootId)
+				lootId = zoneState.ReplacementLootId;
+
+			// If no mining bonus entry for this commodity is found,
+			// flag as no bonus
+			auto ammolst = cd.LootAmmo.find(lootId);
+			bool miningBonusEligible = true;
+			if (ammolst == cd.LootAmmo.end())
 			{
-				try
+				miningBonusEligible = false;
+				if (cd.Debug)
+					PrintUserCmdText(client, L"* Wrong ship/equip/rep");
+			}
+			// If this minable commodity was not hit by the right type
+			// of gun, flag as no bonus
+			else if (std::ranges::find(ammolst->second, ci.iProjectileArchId) == ammolst->second.end())
+			{
+				miningBonusEligible = false;
+				if (cd.Debug)
+					PrintUserCmdText(client, L"* Wrong gun");
+			}
+
+			// If either no mining gun was used in the shot, or the
+			// character isn't using a valid mining combo for this
+			// commodity, set bonus to *0.5
+			float fPlayerBonus = 0.5f;
+			if (miningBonusEligible)
+				fPlayerBonus = cd.LootBonus[lootId];
+
+			// If this ship is has another ship targetted then send the
+			// ore into the cargo hold of the other ship.
+			uint sendToClientId = client;
+			if (!miningBonusEligible)
+			{
+				auto targetShip = Hk::Player::GetTarget(client);
+				if (targetShip.has_value())
 				{
-					const Universe::IZone* zone = cfield->get_lootable_zone(shipPosition);
-					if (cfield->near_field(shipPosition) && zone && zone->lootableZone)
+					const auto targetClientId = Hk::Client::GetClientIdByShip(targetShip.value());
+					if (targetClientId.value() && Hk::Math::Distance3DByShip(ship, targetShip.value()) < 1000.0f)
 					{
-						ClientData& cd = global->Clients[client];
-
-						// Adjust the bonus based on the zone.
-						float zoneBonus = 0.25f;
-						if (global->ZoneBonus[zone->iZoneId].Bonus != 0.0f)
-							zoneBonus = global->ZoneBonus[zone->iZoneId].Bonus;
-
-						// If the field is getting mined out, reduce the bonus
-						zoneBonus *= global->ZoneBonus[zone->iZoneId].CurrentReserve / global->ZoneBonus[zone->iZoneId].MaxReserve;
-
-						uint lootId = zone->lootableZone->dynamic_loot_commodity;
-						uint crateId = zone->lootableZone->dynamic_loot_container;
-
-						// Change the commodity if appropriate.
-						if (global->ZoneBonus[zone->iZoneId].ReplacementLootId)
-							lootId = global->ZoneBonus[zone->iZoneId].ReplacementLootId;
-
-						// If no mining bonus entry for this commodity is found,
-						// flag as no bonus
-						auto ammolst = cd.LootAmmo.find(lootId);
-						bool miningBonusEligible = true;
-						if (ammolst == cd.LootAmmo.end())
-						{
-							miningBonusEligible = false;
-							if (cd.Debug)
-								PrintUserCmdText(client, L"* Wrong ship/equip/rep");
-						}
-						// If this minable commodity was not hit by the right type
-						// of gun, flag as no bonus
-						else if (std::ranges::find(ammolst->second, ci.iProjectileArchId) == ammolst->second.end())
-						{
-							miningBonusEligible = false;
-							if (cd.Debug)
-								PrintUserCmdText(client, L"* Wrong gun");
-						}
-
-						// If either no mining gun was used in the shot, or the
-						// character isn't using a valid mining combo for this
-						// commodity, set bonus to *0.5
-						float fPlayerBonus = 0.5f;
-						if (miningBonusEligible)
-							fPlayerBonus = cd.LootBonus[lootId];
-
-						// If this ship is has another ship targetted then send the
-						// ore into the cargo hold of the other ship.
-						uint sendToClientId = client;
-						if (!miningBonusEligible)
-						{
-							auto targetShip = Hk::Player::GetTarget(client);
-							if (targetShip.has_value())
-							{
-								const auto targetClientId = Hk::Client::GetClientIdByShip(targetShip.value());
-								if (targetClientId.value() && Hk::Math::Distance3DByShip(ship, targetShip.value()) < 1000.0f)
-								{
-									sendToClientId = targetClientId.value();
-								}
-							}
-						}
-
-						// Calculate the loot drop count
-						const float random = static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
-
-						// Calculate the loot drop and drop it.
-						auto lootCount = static_cast<int>(
-						    random * global->config->GenericFactor * zoneBonus * fPlayerBonus * static_cast<float>(zone->lootableZone->dynamic_loot_count2));
-
-						// Remove this lootCount from the field
-						global->ZoneBonus[zone->iZoneId].CurrentReserve -= static_cast<float>(lootCount);
-						global->ZoneBonus[zone->iZoneId].Mined += static_cast<float>(lootCount);
-						if (global->ZoneBonus[zone->iZoneId].CurrentReserve <= 0)
-						{
-							global->ZoneBonus[zone->iZoneId].CurrentReserve = 0;
-							lootCount = 0;
-						}
-
-						if (global->Clients[client].Debug)
-						{
-							PrintUserCmdText(client,
-							    std::format(L"* fRand={} fGenericBonus={} fPlayerBonus={} fZoneBonus{} iLootCount={} LootId={}/{} CurrentReserve={:.1f}",
-							        random,
-							        global->config->GenericFactor,
-							        fPlayerBonus,
-							        zoneBonus,
-							        lootCount,
-							        lootId,
-							        crateId,
-							        global->ZoneBonus[zone->iZoneId].CurrentReserve));
-						}
-
-						global->Clients[client].MineAsteroidEvents++;
-						if (global->Clients[client].MineAsteroidSampleStart < time(0))
-						{
-							if (float average = static_cast<float>(global->Clients[client].MineAsteroidEvents) / 30.0f; average > 2.0f)
-							{
-								std::wstring CharName = (const wchar_t*)Players.GetActiveCharacterName(client);
-								AddLog(LogType::Normal,
-								    LogLevel::Info,
-								    std::format("High mining rate charname={} rate={:.1f}/sec location={:.1f},{:.1f},{:.1f} system={} zone={}",
-								        wstos(CharName.c_str()),
-								        average,
-								        shipPosition.x,
-								        shipPosition.y,
-								        shipPosition.z,
-								        zone->systemId,
-								        zone->iZoneId));
-							}
-
-							global->Clients[client].MineAsteroidSampleStart = time(0) + 30;
-							global->Clients[client].MineAsteroidEvents = 0;
-						}
-
-						if (lootCount)
-						{
-							float fHoldRemaining;
-							pub::Player::GetRemainingHoldSize(sendToClientId, fHoldRemaining);
-							if (fHoldRemaining < static_cast<float>(lootCount))
-							{
-								lootCount = (int)fHoldRemaining;
-							}
-							if (lootCount == 0)
-							{
-								pub::Player::SendNNMessage(client, CreateID("insufficient_cargo_space"));
-								return;
-							}
-							Hk::Player::AddCargo(sendToClientId, lootId, lootCount, false);
-						}
-						return;
+						sendToClientId = targetClientId.value();
 					}
 				}
-				catch (...)
+			}
+
+			// Calculate the loot drop count
+			const float random = global->RandomStream.Float();
+
+			// Calculate the loot drop and drop it.
+			auto lootCount = static_cast<int>(
+			    random * global->config->GenericFactor * zoneBonus * fPlayerBonus * static_cast<float>(zone->lootableZone->dynamic_loot_count2));
+
+			// Remove this lootCount from the field
+			zoneState.CurrentReserve -= static_cast<float>(lootCount);
+			zoneState.Mined += static_cast<float>(lootCount);
+			global->DirtyZones.insert(cd.CachedZoneSlot);
+			if (zoneState.CurrentReserve <= 0)
+			{
+				zoneState.CurrentReserve = 0;
+				lootCount = 0;
+			}
+
+			if (global->Clients[client].Debug)
+			{
+				PrintUserCmdText(client,
+				    std::format(L"* fRand={} fGenericBonus={} fPlayerBonus={} fZoneBonus{} iLootCount={} LootId={}/{} CurrentReserve={:.1f}",
+				        random,
+				        global->config->GenericFactor,
+				        fPlayerBonus,
+				        zoneBonus,
+				        lootCount,
+				        lootId,
+				        crateId,
+				        zoneState.CurrentReserve));
+			}
+
+			const int64_t nowInMs = GetMonotonicTimeInMs();
+			cd.MiningRate.Record(nowInMs);
+
+			const float windowRate = cd.MiningRate.WindowRate(nowInMs);
+			const uint lastSecond = cd.MiningRate.LastSecondCount(nowInMs);
+			if ((windowRate > global->config->MaxMiningRate || lastSecond > global->config->MaxMiningBurst) &&
+			    (!cd.LastRateWarningInMs || nowInMs - cd.LastRateWarningInMs >= MiningRateEstimator::WindowInMs))
+			{
+				cd.LastRateWarningInMs = nowInMs;
+				std::wstring CharName = (const wchar_t*)Players.GetActiveCharacterName(client);
+				AddLog(LogType::Normal,
+				    LogLevel::Info,
+				    std::format("High mining rate charname={} rate={:.1f}/sec lastSecond={} location={:.1f},{:.1f},{:.1f} system={} zone={}",
+				        wstos(CharName.c_str()),
+				        windowRate,
+				        lastSecond,
+				        shipPosition.x,
+				        shipPosition.y,
+				        shipPosition.z,
+				        zone->systemId,
+				        zone->iZoneId));
+			}
+
+			if (lootCount)
+			{
+				// The ore is held back and delivered in one go, so the hold space is tracked locally between deliveries
+				ClientData& recipient = global->Clients[sendToClientId];
+				if (!recipient.HoldRemainingKnown)
+				{
+					pub::Player::GetRemainingHoldSize(sendToClientId, recipient.CachedHoldRemaining);
+					recipient.HoldRemainingKnown = true;
+				}
+
+				if (recipient.CachedHoldRemaining < static_cast<float>(lootCount))
+				{
+					lootCount = (int)recipient.CachedHoldRemaining;
+				}
+				if (lootCount == 0)
 				{
+					pub::Player::SendNNMessage(client, CreateID("insufficient_cargo_space"));
+					return;
 				}
+
+				recipient.CachedHoldRemaining -= static_cast<float>(lootCount);
+				recipient.PendingLoot[lootId] += lootCount;
+				global->OreHits++;
 			}
 		}
+		catch (...)
+		{
+		}
+	}
+
+	/** @ingroup MiningControl
+	 * @brief Base enter hook. Delivers any ore still pending before the player docks.
+	 */
+	void BaseEnter([[maybe_unused]] const uint& baseId, ClientId& client)
+	{
+		DeliverPendingOre(client);
+	}
+
+	/** @ingroup MiningControl
+	 * @brief Disconnect hook. Delivers any ore still pending while the character is still loaded.
+	 */
+	void DisConnect(ClientId& client, [[maybe_unused]] enum EFLConnection& state)
+	{
+		DeliverPendingOre(client);
+		global->OnlinePlayers.Remove(client);
+	}
+
+	/** @ingroup MiningControl
+	 * @brief Character select hook. Indexes the character by name for the admin commands.
+	 */
+	void CharacterSelect([[maybe_unused]] const std::string& charFilename, ClientId& client)
+	{
+		if (const auto charName = (const wchar_t*)Players.GetActiveCharacterName(client))
+			global->OnlinePlayers.Add(client, charName);
+	}
+
+	/** @ingroup MiningControl
+	 * @brief Admin command to show how mined ore is being delivered
+	 */
+	void AdminCmd_MineStats(CCmds* commands)
+	{
+		if (!(commands->rights & RIGHT_SUPERADMIN))
+		{
+			commands->Print("ERR No permission\n");
+			return;
+		}
+
+		commands->Print(std::format("Ore hits: {} cargo deliveries: {}\n", global->OreHits, global->OreDeliveries));
+		commands->Print("OK\n");
+	}
+
+	/** @ingroup MiningControl
+	 * @brief Returns the mining rate of an online character in the form used by the dump
+	 */
+	CharacterMiningRate GetCharacterMiningRate(ClientId client, int64_t nowInMs)
+	{
+		auto& miningRate = global->Clients[client].MiningRate;
+
+		CharacterMiningRate rate;
+		rate.Character = (const wchar_t*)Players.GetActiveCharacterName(client);
+		rate.RatePerSecond = miningRate.WindowRate(nowInMs);
+		rate.LastSecond = miningRate.LastSecondCount(nowInMs);
+		rate.TotalHits = miningRate.TotalHits();
+		rate.IntervalHistogram.assign(miningRate.IntervalHistogram().begin(), miningRate.IntervalHistogram().end());
+		return rate;
+	}
+
+	/** @ingroup MiningControl
+	 * @brief Admin command to show the mining rate of a character, or dump the rates of every online miner to MiningRates.json
+	 */
+	void AdminCmd_MineRate(CCmds* commands, const std::wstring& param)
+	{
+		if (!(commands->rights & RIGHT_SUPERADMIN))
+		{
+			commands->Print("ERR No permission\n");
+			return;
+		}
+
+		const int64_t nowInMs = GetMonotonicTimeInMs();
+
+		if (param == L"dump")
+		{
+			MiningRateDump dump;
+			PlayerData* playerData = nullptr;
+			while ((playerData = Players.traverse_active(playerData)))
+			{
+				if (global->Clients[playerData->iOnlineId].MiningRate.TotalHits())
+					dump.Characters.emplace_back(GetCharacterMiningRate(playerData->iOnlineId, nowInMs));
+			}
+
+			Serializer::SaveToJson(dump);
+			commands->Print(std::format("OK {} miners written to MiningRates.json\n", dump.Characters.size()));
+			return;
+		}
+
+		const auto client = global->OnlinePlayers.Find(param);
+		if (!client)
+		{
+			commands->Print("ERR Usage: minerate <charname>|dump\n");
+			return;
+		}
+
+		const auto rate = GetCharacterMiningRate(client.value(), nowInMs);
+		commands->Print(std::format("{:.2f} hits/sec over 30s, {} in the last second, {} total\n", rate.RatePerSecond, rate.LastSecond, rate.TotalHits));
+
+		std::string histogram;
+		for (size_t i = 0; i < rate.IntervalHistogram.size(); i++)
+		{
+			if (rate.IntervalHistogram[i])
+				histogram += std::format("<{}ms:{} ", 1ull << i, rate.IntervalHistogram[i]);
+		}
+		commands->Print(std::format("Intervals: {}\n", histogram));
+		commands->Print("OK\n");
+	}
+
+	/** @ingroup MiningControl
+	 * @brief Proceessing for admin commands
+	 */
+	bool AdminCommandProcessing(CCmds* commands, const std::wstring& command)
+	{
+		if (command == L"minestats")
+		{
+			global->returnCode = ReturnCode::SkipAll;
+			AdminCmd_MineStats(commands);
+			return true;
+		}
+		if (command == L"minerate")
+		{
+			global->returnCode = ReturnCode::SkipAll;
+			AdminCmd_MineRate(commands, commands->ArgCharname(1));
+			return true;
+		}
+
+		global->returnCode = ReturnCode::Default;
+		return false;
 	}
 
 	/** @ingroup MiningControl
@@ -553,7 +862,10 @@ REFL_AUTO(type(PlayerBonus), field(Loot), field(Bonus), field(Rep), field(Ships)
 REFL_AUTO(type(ZoneBonus), field(Zone), field(Bonus), field(ReplacementLoot), field(RechargeRate), field(CurrentReserve), field(MaxReserve), field(Mined))
 REFL_AUTO(type(ZoneStats), field(Zone), field(CurrentReserve), field(Mined))
 REFL_AUTO(type(MiningStats), field(Stats))
-REFL_AUTO(type(Config), field(PlayerBonus), field(ZoneBonus), field(GenericFactor), field(PluginDebug));
+REFL_AUTO(type(Config), field(PlayerBonus), field(ZoneBonus), field(GenericFactor), field(PluginDebug), field(ZoneCacheDistance),
+    field(OreDeliveryIntervalInSeconds), field(MaxMiningRate), field(MaxMiningBurst), field(RandomSeed));
+REFL_AUTO(type(CharacterMiningRate), field(Character), field(RatePerSecond), field(LastSecond), field(TotalHits), field(IntervalHistogram));
+REFL_AUTO(type(MiningRateDump), field(Characters));
 
 DefaultDllMainSettings(LoadSettingsAfterStartup);
 
@@ -561,14 +873,20 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 {
 	pi->name("Mine Control");
 	pi->shortName("minecontrol");
-	pi->mayUnload(true);
+	// The reserve log writer thread cannot be joined safely while the dll is being unloaded
+	pi->mayUnload(false);
 	pi->timers(&timers);
 	pi->returnCode(&global->returnCode);
 	pi->versionMajor(PluginMajorVersion::VERSION_04);
 	pi->versionMinor(PluginMinorVersion::VERSION_00);
 	pi->emplaceHook(HookedCall::IServerImpl__Startup, &LoadSettingsAfterStartup, HookStep::After);
 	pi->emplaceHook(HookedCall::FLHook__ClearClientInfo, &ClearClientInfo, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__Shutdown, &Shutdown);
 	pi->emplaceHook(HookedCall::IServerImpl__PlayerLaunch, &PlayerLaunch);
 	pi->emplaceHook(HookedCall::IServerImpl__MineAsteroid, &MineAsteroid);
 	pi->emplaceHook(HookedCall::IServerImpl__SPMunitionCollision, &SPMunitionCollision);
+	pi->emplaceHook(HookedCall::IServerImpl__BaseEnter, &BaseEnter);
+	pi->emplaceHook(HookedCall::IServerImpl__DisConnect, &DisConnect);
+	pi->emplaceHook(HookedCall::IServerImpl__CharacterSelect, &CharacterSelect, HookStep::After);
+	pi->emplaceHook(HookedCall::FLHook__AdminCommand__Process, &AdminCommandProcessing);
 }
\ No newline at end of file
@@ -2,6 +2,12 @@
 #include <FLHook.hpp>
 #include <plugin.h>
 
+#include "../common/JsonFile.h"
+#include "../common/PlayerIndex.h"
+#include "../common/Random.h"
+#include "MiningRate.h"
+#include "ReserveLog.h"
+
 namespace Plugins::MiningControl
 {
 	//! A struct that defines a mining bonus to a player if they meet certain criteria
@@ -33,6 +39,19 @@ namespace Plugins::MiningControl
 		std::vector<uint> AmmoIds;
 	};
 
+	//! A PlayerBonus compiled for fast eligibility checks, stored under every ship it applies to
+	struct CompiledPlayerBonus
+	{
+		uint LootId = 0;
+		float Bonus = 0.0f;
+		//! UINT_MAX if any reputation qualifies
+		uint RepId = UINT_MAX;
+		//! Sorted and deduplicated so it can be matched against the sorted mounted equipment in one pass
+		std::vector<uint> ItemIds;
+		std::vector<uint> AmmoIds;
+		std::vector<uint> ShipIds;
+	};
+
 	//! A struct that defines a mining bonus for a certain zone in space
 	struct ZoneBonus : Reflectable
 	{
@@ -71,8 +90,22 @@ namespace Plugins::MiningControl
 		std::map<uint, std::vector<uint>> LootShip;
 		int Debug = 0;
 
-		int MineAsteroidEvents = 0;
-		time_t MineAsteroidSampleStart = 0;
+		//! Mining hit rate used to detect bots, and when they were last reported
+		MiningRateEstimator MiningRate;
+		int64_t LastRateWarningInMs = 0;
+
+		//! The lootable zone last resolved for this client, reused until they move ZoneCacheDistance away or change system
+		bool ZoneCacheValid = false;
+		SystemId CachedSystem = 0;
+		Vector CachedPosition {};
+		const Universe::IZone* CachedZone = nullptr;
+		uint CachedZoneSlot = 0;
+
+		//! Ore mined for this client that has not been added to their hold yet, by commodity
+		std::map<uint, int> PendingLoot;
+		//! Hold space left once the pending ore is delivered, queried once per delivery interval
+		float CachedHoldRemaining = 0.0f;
+		bool HoldRemainingKnown = false;
 	};
 
 	//! A struct to hold the current status of a zone so their progress persists across restarts
@@ -96,6 +129,38 @@ namespace Plugins::MiningControl
 		std::vector<ZoneStats> Stats;
 	};
 
+	//! The mining rate of a single character, as written by the minerate dump admin command
+	struct CharacterMiningRate : Reflectable
+	{
+		std::wstring Character;
+		float RatePerSecond = 0.0f;
+		uint LastSecond = 0;
+		uint64_t TotalHits = 0;
+		//! Counts of the time between hits. Entry i counts gaps of 2^(i-1) to 2^i ms, the first entry gaps under 1 ms.
+		std::vector<uint> IntervalHistogram;
+	};
+
+	//! Machine readable dump of every online miner's hit rate
+	struct MiningRateDump : Reflectable
+	{
+		std::string File() override
+		{
+			char path[MAX_PATH];
+			GetUserDataPath(path);
+			return std::string(path) + "\\MiningRates.json";
+		}
+
+		std::vector<CharacterMiningRate> Characters;
+	};
+
+	//! The write-ahead log of zone reserve changes made since MiningStats.json was last written
+	inline std::filesystem::path GetReserveLogPath()
+	{
+		char path[MAX_PATH];
+		GetUserDataPath(path);
+		return std::string(path) + "\\MiningStats.wal";
+	}
+
 	//! Config data for this plugin
 	struct Config : Reflectable
 	{
@@ -109,15 +174,40 @@ namespace Plugins::MiningControl
 		std::vector<ZoneBonus> ZoneBonus = {zoneBonusExample};
 		float GenericFactor = 1.0f;
 		int PluginDebug = 0;
+		//! How far a client may move before the asteroid field they are mining in is looked up again
+		float ZoneCacheDistance = 500.0f;
+		//! Average hits per second over the 30 second window above which a miner is reported
+		float MaxMiningRate = 2.0f;
+		//! Hits within a single second above which a miner is reported straight away
+		uint MaxMiningBurst = 8;
+		//! How often mined ore is added to the recipients' holds. Ore is also delivered when they dock or disconnect.
+		uint OreDeliveryIntervalInSeconds = 2;
+		//! Seed for the loot rolls so a session can be replayed. 0 picks a random seed on every load.
+		uint RandomSeed = 0;
 	};
 
 	//! Global data for this plugin
 	struct Global final
 	{
 		ReturnCode returnCode = ReturnCode::Default;
-		std::map<uint, ClientData> Clients;
-		std::multimap<uint, PlayerBonus> PlayerBonus;
-		std::map<uint, ZoneBonus> ZoneBonus;
+		std::array<ClientData, MaxClientId + 1> Clients;
+		//! Player bonuses keyed by ship id, in config order
+		std::map<uint, std::vector<CompiledPlayerBonus>> PlayerBonusByShip;
+		//! Zone bonuses stored densely and addressed by the slot held in ZoneSlots
+		std::vector<ZoneBonus> ZoneBonus;
+		std::map<uint, uint> ZoneSlots;
+		//! Zone ids by slot, used to write reserve log entries
+		std::vector<uint> ZoneIds;
+		//! Slots of zones whose reserve changed since the last reserve log flush
+		std::set<uint> DirtyZones;
+		std::unique_ptr<ReserveLog::Writer> ReserveLogWriter;
+		uint SecondsSinceOreDelivery = 0;
+		//! Mining hits that produced ore, and the AddCargo calls made to deliver it
+		uint64_t OreHits = 0;
+		uint64_t OreDeliveries = 0;
+		Random::Stream RandomStream {"MiningControl"};
+		//! The characters that are online by name, maintained on character select and disconnect
+		PlayerIndex::Index OnlinePlayers;
 		std::unique_ptr<Config> config = nullptr;
 	};
 } // namespace Plugins::MiningControl
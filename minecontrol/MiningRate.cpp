@@ -0,0 +1,68 @@
+#include "MiningRate.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace Plugins::MiningControl
+{
+	void MiningRateEstimator::Advance(int64_t nowInMs)
+	{
+		const int64_t bucket = nowInMs / BucketWidthInMs;
+		if (bucket <= currentBucket)
+			return;
+
+		// Clear every bucket that has dropped out of the window since the last call
+		const int64_t expired = std::min<int64_t>(bucket - currentBucket, BucketCount);
+		for (int64_t i = 1; i <= expired; i++)
+		{
+			auto& count = buckets[static_cast<size_t>((currentBucket + i) % BucketCount)];
+			windowTotal -= count;
+			count = 0;
+		}
+
+		currentBucket = bucket;
+	}
+
+	void MiningRateEstimator::Record(int64_t nowInMs)
+	{
+		Advance(nowInMs);
+
+		auto& count = buckets[static_cast<size_t>(currentBucket % BucketCount)];
+		if (count < std::numeric_limits<uint16_t>::max())
+		{
+			count++;
+			windowTotal++;
+		}
+		totalHits++;
+
+		if (lastHitInMs >= 0)
+		{
+			const auto interval = static_cast<uint64_t>(std::max<int64_t>(nowInMs - lastHitInMs, 0));
+			histogram[std::min<size_t>(std::bit_width(interval), HistogramBuckets - 1)]++;
+		}
+		lastHitInMs = nowInMs;
+	}
+
+	float MiningRateEstimator::WindowRate(int64_t nowInMs)
+	{
+		Advance(nowInMs);
+		return static_cast<float>(windowTotal) * 1000.0f / static_cast<float>(WindowInMs);
+	}
+
+	uint32_t MiningRateEstimator::LastSecondCount(int64_t nowInMs)
+	{
+		Advance(nowInMs);
+
+		uint32_t count = 0;
+		for (int64_t i = 0; i < 1000 / BucketWidthInMs; i++)
+			count += buckets[static_cast<size_t>((currentBucket - i + BucketCount) % BucketCount)];
+
+		return count;
+	}
+
+	void MiningRateEstimator::Reset()
+	{
+		*this = MiningRateEstimator();
+	}
+} // namespace Plugins::MiningControl
@@ -0,0 +1,43 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// The estimator only depends on the standard library and is fed timestamps by the caller, so it never reads the clock itself.
+namespace Plugins::MiningControl
+{
+	//! Fixed-size sliding window of mining hits with a log2 histogram of the time between hits
+	class MiningRateEstimator final
+	{
+	  public:
+		static constexpr int64_t BucketWidthInMs = 250;
+		static constexpr size_t BucketCount = 120;
+		static constexpr int64_t WindowInMs = BucketWidthInMs * BucketCount;
+		//! Bucket i counts intervals in [2^(i-1), 2^i) ms, bucket 0 counts intervals under 1 ms and the last bucket everything longer
+		static constexpr size_t HistogramBuckets = 24;
+
+		//! Records a hit at the given monotonic time
+		void Record(int64_t nowInMs);
+
+		//! Average hits per second over the whole window
+		[[nodiscard]] float WindowRate(int64_t nowInMs);
+
+		//! Hits within the last second
+		[[nodiscard]] uint32_t LastSecondCount(int64_t nowInMs);
+
+		[[nodiscard]] const std::array<uint32_t, HistogramBuckets>& IntervalHistogram() const { return histogram; }
+		[[nodiscard]] uint64_t TotalHits() const { return totalHits; }
+
+		void Reset();
+
+	  private:
+		void Advance(int64_t nowInMs);
+
+		std::array<uint16_t, BucketCount> buckets {};
+		std::array<uint32_t, HistogramBuckets> histogram {};
+		int64_t currentBucket = 0;
+		int64_t lastHitInMs = -1;
+		uint32_t windowTotal = 0;
+		uint64_t totalHits = 0;
+	};
+} // namespace Plugins::MiningControl
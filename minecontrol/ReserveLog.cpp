@@ -0,0 +1,136 @@
+#include "ReserveLog.h"
+#include "../common/Fnv.h"
+
+#include <cstring>
+#include <iterator>
+
+namespace Plugins::MiningControl::ReserveLog
+{
+	// Layout (little endian):
+	//   char[4]  magic "FLRL"
+	//   uint32   version
+	//   records: uint32 zone id, float current reserve, float mined, uint32 FNV-1a hash of the previous twelve bytes
+	constexpr char magic[4] = {'F', 'L', 'R', 'L'};
+	constexpr uint32_t version = 1;
+	constexpr size_t headerSize = sizeof(magic) + sizeof(version);
+	constexpr size_t payloadSize = sizeof(uint32_t) + sizeof(float) * 2;
+	constexpr size_t recordSize = payloadSize + sizeof(uint32_t);
+
+	void Encode(std::vector<char>& out, const Entry& entry)
+	{
+		char record[recordSize];
+		std::memcpy(record, &entry.zoneId, sizeof(uint32_t));
+		std::memcpy(record + 4, &entry.currentReserve, sizeof(float));
+		std::memcpy(record + 8, &entry.mined, sizeof(float));
+		const uint32_t hash = Fnv1a(record, payloadSize);
+		std::memcpy(record + payloadSize, &hash, sizeof(hash));
+		out.insert(out.end(), std::begin(record), std::end(record));
+	}
+
+	std::vector<Entry> Decode(const std::vector<char>& data)
+	{
+		std::vector<Entry> entries;
+
+		uint32_t fileVersion;
+		if (data.size() < headerSize || std::memcmp(data.data(), magic, sizeof(magic)) != 0)
+			return entries;
+
+		std::memcpy(&fileVersion, data.data() + sizeof(magic), sizeof(fileVersion));
+		if (fileVersion != version)
+			return entries;
+
+		for (size_t offset = headerSize; data.size() - offset >= recordSize; offset += recordSize)
+		{
+			const char* record = data.data() + offset;
+			uint32_t hash;
+			std::memcpy(&hash, record + payloadSize, sizeof(hash));
+			if (hash != Fnv1a(record, payloadSize))
+				break;
+
+			Entry& entry = entries.emplace_back();
+			std::memcpy(&entry.zoneId, record, sizeof(uint32_t));
+			std::memcpy(&entry.currentReserve, record + 4, sizeof(float));
+			std::memcpy(&entry.mined, record + 8, sizeof(float));
+		}
+
+		return entries;
+	}
+
+	std::map<uint32_t, Entry> Replay(const std::filesystem::path& path)
+	{
+		std::map<uint32_t, Entry> latest;
+
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			return latest;
+
+		const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		for (const auto& entry : Decode(data))
+			latest[entry.zoneId] = entry;
+
+		return latest;
+	}
+
+	Writer::Writer(std::filesystem::path path) : path(std::move(path))
+	{
+		// The entries in the log stay until a compaction has written them to the stats file. Appending after a torn record would hide
+		// everything that follows it, so the log is cut back to its intact entries first.
+		std::vector<char> data;
+		if (std::ifstream existing(this->path, std::ios::binary); existing)
+			data.assign(std::istreambuf_iterator<char>(existing), std::istreambuf_iterator<char>());
+
+		std::error_code ec;
+		if (data.size() >= headerSize && std::memcmp(data.data(), magic, sizeof(magic)) == 0 &&
+		    std::memcmp(data.data() + sizeof(magic), &version, sizeof(version)) == 0)
+		{
+			const size_t intact = headerSize + Decode(data).size() * recordSize;
+			if (intact != data.size())
+				std::filesystem::resize_file(this->path, intact, ec);
+
+			if (!ec)
+				file.open(this->path, std::ios::binary | std::ios::app);
+		}
+
+		if (!file.is_open())
+			Reset();
+	}
+
+	void Writer::Append(std::vector<Entry> entries)
+	{
+		if (entries.empty())
+			return;
+
+		worker.Post([this, entries = std::move(entries)] {
+			buffer.clear();
+			for (const auto& entry : entries)
+				Encode(buffer, entry);
+
+			file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			file.flush();
+		});
+	}
+
+	void Writer::Compact(std::function<bool()> writeSnapshot)
+	{
+		// Tasks run in order, so the snapshot covers every entry appended before it and the log can be started over. If the snapshot could
+		// not be written the log is kept, as it is all that holds those entries.
+		worker.Post([this, writeSnapshot = std::move(writeSnapshot)] {
+			if (writeSnapshot())
+				Reset();
+		});
+	}
+
+	void Writer::Stop()
+	{
+		worker.Stop();
+	}
+
+	void Writer::Reset()
+	{
+		file.close();
+		file.open(path, std::ios::binary | std::ios::trunc);
+		file.write(magic, sizeof(magic));
+		file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+		file.flush();
+	}
+} // namespace Plugins::MiningControl::ReserveLog
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "../common/WorkerThread.h"
+
+// The reserve log only depends on the standard library so the format and replay can be exercised outside of the server.
+namespace Plugins::MiningControl::ReserveLog
+{
+	//! The state of a zone's reserve at the time it was logged. Entries hold absolute values so replaying one twice is harmless.
+	struct Entry final
+	{
+		uint32_t zoneId = 0;
+		float currentReserve = 0.0f;
+		float mined = 0.0f;
+	};
+
+	//! Appends the encoded entry to the buffer
+	void Encode(std::vector<char>& out, const Entry& entry);
+
+	//! Decodes the entries of a log file. Decoding stops at the first torn or corrupt record, which is what a crash mid-append leaves behind.
+	std::vector<Entry> Decode(const std::vector<char>& data);
+
+	//! Reads a log file and returns the latest entry for every zone in it. A missing file yields no entries.
+	std::map<uint32_t, Entry> Replay(const std::filesystem::path& path);
+
+	//! Appends entries to the log from a background thread and compacts it on request. The owner stops it with Stop before destroying it.
+	class Writer final
+	{
+	  public:
+		//! Opens the log, keeping the intact entries already in it. A torn or corrupt tail left by a crash is cut off.
+		explicit Writer(std::filesystem::path path);
+
+		//! Queues entries to be appended and flushed to the log
+		void Append(std::vector<Entry> entries);
+
+		//! Queues a compaction. writeSnapshot runs on the writer thread and must persist every entry logged so far. The log is truncated only if
+		//! it returns true.
+		void Compact(std::function<bool()> writeSnapshot);
+
+		//! Writes everything still queued and stops the writer thread
+		void Stop();
+
+	  private:
+		void Reset();
+
+		std::filesystem::path path;
+		std::ofstream file;
+		std::vector<char> buffer;
+		WorkerThread worker;
+	};
+} // namespace Plugins::MiningControl::ReserveLog
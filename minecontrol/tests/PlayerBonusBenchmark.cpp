@@ -0,0 +1,219 @@
+// Benchmark of CheckClientSetup's player bonus matching with 500 bonus rules and a 60 item cargo list:
+//   g++ -std=c++20 -O2 -o player_bonus_benchmark PlayerBonusBenchmark.cpp
+//   ./player_bonus_benchmark
+// The old path walks every rule and, for each, re-scans all rules of that commodity and searches the cargo list for every required item.
+// The new path sorts the mounted equipment once and only checks the rules compiled for the client's ship. Both must find the same bonuses.
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr int RuleCount = 500;
+	constexpr int CargoCount = 60;
+	constexpr int CommodityCount = 40;
+	constexpr int ShipCount = 30;
+	constexpr int ItemCount = 400;
+	constexpr int ClientCount = 1000;
+
+	using uint = uint32_t;
+
+	//! Stand-in for CARGO_INFO
+	struct CARGO_INFO
+	{
+		uint iId;
+		int iCount;
+		uint iArchId;
+		float fStatus;
+		bool bMission;
+		bool bMounted;
+	};
+
+	struct PlayerBonus
+	{
+		uint LootId = 0;
+		float Bonus = 0.0f;
+		uint RepId = UINT_MAX;
+		std::vector<uint> ShipIds;
+		std::vector<uint> ItemIds;
+		std::vector<uint> AmmoIds;
+	};
+
+	struct CompiledPlayerBonus
+	{
+		uint LootId = 0;
+		float Bonus = 0.0f;
+		uint RepId = UINT_MAX;
+		std::vector<uint> ItemIds;
+		std::vector<uint> AmmoIds;
+		std::vector<uint> ShipIds;
+	};
+
+	struct Client
+	{
+		uint shipId;
+		uint repGroupId;
+		std::list<CARGO_INFO> cargo;
+	};
+
+	std::multimap<uint, PlayerBonus> playerBonus;
+	std::map<uint, std::vector<CompiledPlayerBonus>> playerBonusByShip;
+
+	bool ContainsEquipment(const std::list<CARGO_INFO>& cargoList, uint archId)
+	{
+		return std::ranges::any_of(cargoList, [archId](const CARGO_INFO& c) { return c.bMounted && c.iArchId == archId; });
+	}
+
+	float GetBonus(uint reputation, uint shipId, const std::list<CARGO_INFO>& cargoList, uint lootId)
+	{
+		auto start = playerBonus.lower_bound(lootId);
+		auto end = playerBonus.upper_bound(lootId);
+		for (; start != end; start++)
+		{
+			if (start->second.RepId != UINT_MAX && reputation != start->second.RepId)
+				continue;
+
+			if (std::ranges::find(start->second.ShipIds, shipId) == start->second.ShipIds.end())
+				continue;
+
+			bool bEquipMatch = true;
+			for (auto item : start->second.ItemIds)
+			{
+				if (!ContainsEquipment(cargoList, item))
+				{
+					bEquipMatch = false;
+					break;
+				}
+			}
+
+			if (bEquipMatch)
+				return start->second.Bonus;
+		}
+
+		return 0.0f;
+	}
+
+	//! CheckClientSetup before the rules were compiled
+	std::map<uint, float> MatchByScanning(const Client& client)
+	{
+		std::map<uint, float> lootBonus;
+		for (const auto& [lootId, bonus] : playerBonus)
+		{
+			if (const float value = GetBonus(client.repGroupId, client.shipId, client.cargo, lootId); value > 0.0f)
+				lootBonus[lootId] = value;
+		}
+		return lootBonus;
+	}
+
+	//! CheckClientSetup with the rules compiled by ship
+	std::map<uint, float> MatchCompiled(const Client& client)
+	{
+		std::vector<uint> mountedEquipment;
+		for (const auto& cargo : client.cargo)
+		{
+			if (cargo.bMounted)
+				mountedEquipment.emplace_back(cargo.iArchId);
+		}
+		std::ranges::sort(mountedEquipment);
+
+		std::map<uint, float> lootBonus;
+		if (const auto bonuses = playerBonusByShip.find(client.shipId); bonuses != playerBonusByShip.end())
+		{
+			for (const auto& bonus : bonuses->second)
+			{
+				if (bonus.RepId != UINT_MAX && client.repGroupId != bonus.RepId)
+					continue;
+
+				if (lootBonus.contains(bonus.LootId))
+					continue;
+
+				if (!std::ranges::includes(mountedEquipment, bonus.ItemIds))
+					continue;
+
+				lootBonus[bonus.LootId] = bonus.Bonus;
+			}
+		}
+		return lootBonus;
+	}
+
+	template<typename Match>
+	double MicrosecondsPerClient(const std::vector<Client>& clients, Match&& match, size_t& matches)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (const auto& client : clients)
+			matches += match(client).size();
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		return std::chrono::duration<double, std::micro>(elapsed).count() / static_cast<double>(clients.size());
+	}
+} // namespace
+
+int main()
+{
+	std::mt19937 rng {8};
+	const auto below = [&rng](uint count) { return std::uniform_int_distribution<uint> {0, count - 1}(rng); };
+
+	// Rules drawn from a small pool of items so a fair share of them match
+	std::vector<PlayerBonus> config(RuleCount);
+	for (auto& pb : config)
+	{
+		pb.LootId = 1000 + below(CommodityCount);
+		pb.Bonus = 1.0f + static_cast<float>(below(100)) / 100.0f;
+		pb.RepId = below(4) ? UINT_MAX : 500 + below(3);
+		for (uint ships = 1 + below(3); ships; ships--)
+			pb.ShipIds.emplace_back(2000 + below(ShipCount));
+		for (uint items = 1 + below(4); items; items--)
+			pb.ItemIds.emplace_back(3000 + below(ItemCount / 4));
+		pb.AmmoIds.emplace_back(4000 + below(20));
+	}
+
+	// Loaded both ways, the compiled rules the way LoadSettingsAfterStartup does it
+	for (const auto& pb : config)
+	{
+		playerBonus.emplace(pb.LootId, pb);
+
+		CompiledPlayerBonus compiled;
+		compiled.LootId = pb.LootId;
+		compiled.Bonus = pb.Bonus;
+		compiled.RepId = pb.RepId;
+		compiled.ItemIds = pb.ItemIds;
+		std::ranges::sort(compiled.ItemIds);
+		compiled.ItemIds.erase(std::ranges::unique(compiled.ItemIds).begin(), compiled.ItemIds.end());
+		compiled.AmmoIds = pb.AmmoIds;
+		compiled.ShipIds = pb.ShipIds;
+		for (const auto shipId : pb.ShipIds)
+			playerBonusByShip[shipId].emplace_back(compiled);
+	}
+
+	std::vector<Client> clients(ClientCount);
+	for (auto& client : clients)
+	{
+		client.shipId = 2000 + below(ShipCount);
+		client.repGroupId = 500 + below(3);
+		for (int i = 0; i < CargoCount; i++)
+			client.cargo.push_back({static_cast<uint>(i), 1, 3000 + below(ItemCount), 1.0f, false, below(3) != 0});
+	}
+
+	size_t mismatches = 0;
+	for (const auto& client : clients)
+		mismatches += MatchByScanning(client) != MatchCompiled(client);
+
+	size_t scannedMatches = 0;
+	size_t compiledMatches = 0;
+	const double scanned = MicrosecondsPerClient(clients, MatchByScanning, scannedMatches);
+	const double compiled = MicrosecondsPerClient(clients, MatchCompiled, compiledMatches);
+
+	printf("%d rules, %d cargo items, %zu bonuses matched\n", RuleCount, CargoCount, compiledMatches);
+	printf("scan every rule:  %9.2f us per CheckClientSetup\n", scanned);
+	printf("compiled by ship: %9.2f us per CheckClientSetup\n", compiled);
+	printf("speedup:          %9.1fx\n", scanned / compiled);
+	if (mismatches)
+		printf("FAILED: %zu clients got different bonuses\n", mismatches);
+	return mismatches != 0 || scannedMatches != compiledMatches;
+}
@@ -0,0 +1,187 @@
+// Tests of the zone reserve log format, replay and writer:
+//   g++ -std=c++20 -O2 -pthread -o reserve_log_test ReserveLogTest.cpp ../ReserveLog.cpp
+//   ./reserve_log_test
+// Exits with the number of failed checks.
+
+#include "../ReserveLog.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+
+using namespace Plugins::MiningControl::ReserveLog;
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			failures++;
+		}
+	}
+
+	//! A version 1 log header
+	std::vector<char> Header()
+	{
+		std::vector<char> data = {'F', 'L', 'R', 'L'};
+		const uint32_t version = 1;
+		data.insert(data.end(), reinterpret_cast<const char*>(&version), reinterpret_cast<const char*>(&version) + sizeof(version));
+		return data;
+	}
+
+	std::vector<Entry> Sample() { return {{0x1234, 1000.0f, 0.0f}, {0x5678, 250.5f, 12.25f}, {0x1234, 990.0f, 10.0f}}; }
+
+	bool Equal(const Entry& a, const Entry& b) { return a.zoneId == b.zoneId && a.currentReserve == b.currentReserve && a.mined == b.mined; }
+
+	bool Equal(const std::vector<Entry>& a, const std::vector<Entry>& b)
+	{
+		return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const Entry& x, const Entry& y) { return Equal(x, y); });
+	}
+
+	std::vector<char> Log(const std::vector<Entry>& entries)
+	{
+		auto data = Header();
+		for (const auto& entry : entries)
+			Encode(data, entry);
+		return data;
+	}
+
+	std::vector<char> Read(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+	}
+
+	void Write(const std::filesystem::path& path, const std::vector<char>& data)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(data.data(), static_cast<std::streamsize>(data.size()));
+	}
+
+	void TestFormat()
+	{
+		std::vector<char> record;
+		Encode(record, Sample()[0]);
+		Check(record.size() == 16, "a record is a zone id, two floats and a hash");
+
+		uint32_t zoneId;
+		float currentReserve;
+		std::memcpy(&zoneId, record.data(), sizeof(zoneId));
+		std::memcpy(&currentReserve, record.data() + 4, sizeof(currentReserve));
+		Check(zoneId == 0x1234 && currentReserve == 1000.0f, "a record starts with the zone id and the current reserve");
+
+		Check(Equal(Decode(Log(Sample())), Sample()), "encoded entries decode to the same entries");
+		Check(Decode(Header()).empty(), "a log with only a header holds no entries");
+		Check(Decode({}).empty(), "an empty file holds no entries");
+	}
+
+	void TestCorruption()
+	{
+		const auto data = Log(Sample());
+
+		auto torn = data;
+		torn.resize(torn.size() - 5);
+		Check(Equal(Decode(torn), {Sample()[0], Sample()[1]}), "a torn last record is dropped and the records before it are kept");
+
+		auto flipped = data;
+		flipped[Header().size() + 16 + 6] ^= 0x10;
+		Check(Equal(Decode(flipped), {Sample()[0]}), "decoding stops at a record with a flipped bit");
+
+		auto foreign = data;
+		foreign[0] = 'X';
+		Check(Decode(foreign).empty(), "a file without the magic holds no entries");
+
+		auto newer = data;
+		newer[4] = 2;
+		Check(Decode(newer).empty(), "a log of an unknown version holds no entries");
+	}
+
+	void TestReplay()
+	{
+		const auto path = std::filesystem::temp_directory_path() / "reserve_log_test_replay.bin";
+		std::filesystem::remove(path);
+		Check(Replay(path).empty(), "a missing log replays to nothing");
+
+		Write(path, Log(Sample()));
+		const auto latest = Replay(path);
+		Check(latest.size() == 2, "replay yields one entry per zone");
+		Check(latest.contains(0x1234) && Equal(latest.at(0x1234), Sample()[2]), "the latest entry of a zone wins");
+		Check(latest.contains(0x5678) && Equal(latest.at(0x5678), Sample()[1]), "a zone logged once keeps its entry");
+
+		std::filesystem::remove(path);
+	}
+
+	void TestWriter()
+	{
+		const auto path = std::filesystem::temp_directory_path() / "reserve_log_test_writer.bin";
+		std::filesystem::remove(path);
+
+		{
+			Writer writer(path);
+			writer.Append({Sample()[0], Sample()[1]});
+			writer.Append({});
+			writer.Stop();
+		}
+		Check(Read(path) == Log({Sample()[0], Sample()[1]}), "the writer creates the log and appends entries in order");
+
+		// A crash mid-append leaves part of a record behind
+		auto data = Read(path);
+		data.insert(data.end(), {'a', 'b', 'c'});
+		Write(path, data);
+		{
+			Writer writer(path);
+			writer.Append({Sample()[2]});
+			writer.Stop();
+		}
+		Check(Equal(Decode(Read(path)), Sample()), "reopening cuts a torn record off so later entries are not hidden behind it");
+		Check(Read(path).size() == Log(Sample()).size(), "no trace of the torn record is left");
+
+		{
+			Writer writer(path);
+			writer.Compact([] { return false; });
+			writer.Stop();
+		}
+		Check(Equal(Decode(Read(path)), Sample()), "the log is kept when the snapshot could not be written");
+
+		bool snapshotWritten = false;
+		{
+			Writer writer(path);
+			writer.Append({{0x9999, 1.0f, 2.0f}});
+			writer.Compact([&snapshotWritten, &path] {
+				// Everything appended before the compaction is on disk by the time the snapshot is written
+				snapshotWritten = Decode(Read(path)).size() == Sample().size() + 1;
+				return true;
+			});
+			writer.Append({Sample()[1]});
+			writer.Stop();
+		}
+		Check(snapshotWritten, "the snapshot is written after the entries queued before it");
+		Check(Equal(Decode(Read(path)), {Sample()[1]}), "a compaction starts the log over and keeps later entries");
+
+		Write(path, {'n', 'o', 't', ' ', 'a', ' ', 'l', 'o', 'g'});
+		{
+			Writer writer(path);
+			writer.Stop();
+		}
+		Check(Read(path) == Header(), "a file that is not a reserve log is started over");
+
+		std::filesystem::remove(path);
+	}
+} // namespace
+
+int main()
+{
+	TestFormat();
+	TestCorruption();
+	TestReplay();
+	TestWriter();
+
+	if (!failures)
+		std::printf("All reserve log tests passed.\n");
+	return failures;
+}
@@ -45,6 +45,7 @@
  *     "npcInfocardIds": [
  *         197808
  *     ],
+ *     "randomSeed": 0,
  *     "startupNpcs": [
  *         {
  *             "name": "example",
@@ -81,7 +82,7 @@ namespace Plugins::Npc
 	 */
 	float RandomFloatRange(float a, float b)
 	{
-		return ((b - a) * (static_cast<float>(rand()) / RAND_MAX)) + a;
+		return global->randomStream.FloatRange(a, b);
 	}
 
 	/** @ingroup NPCControl
@@ -89,7 +90,7 @@ namespace Plugins::Npc
 	 */
 	uint RandomInfocardID()
 	{
-		int randomIndex = rand() % global->config->npcInfocardIds.size();
+		const uint randomIndex = global->randomStream.Below(static_cast<uint>(global->config->npcInfocardIds.size()));
 		return global->config->npcInfocardIds.at(randomIndex);
 	}
 
@@ -251,7 +252,12 @@ namespace Plugins::Npc
 			npc.rotationMatrix = EulerMatrix({npc.rotation[0], npc.rotation[1], npc.rotation[2]});
 		}
 
+		global->randomStream.Reseed("NPCControl", config.randomSeed);
 		global->config = std::make_unique<Config>(config);
+
+		global->onlinePlayers.Clear();
+		for (const auto& player : Hk::Admin::GetPlayers())
+			global->onlinePlayers.Add(player.client, player.character);
 	}
 
 	/** @ingroup NPCControl
@@ -261,10 +267,6 @@ namespace Plugins::Npc
 	{
 		LoadSettings();
 
-		// Initalize for random number generator (new C++ 11 standard)
-		std::random_device rd; // Used to obtain a seed
-		std::mt19937 mt(rd()); //  Mersenne Twister algorithm seeded with the variable above
-		std::uniform_real_distribution<float> dist(0.0f, 1.0f);
 		int spawned = 0;
 
 		for (const auto& npc : global->config->startupNpcs)
@@ -277,7 +279,7 @@ namespace Plugins::Npc
 			}
 
 			// Spawn NPC if spawn chance allows it
-			if (dist(mt) <= npc.spawnChance)
+			if (global->randomStream.Float() <= npc.spawnChance)
 			{
 				CreateNPC(npc.name, npc.positionVector, npc.rotationMatrix, npc.systemId, false);
 				spawned++;
@@ -307,11 +309,15 @@ namespace Plugins::Npc
 			return;
 		}
 
-		const auto ship = Hk::Player::GetShip(Hk::Client::GetClientIdFromCharName(cmds->GetAdminName()).value());
+		const auto client = global->onlinePlayers.Find(cmds->GetAdminName());
+		if (!client)
+			return;
+
+		const auto ship = Hk::Player::GetShip(client.value());
 		if (!ship.has_value())
 			return;
 
-		SystemId system = Hk::Player::GetSystem(Hk::Client::GetClientIdFromCharName(cmds->GetAdminName()).value()).value();
+		SystemId system = Hk::Player::GetSystem(client.value()).value();
 
 		auto [position, rotation] = Hk::Solar::GetLocation(ship.value(), IdType::Ship).value();
 
@@ -365,7 +371,11 @@ namespace Plugins::Npc
 			return;
 		}
 
-		if (auto ship = Hk::Player::GetShip(Hk::Client::GetClientIdFromCharName(commands->GetAdminName()).value()); ship.has_value())
+		const auto client = global->onlinePlayers.Find(commands->GetAdminName());
+		if (!client)
+			return;
+
+		if (auto ship = Hk::Player::GetShip(client.value()); ship.has_value())
 		{
 			auto [pos, rot] = Hk::Solar::GetLocation(ship.value(), IdType::Ship).value();
 
@@ -410,25 +420,19 @@ namespace Plugins::Npc
 		}
 
 		// If no player specified follow the admin
-		uint client;
 		if (characterName == L"")
-		{
-			client = Hk::Client::GetClientIdFromCharName(commands->GetAdminName()).value();
 			characterName = commands->GetAdminName();
-		}
-		// Follow the player specified
-		else
-			client = Hk::Client::GetClientIdFromCharName(characterName).value();
 
-		if (client == UINT_MAX)
+		const auto client = global->onlinePlayers.Find(characterName);
+		if (!client)
 			commands->Print(std::format("{} is not online", wstos(characterName)));
 
 		else
 		{
-			const auto ship = Hk::Player::GetShip(client);
+			const auto ship = Hk::Player::GetShip(client.value());
 			if (ship.has_value())
 			{
-				if (const auto target = Hk::Player::GetTarget(client); target.has_value())
+				if (const auto target = Hk::Player::GetTarget(client.value()); target.has_value())
 				{
 					if (const auto it = std::ranges::find(global->spawnedNpcs, target.value()); target.value() && it != global->spawnedNpcs.end())
 					{
@@ -536,6 +540,23 @@ namespace Plugins::Npc
 		}
 	}
 
+	/** @ingroup NPCControl
+	 * @brief Hook on CharacterSelect to index the character for the admin commands
+	 */
+	void CharacterSelect([[maybe_unused]] const std::string& charFilename, ClientId& client)
+	{
+		if (const auto charName = (const wchar_t*)Players.GetActiveCharacterName(client))
+			global->onlinePlayers.Add(client, charName);
+	}
+
+	/** @ingroup NPCControl
+	 * @brief Hook on DisConnect to drop the character from the index
+	 */
+	void DisConnect(ClientId& client, [[maybe_unused]] const enum EFLConnection& state)
+	{
+		global->onlinePlayers.Remove(client);
+	}
+
 	/** @ingroup NPCControl
 	 * @brief Admin command processing
 	 */
@@ -580,7 +601,7 @@ DefaultDllMainSettings(AfterStartup);
 REFL_AUTO(type(Npc), field(shipArch), field(loadout), field(iff), field(infocardId), field(infocard2Id), field(pilot), field(graph));
 REFL_AUTO(type(Fleet), field(name), field(member));
 REFL_AUTO(type(StartupNpc), field(name), field(system), field(position), field(rotation), field(spawnChance));
-REFL_AUTO(type(Config), field(npcInfo), field(fleetInfo), field(startupNpcs), field(npcInfocardIds));
+REFL_AUTO(type(Config), field(npcInfo), field(fleetInfo), field(startupNpcs), field(npcInfocardIds), field(randomSeed));
 
 extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 {
@@ -593,6 +614,8 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 	pi->emplaceHook(HookedCall::IServerImpl__Startup, &AfterStartup, HookStep::After);
 	pi->emplaceHook(HookedCall::FLHook__AdminCommand__Process, &ExecuteCommandString);
 	pi->emplaceHook(HookedCall::IEngine__ShipDestroyed, &ShipDestroyed);
+	pi->emplaceHook(HookedCall::IServerImpl__CharacterSelect, &CharacterSelect, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__DisConnect, &DisConnect);
 
 	// Register IPC
 	global->communicator = new NpcCommunicator(NpcCommunicator::pluginName);
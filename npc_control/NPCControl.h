@@ -4,7 +4,8 @@
 #include <spdlog/logger.h>
 #include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
-#include <random>
+#include "../common/PlayerIndex.h"
+#include "../common/Random.h"
 
 namespace Plugins::Npc
 {
@@ -56,6 +57,8 @@ namespace Plugins::Npc
 		std::vector<StartupNpc> startupNpcs = {StartupNpc()};
 		//! Vector containing Infocard Ids used for naming npcs
 		std::vector<uint> npcInfocardIds {197808};
+		//! Seed for spawn chances, positions and names so a session can be replayed. 0 picks a random seed on every load.
+		uint randomSeed = 0;
 		//! The config file we load out of
 		std::string File() override { return "config/npc.json"; }
 	};
@@ -81,5 +84,8 @@ namespace Plugins::Npc
 		std::shared_ptr<spdlog::logger> Log = nullptr;
 		uint dockNpc = 0;
 		NpcCommunicator* communicator = nullptr;
+		Random::Stream randomStream {"NPCControl"};
+		//! The characters that are online by name, maintained on character select and disconnect
+		PlayerIndex::Index onlinePlayers;
 	};
 } // namespace Plugins::Npc
@@ -41,15 +41,112 @@
 namespace Plugins::Rename
 {
 	const auto global = std::make_unique<Global>();
-	void LoadSettings()
+
+	//! Runs a rename or move on the worker thread. Either can run again after a crash, so both check what a previous attempt already did.
+	void RunJob(const CharacterJobs::Job& job)
 	{
-		global->tagList = Serializer::JsonToObject<TagList>();
-		global->config = std::make_unique<Config>(Serializer::JsonToObject<Config>());
+		const std::string sourceFile = wstos(job.Arg("sourceFile"));
+		const std::string destFile = wstos(job.Arg("destFile"));
+
+		if (job.kind == "rename")
+		{
+			// Only the renamed file is left if the rename went through before
+			if (!std::filesystem::exists(sourceFile))
+			{
+				if (std::filesystem::exists(destFile))
+					return;
+				throw "src does not exist";
+			}
+
+			// Read the char file, update the char name and write it under its new name
+			CharacterJobs::CharacterFile file(sourceFile);
+			file.SetW("Player", "Name", job.Arg("newCharName"));
+			file.Write(destFile);
+			if (!::DeleteFileA(sourceFile.c_str()))
+				throw "src still exists";
+		}
+		else if (job.kind == "move")
+		{
+			if (std::filesystem::exists(sourceFile) && !::MoveFileExA(sourceFile.c_str(), destFile.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+				throw "move failed";
+			if (std::filesystem::exists(sourceFile))
+				throw "src still exists";
+			if (!std::filesystem::exists(destFile))
+				throw "dest does not exist";
+
+			const std::string oldRenameFile = wstos(job.Arg("oldAccountDir")) + "\\rename.ini";
+			const std::string movingCharName = wstos(job.Arg("movingCharName"));
+			if (std::wstring oldCharRenameLimit = IniGetWS(oldRenameFile, "General", movingCharName, L""); !oldCharRenameLimit.empty())
+			{
+				IniWriteW(wstos(job.Arg("newAccountDir")) + "\\rename.ini", "General", movingCharName, oldCharRenameLimit);
+				IniDelete(oldRenameFile, "General", movingCharName);
+			}
+		}
 	}
 
-	void SaveSettings()
+	//! Unlocks the accounts of a rename or move and logs its outcome on the game thread
+	void CompleteJob(const CharacterJobs::Job& job, const std::string& error)
 	{
-		Serializer::SaveToJson(global->tagList);
+		global->accountLocks.Release(job.id);
+
+		if (job.kind == "rename")
+		{
+			if (!error.empty())
+			{
+				AddLog(LogType::Normal,
+				    LogLevel::Err,
+				    wstos(std::format(
+				        L"User rename failed ({}) from {} to {} ({})", stows(error), job.Arg("charName"), job.Arg("newCharName"), job.Arg("accountId"))));
+				return;
+			}
+
+			// Update any mail references this character had before
+			MailManager::i()->UpdateCharacterName(wstos(job.Arg("charName")), wstos(job.Arg("newCharName")));
+
+			// The rename worked. Log it.
+			AddLog(LogType::Normal,
+			    LogLevel::Info,
+			    wstos(std::format(L"User rename {} to {} ({})", job.Arg("charName"), job.Arg("newCharName"), job.Arg("accountId"))));
+		}
+		else if (job.kind == "move")
+		{
+			if (!error.empty())
+			{
+				AddLog(LogType::Normal,
+				    LogLevel::Err,
+				    wstos(std::format(L"Character {} move failed ({}) from {} to {}",
+				        job.Arg("movingCharName"),
+				        stows(error),
+				        job.Arg("oldAccountId"),
+				        job.Arg("newAccountId"))));
+				return;
+			}
+
+			// The move worked. Log it.
+			AddLog(LogType::Normal,
+			    LogLevel::Info,
+			    wstos(std::format(L"Character {} moved from {} to {}", job.Arg("movingCharName"), job.Arg("oldAccountId"), job.Arg("newAccountId"))));
+		}
+	}
+
+	//! Stops the job worker on the game thread and writes the tag changes into tags.json, before the plugin is unloaded with the server
+	void Shutdown()
+	{
+		if (global->jobs)
+			global->jobs->Stop();
+
+		global->tags.CompactIfChanged();
+	}
+
+	void LoadSettings()
+	{
+		global->tags.Load();
+		global->config = std::make_unique<Config>(Serializer::JsonToObject<Config>());
+
+		// Stop the worker of a previous load first, whatever it did not get to stays in the journal for the new one
+		if (global->jobs)
+			global->jobs->Stop();
+		global->jobs = std::make_unique<CharacterJobs::Queue>(CoreGlobals::c()->accPath + "rename_jobs.log", RunJob, CompleteJob);
 	}
 
 	bool CreateNewCharacter(SCreateCharacterInfo const& si, ClientId& client)
@@ -58,7 +155,7 @@ namespace Plugins::Rename
 		{
 			// If this ship name starts with a restricted tag then the ship may only be created using rename and the faction password
 			const std::wstring charName(si.wszCharname);
-			if (const auto& tag = global->tagList.FindTagPartial(charName); tag != global->tagList.tags.end() && !tag->renamePassword.empty())
+			if (const auto tag = global->tags.FindPrefixOf(charName); tag && !tag->renamePassword.empty())
 			{
 				Server.CharacterInfoReq(client, true);
 				return true;
@@ -110,9 +207,10 @@ namespace Plugins::Rename
 			return;
 
 		const auto charName = Hk::Client::GetCharacterNameByID(client);
-		if (const auto& tag = global->tagList.FindTagPartial(charName.value()); tag != global->tagList.tags.end() && !tag->renamePassword.empty())
+		if (const auto tag = global->tags.FindPrefixOf(charName.value()); tag && !tag->renamePassword.empty())
 		{
-			tag->lastAccess = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+			global->tags.Touch(
+			    *tag, std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
 		}
 	}
 
@@ -166,13 +264,10 @@ namespace Plugins::Rename
 		}
 
 		// If this tag is in use then reject the request.
-		for (const auto& i : global->tagList.tags)
+		if (global->tags.Conflicts(tag))
 		{
-			if (tag.find(i.tag) == 0 || i.tag.find(tag) == 0)
-			{
-				PrintUserCmdText(client, L"ERR Tag already exists or conflicts with existing tag");
-				return;
-			}
+			PrintUserCmdText(client, L"ERR Tag already exists or conflicts with existing tag");
+			return;
 		}
 
 		// Save character and exit if kicked on save.
@@ -196,13 +291,12 @@ namespace Plugins::Rename
 		data.lastAccess = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 		data.description = description;
 		data.tag = tag;
-		global->tagList.tags.emplace_back(data);
+		global->tags.Put(data);
 
 		PrintUserCmdText(client, std::format(L"Created faction tag {} with master password {}", tag, pass));
 		AddLog(LogType::Normal,
 		    LogLevel::Info,
 		    wstos(std::format(L"Tag {} created by {} ({})", tag.c_str(), charName.value().c_str(), Hk::Client::GetAccountIdByClientID(client).c_str())));
-		SaveSettings();
 	}
 
 	void UserCmd_DropTag(ClientId& client, const std::wstring& param)
@@ -228,11 +322,9 @@ namespace Plugins::Rename
 		std::wstring pass = GetParam(param, ' ', 1);
 
 		// If this tag is in use then reject the request.
-		if (const auto& data = global->tagList.FindTag(tag); data != global->tagList.tags.end() && pass == data->masterPassword)
+		if (const auto data = global->tags.Find(tag); data && pass == data->masterPassword)
 		{
-			const auto [first, last] = std::ranges::remove_if(global->tagList.tags, [&tag](const TagData& tg) { return tg.tag == tag; });
-			global->tagList.tags.erase(first, last);
-			SaveSettings();
+			global->tags.Drop(tag);
 			PrintUserCmdText(client, L"OK Tag dropped");
 			AddLog(LogType::Normal,
 			    LogLevel::Info,
@@ -262,10 +354,11 @@ namespace Plugins::Rename
 			const std::wstring renamePassword = GetParam(param, ' ', 2);
 
 			// If this tag is in use then reject the request.
-			if (const auto& data = global->tagList.FindTag(tag); data != global->tagList.tags.end() && masterPassword == data->masterPassword)
+			if (const auto data = global->tags.Find(tag); data && masterPassword == data->masterPassword)
 			{
-				data->renamePassword = renamePassword;
-				SaveSettings();
+				TagData changed = *data;
+				changed.renamePassword = renamePassword;
+				global->tags.Put(changed);
 				PrintUserCmdText(client, std::format(L"OK Created rename password {} for tag {}", renamePassword, tag));
 				return;
 			}
@@ -279,7 +372,9 @@ namespace Plugins::Rename
 
 	void RenameTimer()
 	{
-		// Check for pending renames and execute them. We do this on a timer so that
+		global->jobs->Drain();
+
+		// Hand pending renames to the worker. We do this on a timer so that
 		// the player is definitely not online when we do the rename.
 		while (!global->pendingRenames.empty())
 		{
@@ -289,56 +384,21 @@ namespace Plugins::Rename
 
 			global->pendingRenames.erase(global->pendingRenames.begin());
 
-			CAccount* acc = Hk::Client::GetAccountByCharName(o.charName).value();
-
-			// Delete the character from the existing account, create a new
-			// character with the same name in this account and then copy over it
-			// with the save character file.
-			try
-			{
-				if (!acc)
-					throw "no acc";
-
-				Hk::Client::LockAccountAccess(acc, true);
-				Hk::Client::UnlockAccountAccess(acc);
-
-				// Move files around
-				if (!::MoveFileExA(o.sourceFile.c_str(), o.destFile.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
-					throw "move failed";
-				if (std::filesystem::exists(o.sourceFile.c_str()))
-					throw "src still exists";
-				if (!std::filesystem::exists(o.destFile.c_str()))
-					throw "dest does not exist";
-
-				// Decode the char file, update the char name and re-encode it.
-				// Add a space to the value so the ini file line looks like "<key> =
-				// <value>" otherwise Ioncross Server Operator can't decode the file
-				// correctly
-				FlcDecodeFile(o.destFile.c_str(), o.destFile.c_str());
-				IniWriteW(o.destFile, "Player", "Name", o.newCharName);
-				if (!FLHookConfig::i()->general.disableCharfileEncryption)
-				{
-					FlcEncodeFile(o.destFile.c_str(), o.destFile.c_str());
-				}
-
-				// Update any mail references this character had before
-				MailManager::i()->UpdateCharacterName(wstos(o.charName), wstos(o.newCharName));
-
-				// The rename worked. Log it and save the rename time.
-				AddLog(LogType::Normal,
-				    LogLevel::Info,
-				    wstos(std::format(L"User rename {} to {} ({})", o.charName.c_str(), o.newCharName.c_str(), Hk::Client::GetAccountID(acc).value().c_str())));
-			}
-			catch (char* err)
+			const auto acc = Hk::Client::GetAccountByCharName(o.charName);
+			if (acc.has_error())
 			{
-				AddLog(LogType::Normal,
-				    LogLevel::Err,
-				    wstos(std::format(L"User rename failed ({}) from {} to {} ({})",
-				        stows(err),
-				        o.charName.c_str(),
-				        o.newCharName.c_str(),
-				        Hk::Client::GetAccountID(acc).value().c_str())));
+				AddLog(LogType::Normal, LogLevel::Err, wstos(std::format(L"User rename failed (no acc) from {} to {}", o.charName, o.newCharName)));
+				continue;
 			}
+
+			CharacterJobs::Job job;
+			job.kind = "rename";
+			job.args = {{"charName", o.charName},
+			    {"newCharName", o.newCharName},
+			    {"sourceFile", stows(o.sourceFile)},
+			    {"destFile", stows(o.destFile)},
+			    {"accountId", Hk::Client::GetAccountID(acc.value()).value()}};
+			global->accountLocks.Lock(global->jobs->Submit(std::move(job)), acc.value());
 		}
 
 		while (!global->pendingMoves.empty())
@@ -352,57 +412,30 @@ namespace Plugins::Rename
 			CAccount* acc = Hk::Client::GetAccountByCharName(o.destinationCharName).value();
 			CAccount* oldAcc = Hk::Client::GetAccountByCharName(o.movingCharName).value();
 
-			// Delete the character from the existing account, create a new
-			// character with the same name in this account and then copy over it
-			// with the save character file.
-			try
-			{
-				Hk::Client::LockAccountAccess(acc, true);
-				Hk::Client::UnlockAccountAccess(acc);
-
-				Hk::Client::LockAccountAccess(oldAcc, true);
-				Hk::Client::UnlockAccountAccess(oldAcc);
-
-				// Move files around
-				if (!::MoveFileExA(o.sourceFile.c_str(), o.destFile.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
-					throw "move failed";
-				if (std::filesystem::exists(o.sourceFile.c_str()))
-					throw "src still exists";
-				if (!std::filesystem::exists(o.destFile.c_str()))
-					throw "dest does not exist";
-
-				std::string oldAccDir = CoreGlobals::c()->accPath + wstos(Hk::Client::GetAccountDirName(oldAcc));
-
-				if (std::wstring oldCharRenameLimit = IniGetWS(oldAccDir + "\\rename.ini", "General", wstos(o.movingCharName), L"");
-				    !oldCharRenameLimit.empty())
-				{
-					std::string newAccDir = CoreGlobals::c()->accPath + wstos(Hk::Client::GetAccountDirName(acc));
-					IniWriteW(newAccDir + "\\rename.ini", "General", wstos(o.movingCharName), oldCharRenameLimit);
-					IniDelete(oldAccDir + "\\rename.ini", "General", wstos(o.movingCharName));
-				}
-
-				// The move worked. Log it.
-				AddLog(LogType::Normal,
-				    LogLevel::Info,
-				    wstos(std::format(L"Character {} moved from {} to {}",
-				        o.movingCharName.c_str(),
-				        Hk::Client::GetAccountID(oldAcc).value().c_str(),
-				        Hk::Client::GetAccountID(acc).value().c_str())));
-			}
-			catch (char* err)
-			{
-				AddLog(LogType::Normal,
-				    LogLevel::Err,
-				    wstos(std::format(L"Character {} move failed ({}) from {} to {}",
-				        o.movingCharName,
-				        stows(std::string(err)),
-				        Hk::Client::GetAccountID(oldAcc).value().c_str(),
-				        Hk::Client::GetAccountID(acc).value().c_str())));
-			}
+			CharacterJobs::Job job;
+			job.kind = "move";
+			job.args = {{"movingCharName", o.movingCharName},
+			    {"sourceFile", stows(o.sourceFile)},
+			    {"destFile", stows(o.destFile)},
+			    {"oldAccountDir", stows(CoreGlobals::c()->accPath) + Hk::Client::GetAccountDirName(oldAcc)},
+			    {"newAccountDir", stows(CoreGlobals::c()->accPath) + Hk::Client::GetAccountDirName(acc)},
+			    {"oldAccountId", Hk::Client::GetAccountID(oldAcc).value()},
+			    {"newAccountId", Hk::Client::GetAccountID(acc).value()}};
+
+			// Keep both accounts locked until the file has moved
+			const uint64_t jobId = global->jobs->Submit(std::move(job));
+			global->accountLocks.Lock(jobId, acc);
+			global->accountLocks.Lock(jobId, oldAcc);
 		}
 	}
 
-	const std::vector<Timer> timers = {{RenameTimer, 5}};
+	//! Writes the tags and their last access times to tags.json, so the change log stays short
+	void CompactTags()
+	{
+		global->tags.CompactIfChanged();
+	}
+
+	const std::vector<Timer> timers = {{RenameTimer, 5}, {CompactTags, 600}};
 
 	void UserCmd_Rename(ClientId& client, const std::wstring& param)
 	{
@@ -459,23 +492,19 @@ namespace Plugins::Rename
 		{
 			std::wstring password = Trim(GetParam(param, L' ', 1));
 
-			for (const auto& i : global->tagList.tags)
+			if (const auto tag = global->tags.FindPrefixOf(newCharName); tag && !tag->renamePassword.empty())
 			{
-				if (newCharName.find(i.tag) == 0 && !i.renamePassword.empty())
+				if (!password.length())
 				{
-					if (!password.length())
-					{
-						PrintUserCmdText(client, L"ERR Name starts with an owned tag. Password is required.");
-						return;
-					}
-					else if (password != i.masterPassword && password != i.renamePassword)
-					{
-						PrintUserCmdText(client, L"ERR Name starts with an owned tag. Password is wrong.");
-						return;
-					}
-					// Password is valid for owned tag.
-					break;
+					PrintUserCmdText(client, L"ERR Name starts with an owned tag. Password is required.");
+					return;
 				}
+				else if (password != tag->masterPassword && password != tag->renamePassword)
+				{
+					PrintUserCmdText(client, L"ERR Name starts with an owned tag. Password is wrong.");
+					return;
+				}
+				// Password is valid for owned tag.
 			}
 		}
 
@@ -792,8 +821,11 @@ namespace Plugins::Rename
 		}
 
 		const auto curr_time = Hk::Time::GetUnixSeconds();
-		for (const auto& tag : global->tagList.tags)
+		for (const auto& tag : global->tags.Slots())
 		{
+			if (tag.tag.empty())
+				continue;
+
 			auto last_access = static_cast<int>(tag.lastAccess);
 			int days = (curr_time - last_access) / (24 * 3600);
 			cmds->Print(wstos(std::format(L"tag={} master_password={} rename_password={} last_access={} days description={}\n",
@@ -833,7 +865,7 @@ namespace Plugins::Rename
 		}
 
 		// If this tag is in use then reject the request.
-		if (global->tagList.FindTagPartial(tag) == global->tagList.tags.end())
+		if (global->tags.Conflicts(tag))
 		{
 			cmds->Print("ERR Tag already exists or conflicts with another tag\n");
 			return;
@@ -846,8 +878,7 @@ namespace Plugins::Rename
 		data.lastAccess = Hk::Time::GetUnixSeconds();
 		data.description = description;
 		cmds->Print(wstos(std::format(L"Created faction tag {} with master password {}", tag, password)));
-		global->tagList.tags.emplace_back(data);
-		SaveSettings();
+		global->tags.Put(data);
 	}
 
 	void AdminCmd_DropTag(CCmds* cmds, const std::wstring& tag)
@@ -858,12 +889,8 @@ namespace Plugins::Rename
 			return;
 		}
 
-		if (global->tagList.FindTag(tag) != global->tagList.tags.end())
+		if (global->tags.Drop(tag))
 		{
-			auto [first, last] = std::ranges::remove_if(global->tagList.tags, [&tag](const TagData& tg) { return tg.tag == tag; });
-
-			global->tagList.tags.erase(first, last);
-			SaveSettings();
 			cmds->Print("OK Tag dropped");
 			return;
 		}
@@ -926,14 +953,173 @@ namespace Plugins::Rename
 		return true;
 	}
 
-	std::vector<TagData>::iterator TagList::FindTag(const std::wstring& tag)
+	std::string TagStore::LogFile()
 	{
-		return std::ranges::find_if(tags, [&tag](const TagData& data) { return data.tag == tag; });
+		return std::filesystem::path(TagList().File()).replace_extension(".log").string();
+	}
+
+	void TagStore::Load()
+	{
+		slots.clear();
+		freeSlots.clear();
+		index.Clear();
+		loggedChanges = 0;
+		touched = false;
+
+		for (const auto& data : Serializer::JsonToObject<TagList>().tags)
+		{
+			if (data.tag.empty())
+				continue;
+
+			// Tags are matched case-insensitively, so a second spelling of a tag could never be found and would shadow the first
+			if (const auto existing = index.Find(data.tag); existing.has_value())
+			{
+				AddLog(LogType::Normal,
+				    LogLevel::Err,
+				    wstos(std::format(L"tags.json holds both {} and {}, which only differ in case. {} is ignored and dropped on the next save.",
+				        slots[existing.value()].tag,
+				        data.tag,
+				        data.tag)));
+				continue;
+			}
+
+			index.Insert(data.tag, static_cast<uint32_t>(slots.size()));
+			slots.emplace_back(data);
+		}
+
+		// Replay the changes made since tags.json was last written. Replaying a change twice gives the same result, so a crash between
+		// writing tags.json and emptying the log loses nothing.
+		std::ifstream log(LogFile(), std::ios::binary);
+		const std::string data((std::istreambuf_iterator<char>(log)), std::istreambuf_iterator<char>());
+
+		// Anything after the last line break was cut short by a crash mid-append and is ignored
+		for (size_t start = 0, end; (end = data.find('\n', start)) != std::string::npos; start = end + 1)
+		{
+			if (const auto entry = TagLog::Parse(std::string_view(data).substr(start, end - start)); entry.has_value())
+			{
+				Apply(entry.value());
+				loggedChanges++;
+			}
+		}
+
+		// Cut the torn line off, otherwise the next change would be appended to it and be lost with it
+		if (const size_t complete = data.rfind('\n') + 1; complete != data.size())
+		{
+			log.close();
+			std::error_code ec;
+			std::filesystem::resize_file(LogFile(), complete, ec);
+		}
+	}
+
+	void TagStore::Compact()
+	{
+		TagList snapshot;
+		std::ranges::copy_if(slots, std::back_inserter(snapshot.tags), [](const TagData& data) { return !data.tag.empty(); });
+		// The log may only be emptied once its changes are safely in tags.json
+		if (!JsonFile::Save(snapshot))
+		{
+			AddLog(LogType::Normal, LogLevel::Err, std::format("Unable to write {}, keeping the tag change log.", snapshot.File()));
+			return;
+		}
+
+		std::ofstream log(LogFile(), std::ios::trunc);
+		loggedChanges = 0;
+		touched = false;
 	}
 
-	std::vector<TagData>::iterator TagList::FindTagPartial(const std::wstring& tag)
+	void TagStore::CompactIfChanged()
 	{
-		return std::ranges::find_if(tags, [&tag](const TagData& data) { return data.tag.find(tag) || tag.find(data.tag); });
+		if (loggedChanges || touched)
+			Compact();
+	}
+
+	TagData* TagStore::Find(const std::wstring& tag)
+	{
+		const auto id = index.Find(tag);
+		return id.has_value() ? &slots[id.value()] : nullptr;
+	}
+
+	TagData* TagStore::FindPrefixOf(const std::wstring& charName)
+	{
+		const auto id = index.FindPrefixOf(charName);
+		return id.has_value() ? &slots[id.value()] : nullptr;
+	}
+
+	void TagStore::Put(const TagData& data)
+	{
+		const TagLog::Entry entry {false, data.tag, data.masterPassword, data.renamePassword, data.lastAccess, data.description};
+		Apply(entry);
+		Append(entry);
+	}
+
+	bool TagStore::Drop(const std::wstring& tag)
+	{
+		if (!index.Find(tag).has_value())
+			return false;
+
+		TagLog::Entry entry;
+		entry.drop = true;
+		entry.tag = tag;
+		Apply(entry);
+		Append(entry);
+		return true;
+	}
+
+	void TagStore::Touch(TagData& data, long long lastAccess)
+	{
+		data.lastAccess = lastAccess;
+		touched = true;
+	}
+
+	void TagStore::Apply(const TagLog::Entry& entry)
+	{
+		const auto existing = index.Find(entry.tag);
+		if (entry.drop)
+		{
+			if (!existing.has_value())
+				return;
+
+			index.Erase(entry.tag);
+			slots[existing.value()] = TagData();
+			freeSlots.emplace_back(existing.value());
+			return;
+		}
+
+		uint32_t id;
+		if (existing.has_value())
+			id = existing.value();
+		else if (!freeSlots.empty())
+		{
+			id = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else
+		{
+			id = static_cast<uint32_t>(slots.size());
+			slots.emplace_back();
+		}
+
+		TagData& data = slots[id];
+		data.tag = entry.tag;
+		data.masterPassword = entry.masterPassword;
+		data.renamePassword = entry.renamePassword;
+		data.lastAccess = entry.lastAccess;
+		data.description = entry.description;
+		index.Insert(entry.tag, id);
+	}
+
+	void TagStore::Append(const TagLog::Entry& entry)
+	{
+		std::ofstream log(LogFile(), std::ios::app);
+		log << TagLog::Format(entry) << '\n';
+		log.flush();
+		if (!log)
+			AddLog(LogType::Normal,
+			    LogLevel::Err,
+			    std::format("Unable to append to {}, the change to {} is only kept in memory until the next compaction.", LogFile(), wstos(entry.tag)));
+
+		if (++loggedChanges >= MaxLoggedChanges)
+			Compact();
 	}
 } // namespace Plugins::Rename
 
@@ -951,7 +1137,7 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 {
 	pi->name("Rename");
 	pi->shortName("rename");
-	pi->mayUnload(true);
+	pi->mayUnload(false);
 	pi->commands(&commands);
 	pi->timers(&timers);
 	pi->returnCode(&global->returnCode);
@@ -961,5 +1147,6 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 	pi->emplaceHook(HookedCall::IServerImpl__CreateNewCharacter, &CreateNewCharacter);
 	pi->emplaceHook(HookedCall::IServerImpl__DestroyCharacter, &DeleteCharacter);
 	pi->emplaceHook(HookedCall::FLHook__LoadSettings, &LoadSettings, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__Shutdown, &Shutdown);
 	pi->emplaceHook(HookedCall::FLHook__AdminCommand__Process, &ExecuteCommandString);
 }
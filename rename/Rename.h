@@ -3,6 +3,10 @@
 #include <FLHook.hpp>
 #include <plugin.h>
 
+#include "../common/CharacterJobs.h"
+#include "../common/JsonFile.h"
+#include "TagStore.h"
+
 namespace Plugins::Rename
 {
 	//! Struct to hold a clan/group tag. This contains the passwords used to manage and rename a character to use this tag
@@ -35,7 +39,7 @@ namespace Plugins::Rename
 		std::string destFile;
 	};
 
-	//! A struct to hold all the tags
+	//! A struct to hold all the tags. This is the snapshot the change log is compacted into.
 	struct TagList : Reflectable
 	{
 		std::string File() override
@@ -46,8 +50,50 @@ namespace Plugins::Rename
 		}
 
 		std::vector<TagData> tags;
-		std::vector<TagData>::iterator FindTag(const std::wstring& tag);
-		std::vector<TagData>::iterator FindTagPartial(const std::wstring& tag);
+	};
+
+	//! The registered tags, indexed by a case-folded prefix trie. Every change is appended to a change log next to tags.json, and the log is
+	//! periodically compacted into a fresh tags.json.
+	class TagStore final
+	{
+	  public:
+		//! Reads tags.json and replays the change log on top of it
+		void Load();
+		//! Writes all tags to tags.json and empties the change log
+		void Compact();
+		//! Compacts if anything changed since the last compaction
+		void CompactIfChanged();
+
+		//! The tag with this name, matched case-insensitively
+		TagData* Find(const std::wstring& tag);
+		//! The tag a character name starts with
+		TagData* FindPrefixOf(const std::wstring& charName);
+		//! Whether a new tag would clash with a registered one, that is one of them starts with the other
+		[[nodiscard]] bool Conflicts(const std::wstring& tag) const { return index.Conflicts(tag); }
+
+		//! Adds a tag, or replaces the tag with the same name, and logs the change
+		void Put(const TagData& data);
+		//! Removes a tag and logs the change. Returns false if there is no such tag.
+		bool Drop(const std::wstring& tag);
+		//! Records that a tag is in use. Only written by the next compaction.
+		void Touch(TagData& data, long long lastAccess);
+
+		[[nodiscard]] const std::vector<TagData>& Slots() const { return slots; }
+
+	  private:
+		//! Compact once the log holds this many changes, so replaying it on load stays cheap
+		static constexpr size_t MaxLoggedChanges = 1000;
+
+		std::string LogFile();
+		void Apply(const TagLog::Entry& entry);
+		void Append(const TagLog::Entry& entry);
+
+		//! Tag data by the id the trie holds. A dropped tag leaves an empty slot that the next new tag reuses.
+		std::vector<TagData> slots;
+		std::vector<uint32_t> freeSlots;
+		TagTrie index;
+		size_t loggedChanges = 0;
+		bool touched = false;
 	};
 
 	//! Config data for this plugin
@@ -92,6 +138,10 @@ namespace Plugins::Rename
 		std::unique_ptr<Config> config = nullptr;
 		std::vector<Move> pendingMoves;
 		std::vector<Rename> pendingRenames;
-		TagList tagList;
+		TagStore tags;
+		//! Does the file work of renames and moves once the characters are offline
+		std::unique_ptr<CharacterJobs::Queue> jobs;
+		//! The accounts of characters that are being renamed or moved
+		CharacterJobs::AccountLocks accountLocks;
 	};
 } // namespace Plugins::Rename
\ No newline at end of file
@@ -0,0 +1,289 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cwctype>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Header-only and dependent on the standard library alone, so it can be built and exercised outside the server.
+namespace Plugins::Rename
+{
+	//! Folds a character for case-insensitive tag matching
+	inline wchar_t FoldTagCharacter(wchar_t c)
+	{
+		if (c >= L'A' && c <= L'Z')
+			return static_cast<wchar_t>(c + (L'a' - L'A'));
+		if (c < 0x80)
+			return c;
+		return static_cast<wchar_t>(std::towlower(static_cast<wint_t>(c)));
+	}
+
+	//! Case-folded prefix trie over the registered tags, with a hash map for exact lookups. Every tag carries the id of the slot its data is
+	//! stored in.
+	class TagTrie final
+	{
+	  public:
+		TagTrie() { Clear(); }
+
+		void Clear()
+		{
+			nodes.assign(1, Node {});
+			exact.clear();
+		}
+
+		//! Adds a tag, or changes the id of a tag that is already present
+		void Insert(std::wstring_view tag, uint32_t id)
+		{
+			const std::wstring folded = Fold(tag);
+			if (const auto existing = exact.find(folded); existing != exact.end())
+			{
+				existing->second = id;
+				nodes[Walk(folded).value()].id = id;
+				return;
+			}
+
+			uint32_t node = 0;
+			nodes[node].terminalsBelow++;
+			for (const wchar_t c : folded)
+			{
+				uint32_t next = Child(node, c);
+				if (!next)
+				{
+					next = static_cast<uint32_t>(nodes.size());
+					auto& children = nodes[node].children;
+					children.insert(std::ranges::lower_bound(children, c, {}, &Edge::c), Edge {c, next});
+					nodes.emplace_back();
+				}
+				node = next;
+				nodes[node].terminalsBelow++;
+			}
+
+			nodes[node].terminal = true;
+			nodes[node].id = id;
+			exact.emplace(folded, id);
+		}
+
+		//! Removes a tag. Its nodes stay in place until the trie is rebuilt.
+		void Erase(std::wstring_view tag)
+		{
+			const std::wstring folded = Fold(tag);
+			if (!exact.erase(folded))
+				return;
+
+			uint32_t node = 0;
+			nodes[node].terminalsBelow--;
+			for (const wchar_t c : folded)
+			{
+				node = Child(node, c);
+				nodes[node].terminalsBelow--;
+			}
+			nodes[node].terminal = false;
+		}
+
+		[[nodiscard]] size_t Size() const { return exact.size(); }
+
+		//! The id of a tag, matched case-insensitively
+		[[nodiscard]] std::optional<uint32_t> Find(std::wstring_view tag) const
+		{
+			const auto found = exact.find(Fold(tag));
+			if (found == exact.end())
+				return std::nullopt;
+			return found->second;
+		}
+
+		//! The id of the tag a character name starts with, if any. Walks the trie once along the name.
+		[[nodiscard]] std::optional<uint32_t> FindPrefixOf(std::wstring_view name) const
+		{
+			uint32_t node = 0;
+			for (const wchar_t c : name)
+			{
+				node = Child(node, FoldTagCharacter(c));
+				if (!node)
+					return std::nullopt;
+				if (nodes[node].terminal)
+					return nodes[node].id;
+			}
+			return std::nullopt;
+		}
+
+		//! Whether a new tag would clash with a registered one, that is one of them starts with the other
+		[[nodiscard]] bool Conflicts(std::wstring_view tag) const
+		{
+			uint32_t node = 0;
+			for (const wchar_t c : tag)
+			{
+				node = Child(node, FoldTagCharacter(c));
+				if (!node)
+					return false;
+				if (nodes[node].terminal)
+					return true;
+			}
+			return nodes[node].terminalsBelow > 0;
+		}
+
+	  private:
+		struct Edge
+		{
+			wchar_t c;
+			uint32_t next;
+		};
+
+		struct Node
+		{
+			std::vector<Edge> children;
+			uint32_t terminalsBelow = 0;
+			uint32_t id = 0;
+			bool terminal = false;
+		};
+
+		static std::wstring Fold(std::wstring_view tag)
+		{
+			std::wstring folded(tag.size(), L'\0');
+			std::ranges::transform(tag, folded.begin(), FoldTagCharacter);
+			return folded;
+		}
+
+		//! The node reached from node over c, 0 if there is no such edge
+		[[nodiscard]] uint32_t Child(uint32_t node, wchar_t c) const
+		{
+			const auto& children = nodes[node].children;
+			const auto edge = std::ranges::lower_bound(children, c, {}, &Edge::c);
+			return edge != children.end() && edge->c == c ? edge->next : 0;
+		}
+
+		[[nodiscard]] std::optional<uint32_t> Walk(std::wstring_view folded) const
+		{
+			uint32_t node = 0;
+			for (const wchar_t c : folded)
+			{
+				node = Child(node, c);
+				if (!node)
+					return std::nullopt;
+			}
+			return node;
+		}
+
+		std::vector<Node> nodes;
+		std::unordered_map<std::wstring, uint32_t> exact;
+	};
+
+	//! Lines of the append-only tag change log. Strings are stored as four hex digits per character, like IniWriteW does, so any tag or
+	//! password survives the round trip whatever it contains.
+	namespace TagLog
+	{
+		struct Entry
+		{
+			bool drop = false;
+			std::wstring tag;
+			std::wstring masterPassword;
+			std::wstring renamePassword;
+			int64_t lastAccess = 0;
+			std::wstring description;
+		};
+
+		inline void AppendHex(std::string& out, std::wstring_view text)
+		{
+			char digits[5];
+			for (const wchar_t c : text)
+			{
+				snprintf(digits, sizeof(digits), "%04X", static_cast<uint16_t>(c));
+				out += digits;
+			}
+		}
+
+		inline std::optional<std::wstring> ParseHex(std::string_view hex)
+		{
+			if (hex.size() % 4)
+				return std::nullopt;
+
+			std::wstring text;
+			for (size_t i = 0; i < hex.size(); i += 4)
+			{
+				uint32_t value = 0;
+				for (const char c : hex.substr(i, 4))
+				{
+					value <<= 4;
+					if (c >= '0' && c <= '9')
+						value |= c - '0';
+					else if (c >= 'A' && c <= 'F')
+						value |= c - 'A' + 10;
+					else
+						return std::nullopt;
+				}
+				text += static_cast<wchar_t>(value);
+			}
+			return text;
+		}
+
+		//! One line, without the line break
+		inline std::string Format(const Entry& entry)
+		{
+			std::string line = entry.drop ? "drop\t" : "put\t";
+			AppendHex(line, entry.tag);
+			if (entry.drop)
+				return line;
+
+			line += '\t';
+			AppendHex(line, entry.masterPassword);
+			line += '\t';
+			AppendHex(line, entry.renamePassword);
+			line += '\t' + std::to_string(entry.lastAccess) + '\t';
+			AppendHex(line, entry.description);
+			return line;
+		}
+
+		//! Parses a line written by Format. A line cut short by a crash mid-append does not parse.
+		inline std::optional<Entry> Parse(std::string_view line)
+		{
+			if (!line.empty() && line.back() == '\r')
+				line.remove_suffix(1);
+
+			std::vector<std::string_view> fields;
+			for (size_t start = 0;;)
+			{
+				const size_t tab = line.find('\t', start);
+				fields.emplace_back(line.substr(start, tab - start));
+				if (tab == std::string_view::npos)
+					break;
+				start = tab + 1;
+			}
+
+			Entry entry;
+			if (fields[0] == "drop" && fields.size() == 2)
+				entry.drop = true;
+			else if (fields[0] != "put" || fields.size() != 6)
+				return std::nullopt;
+
+			const auto tag = ParseHex(fields[1]);
+			if (!tag || tag->empty())
+				return std::nullopt;
+			entry.tag = *tag;
+			if (entry.drop)
+				return entry;
+
+			const auto masterPassword = ParseHex(fields[2]);
+			const auto renamePassword = ParseHex(fields[3]);
+			const auto description = ParseHex(fields[5]);
+			if (!masterPassword || !renamePassword || !description || fields[4].empty())
+				return std::nullopt;
+
+			int64_t lastAccess = 0;
+			for (const char c : fields[4])
+			{
+				if (c < '0' || c > '9')
+					return std::nullopt;
+				lastAccess = lastAccess * 10 + (c - '0');
+			}
+
+			entry.masterPassword = *masterPassword;
+			entry.renamePassword = *renamePassword;
+			entry.lastAccess = lastAccess;
+			entry.description = *description;
+			return entry;
+		}
+	} // namespace TagLog
+} // namespace Plugins::Rename
@@ -0,0 +1,128 @@
+// Benchmark of the rename plugin's tag lookups with 50,000 registered tags, against the linear scans over the tag list they replaced:
+//   g++ -std=c++20 -O2 -o tag_store_benchmark TagStoreBenchmark.cpp
+//   ./tag_store_benchmark
+// Also times building the trie and replaying a change log of the same size, which is what loading the tags costs.
+
+#include "../TagStore.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <random>
+
+using namespace Plugins::Rename;
+
+namespace
+{
+	constexpr size_t TagCount = 50000;
+	constexpr size_t Lookups = 20000;
+
+	template<typename Work>
+	double Measure(size_t count, Work work)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		work();
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / static_cast<double>(count);
+	}
+
+	std::wstring RandomText(std::mt19937& rng, size_t minLength, size_t maxLength)
+	{
+		static constexpr wchar_t Alphabet[] = L"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789[]-=.";
+		std::uniform_int_distribution<size_t> length {minLength, maxLength};
+		std::uniform_int_distribution<size_t> letter {0, std::size(Alphabet) - 2};
+		std::wstring text(length(rng), L'\0');
+		for (auto& c : text)
+			c = Alphabet[letter(rng)];
+		return text;
+	}
+} // namespace
+
+int main()
+{
+	std::mt19937 rng {50000};
+
+	// Tags are unique and none is a prefix of another, as the plugin enforces on creation
+	std::vector<std::wstring> tags;
+	TagTrie trie;
+	while (tags.size() < TagCount)
+	{
+		std::wstring tag = L"[" + RandomText(rng, 3, 8) + L"]";
+		if (trie.Conflicts(tag))
+			continue;
+		trie.Insert(tag, static_cast<uint32_t>(tags.size()));
+		tags.emplace_back(std::move(tag));
+	}
+
+	// Half the character names carry a registered tag
+	std::vector<std::wstring> names;
+	std::uniform_int_distribution<size_t> pick {0, TagCount - 1};
+	for (size_t i = 0; i < Lookups; i++)
+		names.emplace_back((i % 2 ? tags[pick(rng)] : std::wstring()) + RandomText(rng, 4, 12));
+
+	size_t found = 0;
+	const double linearPrefix = Measure(Lookups, [&] {
+		for (const auto& name : names)
+		{
+			for (const auto& tag : tags)
+			{
+				if (name.find(tag) == 0)
+				{
+					found++;
+					break;
+				}
+			}
+		}
+	});
+	const double triePrefix = Measure(Lookups, [&] {
+		for (const auto& name : names)
+			found += trie.FindPrefixOf(name).has_value();
+	});
+	const double trieExact = Measure(Lookups, [&] {
+		for (size_t i = 0; i < Lookups; i++)
+			found += trie.Find(tags[(i * 7919) % TagCount]).has_value();
+	});
+
+	std::vector<std::wstring> candidates;
+	for (size_t i = 0; i < Lookups; i++)
+		candidates.emplace_back(L"[" + RandomText(rng, 2, 9) + L"]");
+	const double linearConflict = Measure(Lookups, [&] {
+		for (const auto& candidate : candidates)
+		{
+			for (const auto& tag : tags)
+			{
+				if (candidate.find(tag) == 0 || tag.find(candidate) == 0)
+				{
+					found++;
+					break;
+				}
+			}
+		}
+	});
+	const double trieConflict = Measure(Lookups, [&] {
+		for (const auto& candidate : candidates)
+			found += trie.Conflicts(candidate);
+	});
+
+	const double build = Measure(TagCount, [&] {
+		TagTrie rebuilt;
+		for (size_t i = 0; i < TagCount; i++)
+			rebuilt.Insert(tags[i], static_cast<uint32_t>(i));
+		found += rebuilt.Size();
+	});
+
+	std::vector<std::string> lines;
+	for (size_t i = 0; i < TagCount; i++)
+		lines.emplace_back(TagLog::Format({false, tags[i], RandomText(rng, 8, 8), RandomText(rng, 8, 8), 1700000000, L"Benchmark tag"}));
+	const double replay = Measure(TagCount, [&] {
+		for (const auto& line : lines)
+			found += TagLog::Parse(line).has_value();
+	});
+
+	std::printf("%zu tags, %zu lookups (checksum %zu)\n", TagCount, Lookups, found);
+	std::printf("prefix of a name    linear %10.0f ns   trie %8.1f ns\n", linearPrefix, triePrefix);
+	std::printf("conflict check      linear %10.0f ns   trie %8.1f ns\n", linearConflict, trieConflict);
+	std::printf("exact lookup                            trie %8.1f ns\n", trieExact);
+	std::printf("insert into trie    %8.1f ns/tag\n", build);
+	std::printf("parse log line      %8.1f ns/line\n", replay);
+	return 0;
+}
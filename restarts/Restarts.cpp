@@ -32,11 +32,54 @@ namespace Plugins::Restart
 {
 	const std::unique_ptr<Global> global = std::make_unique<Global>();
 
+	//! Applies a restart template on the worker thread. The template keeps the name, description and timestamp of the character it replaces,
+	//! so applying it twice gives the same file.
+	void RunRestart(const CharacterJobs::Job& job)
+	{
+		const std::string characterFile = wstos(job.Arg("characterFile"));
+		const CharacterJobs::CharacterFile current(characterFile);
+		CharacterJobs::CharacterFile restarted(wstos(job.Arg("restartFile")));
+
+		restarted.SetW("Player", "name", job.Arg("characterName"));
+		restarted.Set("Player", "description", current.Get("Player", "description").value_or(""));
+		restarted.Set("Player", "tstamp", current.Get("Player", "tstamp").value_or("0"));
+		restarted.Set("Player", "money", wstos(job.Arg("cash")));
+
+		// Overwrite the existing character file
+		restarted.Write(characterFile);
+	}
+
+	//! Unlocks the account of a restart and logs its outcome on the game thread
+	void CompleteRestart(const CharacterJobs::Job& job, const std::string& error)
+	{
+		global->accountLocks.Release(job.id);
+
+		if (!error.empty())
+		{
+			AddLog(LogType::Normal, LogLevel::Err, std::format("User restart failed ({}) for {}", error, wstos(job.Arg("characterName"))));
+			return;
+		}
+
+		AddLog(LogType::Normal, LogLevel::Info, std::format("User restart {} for {}", wstos(job.Arg("restartFile")), wstos(job.Arg("characterName"))));
+	}
+
+	//! Stops the job worker on the game thread, before the plugin is unloaded with the server
+	void Shutdown()
+	{
+		if (global->jobs)
+			global->jobs->Stop();
+	}
+
 	void LoadSettings()
 	{
 		auto config = Serializer::JsonToObject<Config>();
 
 		global->config = std::make_unique<Config>(config);
+
+		// Stop the worker of a previous load first, whatever it did not get to stays in the journal for the new one
+		if (global->jobs)
+			global->jobs->Stop();
+		global->jobs = std::make_unique<CharacterJobs::Queue>(CoreGlobals::c()->accPath + "restart_jobs.log", RunRestart, CompleteRestart);
 	}
 
 	/* User Commands */
@@ -167,6 +210,8 @@ namespace Plugins::Restart
 	/* Hooks */
 	void ProcessPendingRestarts()
 	{
+		global->jobs->Drain();
+
 		while (global->pendingRestarts.size())
 		{
 			Restart restart = global->pendingRestarts.back();
@@ -175,35 +220,20 @@ namespace Plugins::Restart
 
 			global->pendingRestarts.pop_back();
 
-			try
+			const auto account = Hk::Client::GetAccountByCharName(restart.characterName);
+			if (account.has_error())
 			{
-				// Overwrite the existing character file
-				std::string scCharFile = CoreGlobals::c()->accPath + wstos(restart.directory) + "\\" + wstos(restart.characterFile) + ".fl";
-				std::string scTimeStampDesc = IniGetS(scCharFile, "Player", "description", "");
-				std::string scTimeStamp = IniGetS(scCharFile, "Player", "tstamp", "0");
-				if (!::CopyFileA(restart.restartFile.c_str(), scCharFile.c_str(), FALSE))
-					throw "copy template";
-
-				FlcDecodeFile(scCharFile.c_str(), scCharFile.c_str());
-				IniWriteW(scCharFile, "Player", "name", restart.characterName);
-				IniWrite(scCharFile, "Player", "description", scTimeStampDesc);
-				IniWrite(scCharFile, "Player", "tstamp", scTimeStamp);
-				IniWrite(scCharFile, "Player", "money", std::to_string(restart.cash));
-
-				if (!FLHookConfig::i()->general.disableCharfileEncryption)
-					FlcEncodeFile(scCharFile.c_str(), scCharFile.c_str());
-
-				AddLog(
-				    LogType::Normal, LogLevel::Info, std::format("User restart {} for {}", restart.restartFile.c_str(), wstos(restart.characterName).c_str()));
-			}
-			catch (char* err)
-			{
-				AddLog(LogType::Normal, LogLevel::Err, std::format("User restart failed ({}) for {}", err, wstos(restart.characterName).c_str()));
-			}
-			catch (...)
-			{
-				AddLog(LogType::Normal, LogLevel::Err, std::format("User restart failed for {}", wstos(restart.characterName)));
+				AddLog(LogType::Normal, LogLevel::Err, std::format("User restart failed (no acc) for {}", wstos(restart.characterName)));
+				continue;
 			}
+
+			CharacterJobs::Job job;
+			job.kind = "restart";
+			job.args = {{"characterName", restart.characterName},
+			    {"restartFile", stows(restart.restartFile)},
+			    {"characterFile", stows(CoreGlobals::c()->accPath) + restart.directory + L"\\" + restart.characterFile + L".fl"},
+			    {"cash", std::to_wstring(restart.cash)}};
+			global->accountLocks.Lock(global->jobs->Submit(std::move(job)), account.value());
 		}
 	}
 
@@ -227,11 +257,12 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 {
 	pi->name("Restarts");
 	pi->shortName("restarts");
-	pi->mayUnload(true);
+	pi->mayUnload(false);
 	pi->commands(&commands);
 	pi->timers(&timers);
 	pi->returnCode(&global->returnCode);
 	pi->versionMajor(PluginMajorVersion::VERSION_04);
 	pi->versionMinor(PluginMinorVersion::VERSION_00);
 	pi->emplaceHook(HookedCall::FLHook__LoadSettings, &LoadSettings, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__Shutdown, &Shutdown);
 }
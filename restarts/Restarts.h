@@ -3,6 +3,8 @@
 #include <FLHook.hpp>
 #include <plugin.h>
 
+#include "../common/CharacterJobs.h"
+
 namespace Plugins::Restart
 {
 	//! A struct containing a pending restart
@@ -47,5 +49,10 @@ namespace Plugins::Restart
 
 		//! A vector of currently pending restarts
 		std::vector<Restart> pendingRestarts;
+
+		//! Applies the restarts once the characters are offline
+		std::unique_ptr<CharacterJobs::Queue> jobs;
+		//! The accounts of characters whose files are being rewritten
+		CharacterJobs::AccountLocks accountLocks;
 	};
 } // namespace Plugins::Restart
\ No newline at end of file
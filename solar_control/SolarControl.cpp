@@ -12,11 +12,18 @@
  * @paragraph adminCmds Admin Commands
  * All commands are prefixed with '.' unless explicitly specified.
  * - solarcreate [number] [name] - Creates X amount of the specified Solars. The name for the Solar is configured in the json file.
- * - solardestroy - Destroys all spawned solars.
+ *   Solars created this way are spawned over the following server ticks, saved to SolarSnapshot.bin and respawned when the server restarts.
+ * - solarqueue - Shows the depth, throughput and latency of the spawn queue, and how many airlock docking requests were issued or suppressed.
+ * - solardestroy [system <nickname>|arch <name>] - Destroys all spawned solars, or only those in the given system or of the given arch.
  *
  * @paragraph configuration Configuration
  * @code
  * {
+ *     "healthRefreshWindowInSeconds": 30,
+ *     "spawnBudgetInMicroseconds": 2000,
+ *     "spawnChunkSize": 8,
+ *     "dockRequestIntervalInMs": 5000,
+ *     "randomSeed": 0,
  *     "solarArches": {
  *         "osiris": {
  *             "base": "Li01_15_base",
@@ -71,6 +78,8 @@
  * @paragraph ipc IPC Interfaces Exposed
  * SolarCommunicator: exposes CreateUserDefinedSolar method with parameters (const std::wstring& name, Vector position, const Matrix& rotation, SystemId systemId, bool
  * varyPosition, bool mission)
+ * SolarCommunicator: exposes CreateSolars method with parameters (std::span<const SolarSpawnRequest> requests) to spawn many solars in one batch
+ * SolarCommunicator: exposes QueueSolars and QueueSpawnJob methods to spawn solars or other objects across server ticks with a completion callback
  */
 
 #include "SolarControl.h"
@@ -79,69 +88,110 @@ namespace Plugins::SolarControl
 {
 	const std::unique_ptr<Global> global = std::make_unique<Global>();
 
+	//! Spawn queue priorities. Startup solars and the snapshot go ahead of anything an admin or another plugin queues.
+	constexpr int StartupSpawnPriority = 100;
+	constexpr int AdminSpawnPriority = 0;
+
+	//! Raw FLPACKET_CREATESOLAR as filled in by server.dll
+	struct SolarPacket
+	{
+		std::byte unknown[0x100];
+	};
+
+	//! A built creation packet waiting to be sent to the clients of its system
+	struct PendingSolarPacket
+	{
+		SystemId system;
+		SolarPacket packet;
+	};
+
 	/** @ingroup SolarControl
-	 * @brief Returns a random float between two numbers
+	 * @brief Patches server.dll so pub::SpaceObj::CreateSolar does not send its own (loadout-less) creation packet
 	 */
-	float randomFloatRange(float a, float b)
+	void SetSolarPacketHack(bool enabled)
 	{
-		return ((b - a) * (static_cast<float>(rand()) / RAND_MAX)) + a;
+		char* serverHackAddress = reinterpret_cast<char*>(hModServer) + 0x2A62A;
+		const char serverHack = enabled ? '\xEB' : '\x74';
+		WriteProcMem(serverHackAddress, &serverHack, 1);
 	}
 
 	/** @ingroup SolarControl
-	 * @brief Sends a custom Solar Packet for the spaceId using the solarInfo struct. A modified packet is needed because vanilla misses the loadout
+	 * @brief Builds a custom Solar Packet for the spaceId using the solarInfo struct. A modified packet is needed because vanilla misses the loadout
 	 */
-	void SendSolarPacket(uint& iSpaceID, pub::SpaceObj::SolarInfo& solarInfo)
+	bool BuildSolarPacket(uint spaceId, const pub::SpaceObj::SolarInfo& solarInfo, SolarPacket& solarPacket)
 	{
 		uint unknown;
-		if (IObjInspectImpl * inspect; GetShipInspect(iSpaceID, inspect, unknown))
+		IObjInspectImpl* inspect;
+		if (!GetShipInspect(spaceId, inspect, unknown))
+			return false;
+
+		auto const* solar = reinterpret_cast<CSolar const*>(inspect->cobject());
+
+		solar->launch_pos(solarInfo.vPos, solarInfo.mOrientation, 1);
+
+		char* address1 = reinterpret_cast<char*>(hModServer) + 0x163F0;
+		char* address2 = reinterpret_cast<char*>(hModServer) + 0x27950;
+		SolarPacket* packet = &solarPacket;
+
+		// fill struct
+		__asm
 		{
-			auto const* solar = reinterpret_cast<CSolar const*>(inspect->cobject());
-			
-			solar->launch_pos(solarInfo.vPos, solarInfo.mOrientation, 1);
+		mov ecx, packet
+		mov eax, address1
+		call eax
+		push solar
+		mov ecx, packet
+		push ecx
+		mov eax, address2
+		call eax
+		add esp, 8
+		}
 
-			struct SOLAR_STRUCT
-			{
-				std::byte unknown[0x100];
-			};
+		return true;
+	}
 
-			SOLAR_STRUCT solarPacket {};
+	/** @ingroup SolarControl
+	 * @brief Sends every pending packet to the clients in its system, walking the active player list only once
+	 */
+	void BroadcastSolarPackets(std::vector<PendingSolarPacket>& packets)
+	{
+		std::map<SystemId, std::vector<SolarPacket*>> packetsBySystem;
+		for (auto& [system, packet] : packets)
+			packetsBySystem[system].emplace_back(&packet);
 
-			char* address1 = reinterpret_cast<char*>(hModServer) + 0x163F0;
-			char* address2 = reinterpret_cast<char*>(hModServer) + 0x27950;
+		if (packetsBySystem.empty())
+			return;
 
-			// fill struct
-			__asm
-			{
-			lea ecx, solarPacket
-			mov eax, address1
-			call eax
-			push solar
-			lea ecx, solarPacket
-			push ecx
-			mov eax, address2
-			call eax
-			add esp, 8
-			}
+		PlayerData* playerData = nullptr;
+		while ((playerData = Players.traverse_active(playerData)))
+		{
+			const auto systemPackets = packetsBySystem.find(playerData->systemId);
+			if (systemPackets == packetsBySystem.end())
+				continue;
 
-			// Send packet to every client in the system
-			PlayerData* playerData = nullptr;
-			while (playerData = Players.traverse_active(playerData))
-			{
-				if (playerData->systemId == solarInfo.systemId)
-					GetClientInterface()->Send_FLPACKET_SERVER_CREATESOLAR(playerData->iOnlineId, reinterpret_cast<FLPACKET_CREATESOLAR&>(solarPacket));
-			}
+			for (auto* packet : systemPackets->second)
+				GetClientInterface()->Send_FLPACKET_SERVER_CREATESOLAR(playerData->iOnlineId, reinterpret_cast<FLPACKET_CREATESOLAR&>(*packet));
 		}
 	}
 
+	/** @ingroup SolarControl
+	 * @brief Sends a custom Solar Packet for the spaceId using the solarInfo struct to every client in the system
+	 */
+	void SendSolarPacket(uint& iSpaceID, pub::SpaceObj::SolarInfo& solarInfo)
+	{
+		std::vector<PendingSolarPacket> packets(1);
+		packets.front().system = solarInfo.systemId;
+		if (BuildSolarPacket(iSpaceID, solarInfo, packets.front().packet))
+			BroadcastSolarPackets(packets);
+	}
+
 	/** @ingroup SolarControl
 	 * @brief Creates a solar from a solarInfo struct
 	 */
 	int CreateSolar(uint& spaceId, pub::SpaceObj::SolarInfo& solarInfo)
 	{
 		// Hack server.dll so it does not call create solar packet send
-		char* serverHackAddress = reinterpret_cast<char*>(hModServer) + 0x2A62A;
-		constexpr char serverHack[] = {'\xEB'};
-		WriteProcMem(serverHackAddress, &serverHack, 1);
+		SetSolarPacketHack(true);
 
 		// Create the Solar
 		const int returnValue = pub::SpaceObj::CreateSolar(spaceId, solarInfo);
@@ -150,8 +200,7 @@ namespace Plugins::SolarControl
 		SendSolarPacket(spaceId, solarInfo);
 
 		// Undo the server.dll hack
-		constexpr char serverUnHack[] = {'\x74'};
-		WriteProcMem(serverHackAddress, &serverUnHack, 1);
+		SetSolarPacketHack(false);
 
 		return returnValue;
 	}
@@ -178,22 +227,33 @@ namespace Plugins::SolarControl
 	}
 
 	/** @ingroup SolarControl
-	 * @brief Creates a solar defined in the solar json file
+	 * @brief Returns the compiled spawn template for a configured solar arch, or nullptr if there is no such arch
 	 */
-	uint CreateUserDefinedSolar(const std::wstring& name, Vector position, const Matrix& rotation, SystemId system, bool varyPosition, bool mission)
+	const SolarSpawnTemplate* FindSpawnTemplate(const std::wstring& name)
 	{
-		SolarArch arch = global->config->solarArches[name];
+		const auto index = global->spawnTemplateIndex.find(name);
+		if (index == global->spawnTemplateIndex.end())
+			return nullptr;
+
+		return &global->spawnTemplates[index->second];
+	}
 
-		pub::SpaceObj::SolarInfo si {};
+	/** @ingroup SolarControl
+	 * @brief Compiles a configured solar arch into a spawn template with every id resolved
+	 */
+	SolarSpawnTemplate CompileSpawnTemplate(const std::wstring& name, const SolarArch& arch)
+	{
+		SolarSpawnTemplate spawnTemplate;
+		spawnTemplate.name = name;
+		spawnTemplate.nickName = wstos(name);
+		spawnTemplate.infocard = arch.infocard;
+
+		pub::SpaceObj::SolarInfo& si = spawnTemplate.solarInfo;
 		memset(&si, 0, sizeof(si));
 		si.iFlag = 4;
-
-		// Prepare the settings for the space object
 		si.iArchId = arch.solarArchId;
 		si.iLoadoutId = arch.loadoutId;
 		si.iHitPointsLeft = 1000;
-		si.systemId = system;
-		si.mOrientation = rotation;
 		si.Costume.head = CreateID("benchmark_male_head");
 		si.Costume.body = CreateID("benchmark_male_body");
 		si.Costume.lefthand = 0;
@@ -201,29 +261,68 @@ namespace Plugins::SolarControl
 		si.Costume.accessories = 0;
 		si.iVoiceId = CreateID("atc_leg_m01");
 		si.iRep = MakeId("fc_lr_grp");
-		std::string npcId = wstos(name) + std::to_string(global->spawnedSolars.size());
-		strncpy_s(si.cNickName, sizeof(si.cNickName), npcId.c_str(), name.size() + global->spawnedSolars.size());
 
-		// Do we need to vary the starting position slightly? Useful when spawning multiple objects
-		si.vPos = position;
-		if (varyPosition)
+		// Which base this links to
+		si.baseId = arch.baseId;
+
+		pub::Reputation::GetReputationGroup(spawnTemplate.iffGroup, arch.iff.c_str());
+		spawnTemplate.personality = GetPersonality(arch.pilot);
+
+		return spawnTemplate;
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Compiles every configured solar arch into the spawn template table
+	 */
+	void CompileSpawnTemplates()
+	{
+		std::vector<std::wstring> previousArches;
+		for (const auto& spawnTemplate : global->spawnTemplates)
+			previousArches.emplace_back(spawnTemplate.name);
+
+		global->spawnTemplates.clear();
+		global->spawnTemplateIndex.clear();
+		for (const auto& [name, solar] : global->config->solarArches)
 		{
-			si.vPos.x = position.x + randomFloatRange(0, 1000);
-			si.vPos.y = position.y + randomFloatRange(0, 1000);
-			si.vPos.z = position.z + randomFloatRange(0, 2000);
+			global->spawnTemplateIndex[name] = static_cast<uint>(global->spawnTemplates.size());
+			global->spawnTemplates.emplace_back(CompileSpawnTemplate(name, solar));
 		}
-		else
+
+		// Keep tracking solars spawned before a reload, pointing them at the rebuilt templates
+		global->spawnedSolars.RemapArchIndices([&previousArches](uint archIndex) {
+			if (archIndex >= previousArches.size())
+				return MissingArchIndex;
+
+			const auto index = global->spawnTemplateIndex.find(previousArches[archIndex]);
+			return index == global->spawnTemplateIndex.end() ? MissingArchIndex : index->second;
+		});
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Fills in the solarInfo struct for a request from its template and allocates its reputation
+	 */
+	void PrepareSolarInfo(const SolarSpawnRequest& request, const SolarSpawnTemplate& spawnTemplate, pub::SpaceObj::SolarInfo& si)
+	{
+		si = spawnTemplate.solarInfo;
+		si.systemId = request.system;
+		si.mOrientation = request.rotation;
+		// The registry shrinks as solars are destroyed, so number the nicknames by a counter that never goes back to keep them unique
+		std::string npcId = spawnTemplate.nickName + std::to_string(global->spawnCounter++);
+		strncpy_s(si.cNickName, sizeof(si.cNickName), npcId.c_str(), _TRUNCATE);
+
+		// Do we need to vary the starting position slightly? Useful when spawning multiple objects
+		si.vPos = request.position;
+		if (request.varyPosition)
 		{
-			si.vPos.x = position.x;
-			si.vPos.y = position.y;
-			si.vPos.z = position.z;
+			std::array<float, 3> offset;
+			global->randomStream.Fill(offset);
+			si.vPos.x = request.position.x + offset[0] * 1000.0f;
+			si.vPos.y = request.position.y + offset[1] * 1000.0f;
+			si.vPos.z = request.position.z + offset[2] * 2000.0f;
 		}
 
-		// Which base this links to
-		si.baseId = arch.baseId;
-
 		// Mission base?
-		if (mission)
+		if (request.mission)
 		{
 			si.mission = 1;
 		}
@@ -237,28 +336,176 @@ namespace Plugins::SolarControl
 		// Define the string used for the solar name.
 		FmtStr solar_name(0, nullptr);
 		solar_name.begin_mad_lib(16163); // ids of "%s0 %s1"
-		solar_name.append_string(arch.infocard);
+		solar_name.append_string(spawnTemplate.infocard);
 		solar_name.end_mad_lib();
 
 		// Set Reputation
 		pub::Reputation::Alloc(si.iRep, scanner_name, solar_name);
-		uint iff;
-		pub::Reputation::GetReputationGroup(iff, arch.iff.c_str());
-		pub::Reputation::SetAffiliation(si.iRep, iff);
+		pub::Reputation::SetAffiliation(si.iRep, spawnTemplate.iffGroup);
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Returns the path of the spawned solar snapshot
+	 */
+	std::filesystem::path GetSnapshotPath()
+	{
+		char path[MAX_PATH];
+		GetUserDataPath(path);
+		return std::string(path) + "\\SolarSnapshot.bin";
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Writes every persistent spawned solar to the snapshot. Skipped until the previous snapshot has been restored so it is never overwritten early.
+	 */
+	void SaveSnapshot()
+	{
+		if (!global->snapshotRestored)
+			return;
+
+		global->snapshotDirty = false;
+
+		Snapshot::Contents snapshot;
+		snapshot.spawnCounter = global->spawnCounter;
+		for (const auto& solar : global->spawnedSolars.Solars())
+		{
+			if (!solar.persistent || solar.archIndex == MissingArchIndex)
+				continue;
+
+			Snapshot::Record& record = snapshot.records.emplace_back();
+			record.arch = global->spawnTemplates[solar.archIndex].name;
+			record.spaceId = solar.id;
+			record.system = solar.system;
+			record.position[0] = solar.position.x;
+			record.position[1] = solar.position.y;
+			record.position[2] = solar.position.z;
+			static_assert(sizeof(record.rotation) == sizeof(solar.rotation));
+			memcpy(record.rotation, &solar.rotation, sizeof(record.rotation));
+			record.mission = solar.mission;
+			record.startup = solar.startup;
+		}
+
+		if (!Snapshot::Save(GetSnapshotPath(), snapshot))
+			AddLog(LogType::Normal, LogLevel::Err, "Unable to write the spawned solar snapshot.");
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Creates a batch of solars defined in the solar json file. Server.dll is patched once for the batch
+	 * and the creation packets are sent with a single pass over the online players.
+	 */
+	std::vector<uint> CreateSolars(std::span<const SolarSpawnRequest> requests)
+	{
+		std::vector<uint> spawned(requests.size(), 0);
+		if (requests.empty())
+			return spawned;
 
-		// Spawn the solar object
-		uint iSpaceObj;
-		CreateSolar(iSpaceObj, si);
+		std::vector<PendingSolarPacket> packets;
+		packets.reserve(requests.size());
 
-		pub::AI::SetPersonalityParams personalityParams = GetPersonality(arch.pilot);
-		pub::AI::SubmitState(iSpaceObj, &personalityParams);
+		const mstime spawnTime = Hk::Time::GetUnixMiliseconds();
+		bool persisted = false;
 
-		// Set the visible health for the Space Object
-		pub::SpaceObj::SetRelativeHealth(iSpaceObj, 1);
+		// Hack server.dll once for the whole batch so it does not call create solar packet send
+		SetSolarPacketHack(true);
 
-		global->spawnedSolars[iSpaceObj] = si;
+		for (size_t i = 0; i < requests.size(); i++)
+		{
+			const auto& request = requests[i];
+			const SolarSpawnTemplate* spawnTemplate = FindSpawnTemplate(request.name);
+			if (!spawnTemplate)
+			{
+				AddLog(LogType::Normal, LogLevel::Err, std::format("{} is not a configured solar arch.", wstos(request.name)));
+				continue;
+			}
+
+			pub::SpaceObj::SolarInfo si;
+			PrepareSolarInfo(request, *spawnTemplate, si);
+
+			// Spawn the solar object
+			uint iSpaceObj = 0;
+			if (pub::SpaceObj::CreateSolar(iSpaceObj, si) != 0 || !iSpaceObj)
+			{
+				AddLog(LogType::Normal, LogLevel::Err, std::format("Unable to spawn {} in system {}.", wstos(request.name), si.systemId));
+				continue;
+			}
+
+			auto& pending = packets.emplace_back();
+			pending.system = si.systemId;
+			if (!BuildSolarPacket(iSpaceObj, si, pending.packet))
+				packets.pop_back();
+
+			pub::AI::SetPersonalityParams personality = spawnTemplate->personality;
+			pub::AI::SubmitState(iSpaceObj, &personality);
+
+			// Set the visible health for the Space Object
+			pub::SpaceObj::SetRelativeHealth(iSpaceObj, 1);
+
+			const auto archIndex = static_cast<uint>(spawnTemplate - global->spawnTemplates.data());
+			global->spawnedSolars.Add(
+			    {iSpaceObj, si.systemId, archIndex, spawnTime, si.vPos, si.mOrientation, request.mission, request.persist, request.startup});
+			spawned[i] = iSpaceObj;
+			persisted |= request.persist;
+		}
+
+		// Undo the server.dll hack
+		SetSolarPacketHack(false);
+
+		// Send solar creation packets
+		BroadcastSolarPackets(packets);
+
+		// Written once at the end of the tick rather than after every chunk
+		if (persisted)
+			global->snapshotDirty = true;
+
+		return spawned;
+	}
+
+	//! Progress of a batch of solars being spawned by the scheduler
+	struct QueuedSolarBatch
+	{
+		std::vector<SolarSpawnRequest> requests;
+		std::vector<uint> spawned;
+	};
+
+	/** @ingroup SolarControl
+	 * @brief Queues solars to be spawned across server ticks, spawnChunkSize at a time, within the per-tick spawn budget
+	 */
+	uint64_t QueueSolars(const std::vector<SolarSpawnRequest>& requests, int priority, const std::function<void(const std::vector<uint>&)>& onComplete)
+	{
+		auto batch = std::make_shared<QueuedSolarBatch>();
+		batch->requests = requests;
+		batch->spawned.reserve(requests.size());
+
+		auto step = [batch]() {
+			const size_t next = batch->spawned.size();
+			const size_t count = std::min<size_t>(std::max(global->config->spawnChunkSize, 1u), batch->requests.size() - next);
+			const auto spawned = CreateSolars(std::span(batch->requests).subspan(next, count));
+			batch->spawned.insert(batch->spawned.end(), spawned.begin(), spawned.end());
+			return batch->spawned.size() == batch->requests.size();
+		};
+
+		auto completion = [batch, onComplete]() {
+			if (onComplete)
+				onComplete(batch->spawned);
+		};
+
+		return global->spawnScheduler.Enqueue(priority, step, completion);
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Queues arbitrary spawn work on the same per-tick budget as solars
+	 */
+	uint64_t QueueSpawnJob(int priority, const SpawnScheduler::Step& step, const SpawnScheduler::Completion& onComplete)
+	{
+		return global->spawnScheduler.Enqueue(priority, step, onComplete);
+	}
 
-		return iSpaceObj;
+	/** @ingroup SolarControl
+	 * @brief Creates a solar defined in the solar json file
+	 */
+	uint CreateUserDefinedSolar(const std::wstring& name, Vector position, const Matrix& rotation, SystemId system, bool varyPosition, bool mission)
+	{
+		const SolarSpawnRequest request {name, position, rotation, system, varyPosition, mission};
+		return CreateSolars(std::span(&request, 1)).front();
 	}
 
 	/** @ingroup SolarControl
@@ -275,35 +522,39 @@ namespace Plugins::SolarControl
 		if (amount == 0)
 			amount = 1;
 
-		if (const auto iter = global->config->solarArches.find(solarType); iter != global->config->solarArches.end())
-			SolarArch arch = iter->second;
-		else
+		if (!FindSpawnTemplate(solarType))
 		{
 			commands->Print("ERR Wrong Solar name\n");
 			return;
 		}
 
-		const uint client = Hk::Client::GetClientIdFromCharName(commands->GetAdminName()).value();
+		const auto client = global->onlinePlayers.Find(commands->GetAdminName());
+		if (!client)
+			return;
+
 		uint ship;
-		pub::Player::GetShip(client, ship);
+		pub::Player::GetShip(client.value(), ship);
 		if (!ship)
 			return;
 
 		uint system;
-		pub::Player::GetSystem(client, system);
+		pub::Player::GetSystem(client.value(), system);
 
 		Vector pos {};
 		Matrix rot {};
 		pub::SpaceObj::GetLocation(ship, pos, rot);
 
-		for (int i = 0; i < amount; i++)
-			CreateUserDefinedSolar(solarType, pos, rot, system, true, false);
+		const std::vector<SolarSpawnRequest> requests(static_cast<size_t>(std::max(amount, 0)), {solarType, pos, rot, system, true, false, true});
+		QueueSolars(requests, AdminSpawnPriority, [](const std::vector<uint>& spawned) {
+			global->Log->info("Spawned {} solars queued by an admin.", std::ranges::count_if(spawned, [](uint id) { return id != 0; }));
+		});
+		commands->Print(std::format("OK {} solars queued\n", requests.size()));
 	}
 
 	/** @ingroup SolarControl
-	 * @brief Admin command to delete all spawned solars
+	 * @brief Admin command to show the state of the spawn queue
 	 */
-	void AdminCmd_SolarKill(CCmds* commands)
+	void AdminCmd_SolarQueue(CCmds* commands)
 	{
 		if (!(commands->rights & RIGHT_SUPERADMIN))
 		{
@@ -311,13 +562,79 @@ namespace Plugins::SolarControl
 			return;
 		}
 
-		for (auto const& [id, name] : global->spawnedSolars)
+		const auto& metrics = global->spawnScheduler.GetMetrics();
+		const int64_t averageLatency = metrics.jobsCompleted ? metrics.totalLatencyInMicroseconds / static_cast<int64_t>(metrics.jobsCompleted) : 0;
+		commands->Print(std::format("Queue depth: {} (max {})\n", metrics.queueDepth, metrics.maxQueueDepth));
+		commands->Print(std::format("Jobs queued: {} completed: {} steps: {} ticks over budget: {}\n",
+		    metrics.jobsQueued,
+		    metrics.jobsCompleted,
+		    metrics.stepsRun,
+		    metrics.budgetOverruns));
+		commands->Print(std::format("Spawn latency: last {}ms average {}ms max {}ms\n",
+		    metrics.lastLatencyInMicroseconds / 1000,
+		    averageLatency / 1000,
+		    metrics.maxLatencyInMicroseconds / 1000));
+		commands->Print(std::format("Airlock dock requests issued: {} suppressed: {}\n", global->dockRequestsIssued, global->dockRequestsSuppressed));
+		commands->Print("OK\n");
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Admin command to delete spawned solars. Without a filter every spawned solar is destroyed, otherwise only those in the given system or of the given arch.
+	 */
+	void AdminCmd_SolarKill(CCmds* commands, const std::wstring& filter, const std::wstring& value)
+	{
+		if (!(commands->rights & RIGHT_SUPERADMIN))
+		{
+			commands->Print("ERR No permission\n");
+			return;
+		}
+
+		std::function<bool(const SpawnedSolar&)> matches = [](const SpawnedSolar&) { return true; };
+		if (filter == L"system")
+		{
+			const SystemId system = CreateID(wstos(value).c_str());
+			matches = [system](const SpawnedSolar& solar) { return solar.system == system; };
+		}
+		else if (filter == L"arch")
+		{
+			const auto archIndex = global->spawnTemplateIndex.find(value);
+			if (archIndex == global->spawnTemplateIndex.end())
+			{
+				commands->Print("ERR Wrong Solar name\n");
+				return;
+			}
+			matches = [index = archIndex->second](const SpawnedSolar& solar) { return solar.archIndex == index; };
+		}
+		else if (!filter.empty())
+		{
+			commands->Print("ERR Usage: solardestroy [system <nickname>|arch <name>]\n");
+			return;
+		}
+
+		std::vector<uint> destroyed;
+		for (const auto& solar : global->spawnedSolars.Solars())
+		{
+			if (matches(solar))
+				destroyed.emplace_back(solar.id);
+		}
+
+		bool persisted = false;
+		for (const auto id : destroyed)
+		{
+			// Read the entry first, killing the solar can remove it from the registry synchronously through BaseDestroyed
+			const SpawnedSolar* solar = global->spawnedSolars.Find(id);
+			if (!solar)
+				continue;
+
+			persisted |= solar->persistent;
 			pub::SpaceObj::SetRelativeHealth(id, 0.0f);
+			global->spawnedSolars.Remove(id);
+		}
 
-		global->spawnedSolars.clear();
-		commands->Print("OK\n");
+		if (persisted)
+			SaveSnapshot();
 
-		return;
+		commands->Print(std::format("OK {} solars destroyed\n", destroyed.size()));
 	}
 
 	/** @ingroup SolarControl
@@ -331,10 +648,16 @@ namespace Plugins::SolarControl
 			AdminCmd_SolarMake(commands, commands->ArgInt(1), commands->ArgStr(2));
 			return true;
 		}
+		else if (command == L"solarqueue")
+		{
+			global->returnCode = ReturnCode::SkipAll;
+			AdminCmd_SolarQueue(commands);
+			return true;
+		}
 		else if (command == L"solardestroy")
 		{
 			global->returnCode = ReturnCode::SkipAll;
-			AdminCmd_SolarKill(commands);
+			AdminCmd_SolarKill(commands, commands->ArgStr(1), commands->ArgStr(2));
 			return true;
 		}
 		else
@@ -355,7 +678,6 @@ namespace Plugins::SolarControl
 		WriteProcMem(pAddressCreateSolar, &fpHkCreateSolar, 4);
 
 		auto config = Serializer::JsonToObject<Config>();
-		global->spawnedSolars.clear();
 		global->Log = spdlog::basic_logger_mt<spdlog::async_factory>("solars", "logs/solar.log");
 
 		for (auto& [name, solar] : config.solarArches)
@@ -381,60 +703,227 @@ namespace Plugins::SolarControl
 			config.hashedBaseRedirects[CreateID(baseFrom.c_str())] = CreateID(baseTo.c_str());
 		}
 
+		global->randomStream.Reseed("SolarControl", config.randomSeed);
 		global->config = std::make_unique<Config>(config);
+
+		global->onlinePlayers.Clear();
+		for (const auto& player : Hk::Admin::GetPlayers())
+			global->onlinePlayers.Add(player.client, player.character);
+
+		// IFF groups and personalities only resolve once the server has started, at boot the templates are compiled by AfterStartup
+		if (global->serverStarted)
+			CompileSpawnTemplates();
 	}
 
 	/** @ingroup SolarControl
-	 * @brief We have to spawn here since the Startup/LoadSettings hooks are too early
+	 * @brief Startup hook. Compiles the spawn templates now that IFF groups and personalities can be resolved.
 	 */
-	void Login([[maybe_unused]] struct SLoginInfo const& li, [[maybe_unused]] uint& iClientID)
+	void AfterStartup()
 	{
-		if (global->firstRun)
+		global->serverStarted = true;
+		if (global->config)
+			CompileSpawnTemplates();
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Spawns the startup solars and replays the snapshot of persistent solars from the previous run in a single batch. Solars that are
+	 * still in space, because only the plugin was reloaded and not the server, are tracked again instead of being spawned a second time.
+	 */
+	void SpawnInitialSolars()
+	{
+		if (!global->firstRun)
+			return;
+
+		global->firstRun = false;
+
+		const auto snapshotPath = GetSnapshotPath();
+		auto snapshot = Snapshot::Load(snapshotPath);
+		if (!snapshot.has_value())
+		{
+			// Moved aside so it can be inspected or recovered, the next save would overwrite it otherwise
+			auto corruptPath = snapshotPath;
+			corruptPath += ".corrupt";
+			std::error_code ec;
+			std::filesystem::rename(snapshotPath, corruptPath, ec);
+			AddLog(LogType::Normal,
+			    LogLevel::Err,
+			    ec ? "The spawned solar snapshot is corrupt and has been ignored."
+			       : std::format("The spawned solar snapshot is corrupt and has been ignored. It was moved to {}.", corruptPath.string()));
+			snapshot = Snapshot::Contents();
+		}
+
+		// Keep numbering nicknames after those of the solars that may still be in space
+		global->spawnCounter = std::max(global->spawnCounter, snapshot->spawnCounter);
+
+		const mstime now = Hk::Time::GetUnixMiliseconds();
+		std::vector<SolarSpawnRequest> requests;
+		size_t adopted = 0;
+		bool startupSolarsInSpace = false;
+		for (const auto& record : snapshot->records)
+		{
+			SolarSpawnRequest request;
+			request.name = record.arch;
+			request.position = {record.position[0], record.position[1], record.position[2]};
+			memcpy(&request.rotation, record.rotation, sizeof(request.rotation));
+			request.system = record.system;
+			request.mission = record.mission;
+			request.persist = true;
+			request.startup = record.startup;
+
+			// After a server restart space ids are handed out afresh, so only a plugin reload can find its old solars
+			if (global->loadedIntoRunningServer && record.spaceId && pub::SpaceObj::ExistsAndAlive(record.spaceId) == 0)
+			{
+				const auto archIndex = global->spawnTemplateIndex.find(record.arch);
+				global->spawnedSolars.Add({record.spaceId,
+				    record.system,
+				    archIndex == global->spawnTemplateIndex.end() ? MissingArchIndex : archIndex->second,
+				    now,
+				    request.position,
+				    request.rotation,
+				    record.mission,
+				    true,
+				    record.startup});
+				startupSolarsInSpace |= record.startup;
+				adopted++;
+			}
+			else if (!record.startup)
+				requests.emplace_back(std::move(request));
+		}
+
+		// Startup solars still in space mean the server has not restarted since they were spawned
+		if (!startupSolarsInSpace)
 		{
+			std::vector<SolarSpawnRequest> startupRequests;
 			for (const auto& solar : global->config->startupSolars)
 			{
-				CreateUserDefinedSolar(solar.name, solar.pos, solar.rot, solar.systemId, false, false);
+				startupRequests.push_back({solar.name, solar.pos, solar.rot, solar.systemId, false, false, true, true});
 			}
-			global->firstRun = false;
+			requests.insert(requests.begin(), startupRequests.begin(), startupRequests.end());
 		}
+
+		global->Log->info("Restoring {} solars from the snapshot, {} of them still in space.", snapshot->records.size(), adopted);
+
+		QueueSolars(requests, StartupSpawnPriority, [](const std::vector<uint>&) {
+			global->snapshotRestored = true;
+			SaveSnapshot();
+		});
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Hook on Update. Spawns the initial solars on the first tick after startup, before anyone has logged in, and works through the
+	 * spawn queue within the per-tick budget.
+	 */
+	int Update()
+	{
+		if (!global->config)
+			return 0;
+
+		if (global->firstRun && global->serverStarted)
+			SpawnInitialSolars();
+
+		global->spawnScheduler.Run(global->config->spawnBudgetInMicroseconds);
+
+		if (global->snapshotDirty)
+			SaveSnapshot();
+
+		return 0;
 	}
 
 	/** @ingroup SolarControl
-	 * @brief Set target hook. Used to send a docking request if an airlock is selected since vanilla doesn't make this dockable by default
+	 * @brief Fallback in case a player logs in before the first server tick. The Startup/LoadSettings hooks are too early to spawn.
+	 */
+	void Login([[maybe_unused]] struct SLoginInfo const& li, [[maybe_unused]] uint& iClientID)
+	{
+		SpawnInitialSolars();
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Set target hook. Used to send a docking request if an airlock is selected since vanilla doesn't make this dockable by default.
+	 * Requests are throttled per client so retargeting does not spam the server with docking requests.
 	 */
 	void SetTarget(const ClientId& client, struct XSetTarget const& target)
 	{
-		uint type;
-		pub::SpaceObj::GetType(target.iSpaceId, type);
-		
-		if ((type & OBJ_AIRLOCK_GATE) && std::ranges::find(global->pendingDockingRequests, client) == global->pendingDockingRequests.end())
+		if (client > MaxClientId)
+			return;
+
+		auto& throttle = global->dockingThrottle[client];
+		if (target.iSpaceId != throttle.lastTarget)
 		{
-			pub::SpaceObj::DockRequest(Hk::Player::GetShip(client).value(), target.iSpaceId);
-			global->pendingDockingRequests.emplace_back(client);
+			uint type = 0;
+			pub::SpaceObj::GetType(target.iSpaceId, type);
+			throttle.lastTarget = target.iSpaceId;
+			throttle.lastTargetIsAirlock = (type & OBJ_AIRLOCK_GATE) != 0;
+		}
+
+		if (!throttle.lastTargetIsAirlock)
+			return;
+
+		const mstime now = Hk::Time::GetUnixMiliseconds();
+		if (throttle.lastRequest && now - throttle.lastRequest < global->config->dockRequestIntervalInMs)
+		{
+			global->dockRequestsSuppressed++;
+			return;
 		}
+
+		const auto ship = Hk::Player::GetShip(client);
+		if (ship.has_error())
+			return;
+
+		pub::SpaceObj::DockRequest(ship.value(), target.iSpaceId);
+		throttle.lastRequest = now;
+		global->dockRequestsIssued++;
 	}
 
 	/** @ingroup SolarControl
-	 * @brief Timer to set the relative health of spawned solars. This fixes the glitch where spawned solars are not dockable
+	 * @brief Timer to set the relative health of recently spawned or damaged solars. This fixes the glitch where spawned solars are not dockable
 	 */
 	void RelativeHealthTimer()
 	{
-		for (const auto& [name, solarInfo]: global->spawnedSolars)
-		{
-			pub::SpaceObj::SetRelativeHealth(name, 1.0f);
-		}
+		const mstime now = Hk::Time::GetUnixMiliseconds();
+		const mstime refreshWindow = static_cast<mstime>(global->config->healthRefreshWindowInSeconds) * 1000;
+
+		global->spawnedSolars.RefreshDirty([now, refreshWindow](const SpawnedSolar& solar) {
+			pub::SpaceObj::SetRelativeHealth(solar.id, 1.0f);
+			return now - solar.spawnTime < refreshWindow;
+		});
 	}
 
 	/** @ingroup SolarControl
-	 * @brief Timer to clear the docking requests vector. This vector exists to stop the server from spamming docking requests when using SetTarget
+	 * @brief Hook on damage entry. Flags damaged spawned solars so their health is re-asserted on the next refresh
 	 */
-	void ClearDockingRequestsTimer()
+	void AddDamageEntry([[maybe_unused]] const DamageList** damageList, [[maybe_unused]] const ushort& subObjId, [[maybe_unused]] const float& newHitPoints,
+	    [[maybe_unused]] const enum DamageEntry::SubObjFate& fate)
 	{
-		global->pendingDockingRequests.clear();
+		if (g_DmgToSpaceId)
+			global->spawnedSolars.MarkDirty(g_DmgToSpaceId);
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Hook on base destroyed. Stops tracking spawned solars once they are gone
+	 */
+	void BaseDestroyed(uint objectId, [[maybe_unused]] uint clientBy)
+	{
+		const SpawnedSolar* solar = global->spawnedSolars.Find(objectId);
+		if (!solar)
+			return;
+
+		const bool persistent = solar->persistent;
+		global->spawnedSolars.Remove(objectId);
+
+		if (persistent)
+			SaveSnapshot();
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Shutdown hook. Makes sure the latest state of the persistent solars is on disk, from the game thread rather than DLL unload.
+	 */
+	void Shutdown()
+	{
+		SaveSnapshot();
 	}
 
 	// Timers
-	const std::vector<Timer> timers = {{RelativeHealthTimer, 5}, {ClearDockingRequestsTimer, 5}};
+	const std::vector<Timer> timers = {{RelativeHealthTimer, 5}};
 
 	void PlayerLaunch([[maybe_unused]] ShipId& shipId, ClientId& client)
 	{
@@ -461,22 +950,50 @@ namespace Plugins::SolarControl
 	void ClearClientInfo(ClientId& client)
 	{
 		global->pendingRedirects.erase(client);
+		global->dockingThrottle[client] = DockingThrottle();
+	}
+
+	void CharacterSelect([[maybe_unused]] const std::string& charFilename, ClientId& client)
+	{
+		if (const auto charName = (const wchar_t*)Players.GetActiveCharacterName(client))
+			global->onlinePlayers.Add(client, charName);
+	}
+
+	void DisConnect(ClientId& client, [[maybe_unused]] const enum EFLConnection& state)
+	{
+		global->onlinePlayers.Remove(client);
 	}
 
 	// IPC
 	SolarCommunicator::SolarCommunicator(const std::string& plug) : PluginCommunicator(plug)
 	{
 		this->CreateSolar = CreateUserDefinedSolar;
+		this->CreateSolars = Plugins::SolarControl::CreateSolars;
+		this->QueueSolars = Plugins::SolarControl::QueueSolars;
+		this->QueueSpawnJob = Plugins::SolarControl::QueueSpawnJob;
 	}
 } // namespace Plugins::SolarControl
 
 using namespace Plugins::SolarControl;
 
-DefaultDllMainSettings(LoadSettings);
+// Do things when the dll is loaded
+BOOL WINAPI DllMain([[maybe_unused]] HINSTANCE hinstDLL, DWORD fdwReason, [[maybe_unused]] LPVOID lpvReserved)
+{
+	if (fdwReason == DLL_PROCESS_ATTACH && CoreGlobals::c()->flhookReady)
+	{
+		// Loaded into a running server, which has long started
+		global->serverStarted = true;
+		global->loadedIntoRunningServer = true;
+		LoadSettings();
+	}
+
+	return true;
+}
 
 REFL_AUTO(type(SolarArch), field(solarArch), field(loadout), field(iff), field(infocard), field(base), field(pilot));
 REFL_AUTO(type(StartupSolar), field(name), field(system), field(position), field(rotation));
-REFL_AUTO(type(Config), field(startupSolars), field(solarArches), field(baseRedirects));
+REFL_AUTO(type(Config), field(startupSolars), field(solarArches), field(baseRedirects), field(healthRefreshWindowInSeconds), field(spawnBudgetInMicroseconds),
+    field(spawnChunkSize), field(dockRequestIntervalInMs), field(randomSeed));
 
 extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 {
@@ -490,10 +1007,17 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 	pi->emplaceHook(HookedCall::IServerImpl__Login, &Login);
 	pi->emplaceHook(HookedCall::FLHook__AdminCommand__Process, &AdminCommandProcessing);
 	pi->emplaceHook(HookedCall::FLHook__LoadSettings, &LoadSettings, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__Startup, &AfterStartup, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__Shutdown, &Shutdown);
 	pi->emplaceHook(HookedCall::IServerImpl__SetTarget, &SetTarget, HookStep::After);
 	pi->emplaceHook(HookedCall::IServerImpl__BaseEnter, &BaseEnter);
 	pi->emplaceHook(HookedCall::IServerImpl__PlayerLaunch, &PlayerLaunch, HookStep::After);
 	pi->emplaceHook(HookedCall::FLHook__ClearClientInfo, &ClearClientInfo, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__CharacterSelect, &CharacterSelect, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__DisConnect, &DisConnect);
+	pi->emplaceHook(HookedCall::IEngine__AddDamageEntry, &AddDamageEntry, HookStep::After);
+	pi->emplaceHook(HookedCall::IEngine__BaseDestroyed, &BaseDestroyed);
+	pi->emplaceHook(HookedCall::IServerImpl__Update, &Update);
 
 	// Register IPC
 	global->communicator = new SolarCommunicator(SolarCommunicator::pluginName);
@@ -4,6 +4,12 @@
 #include <spdlog/logger.h>
 #include <spdlog/async.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include <span>
+
+#include "../common/PlayerIndex.h"
+#include "../common/Random.h"
+#include "SolarSnapshot.h"
+#include "SpawnScheduler.h"
 
 namespace Plugins::SolarControl
 {
@@ -33,16 +39,130 @@ namespace Plugins::SolarControl
 		uint baseId {};
 	};
 
+	//! A SolarArch compiled at load time with every id, costume, voice, IFF group and personality resolved
+	struct SolarSpawnTemplate final
+	{
+		std::wstring name;
+		std::string nickName;
+		pub::SpaceObj::SolarInfo solarInfo {};
+		uint infocard {};
+		uint iffGroup {};
+		pub::AI::SetPersonalityParams personality;
+	};
+
 	struct Config final : Reflectable
 	{
 		std::vector<StartupSolar> startupSolars = {StartupSolar()};
 		std::map<std::wstring, SolarArch> solarArches = {{L"largestation1", SolarArch()}};
 		std::map<std::string, std::string> baseRedirects = {{"li01_01_base", "li01_02_base"}};
 		std::map<uint, uint> hashedBaseRedirects;
+		//! How long after spawning a solar keeps having its health re-asserted
+		uint healthRefreshWindowInSeconds = 30;
+		//! How much time queued spawns may take up per server tick
+		uint spawnBudgetInMicroseconds = 2000;
+		//! How many queued solars are spawned together in one step
+		uint spawnChunkSize = 8;
+		//! Minimum time between two docking requests sent on behalf of the same client when targeting an airlock
+		uint dockRequestIntervalInMs = 5000;
+		//! Seed for position variation of spawned solars so a session can be replayed. 0 picks a random seed on every load.
+		uint randomSeed = 0;
 		//! The config file we load out of
 		std::string File() override { return "config/solar.json"; }
 	};
 
+	//! A single solar to be spawned as part of a batch passed to CreateSolars
+	struct SolarSpawnRequest final
+	{
+		std::wstring name;
+		Vector position {};
+		Matrix rotation {};
+		SystemId system {};
+		bool varyPosition = false;
+		bool mission = false;
+		//! Whether the solar is written to the snapshot and respawned after a restart
+		bool persist = false;
+		//! A startup solar from the config. It is written to the snapshot so a plugin reload recognises it, but the config respawns it.
+		bool startup = false;
+	};
+
+	//! Arch index given to spawned solars whose arch is no longer configured
+	constexpr uint MissingArchIndex = UINT_MAX;
+
+	//! Compact record of a solar spawned by this plugin
+	struct SpawnedSolar final
+	{
+		uint id {};
+		SystemId system {};
+		uint archIndex {};
+		mstime spawnTime {};
+		Vector position {};
+		Matrix rotation {};
+		bool mission = false;
+		bool persistent = false;
+		bool startup = false;
+	};
+
+	//! Reference to a slot in the SpawnedSolarRegistry. Goes stale once the solar is removed and the slot reused.
+	struct SpawnedSolarHandle final
+	{
+		uint slot {};
+		uint generation {};
+	};
+
+	//! Generational slot map of spawned solars. Records are kept densely packed, and a dirty set tracks which solars need their health re-asserted.
+	class SpawnedSolarRegistry final
+	{
+		struct Slot
+		{
+			uint dense = 0;
+			uint generation = 0;
+			bool occupied = false;
+		};
+
+		std::vector<SpawnedSolar> solars;
+		std::vector<uint> denseToSlot;
+		std::vector<Slot> slots;
+		std::vector<uint> freeSlots;
+		std::map<uint, uint> slotById;
+		std::set<uint> dirty;
+
+	  public:
+		SpawnedSolarHandle Add(const SpawnedSolar& solar);
+		bool Remove(SpawnedSolarHandle handle);
+		bool Remove(uint id);
+		void Clear();
+
+		[[nodiscard]] const SpawnedSolar* Get(SpawnedSolarHandle handle) const;
+		[[nodiscard]] const SpawnedSolar* Find(uint id) const;
+		[[nodiscard]] const std::vector<SpawnedSolar>& Solars() const { return solars; }
+		[[nodiscard]] size_t Size() const { return solars.size(); }
+
+		//! Points every solar at the arch index returned by remap, used when the spawn templates are rebuilt
+		template<typename Remap>
+		void RemapArchIndices(Remap remap)
+		{
+			for (auto& solar : solars)
+				solar.archIndex = remap(solar.archIndex);
+		}
+
+		//! Flags a tracked solar as needing its health re-asserted. Untracked ids are ignored.
+		void MarkDirty(uint id);
+
+		//! Calls refresh for every dirty solar. Solars stay dirty for as long as refresh returns true.
+		template<typename Refresh>
+		void RefreshDirty(Refresh refresh)
+		{
+			for (auto id = dirty.begin(); id != dirty.end();)
+			{
+				const SpawnedSolar* solar = Find(*id);
+				if (solar && refresh(*solar))
+					++id;
+				else
+					id = dirty.erase(id);
+			}
+		}
+	};
+
 	//! Communicator class for this plugin. This is used by other plugins
 	class SolarCommunicator : public PluginCommunicator
 	{
@@ -51,18 +171,54 @@ namespace Plugins::SolarControl
 		explicit SolarCommunicator(const std::string& plug);
 
 		uint PluginCall(CreateSolar, const std::wstring& name, Vector position, const Matrix& rotation, SystemId system, bool varyPosition, bool mission);
+		//! Spawns every request in one go. The returned ids match the order of the requests, with 0 for any that failed.
+		std::vector<uint> PluginCall(CreateSolars, std::span<const SolarSpawnRequest> requests);
+		//! Queues the requests to be spawned over the following server ticks. onComplete receives the ids in request order once all have spawned.
+		uint64_t PluginCall(QueueSolars, const std::vector<SolarSpawnRequest>& requests, int priority,
+		    const std::function<void(const std::vector<uint>&)>& onComplete);
+		//! Queues arbitrary spawn work, such as NPCs, on the same per-tick budget as solars
+		uint64_t PluginCall(QueueSpawnJob, int priority, const SpawnScheduler::Step& step, const SpawnScheduler::Completion& onComplete);
+	};
+
+	//! Per-client state used to throttle the docking requests sent when an airlock is targeted
+	struct DockingThrottle final
+	{
+		uint lastTarget = 0;
+		bool lastTargetIsAirlock = false;
+		mstime lastRequest = 0;
 	};
 
 	//! Global data for this plugin
 	struct Global final
 	{
-		std::vector<uint> pendingDockingRequests;
-		std::map<uint, pub::SpaceObj::SolarInfo> spawnedSolars;
+		std::array<DockingThrottle, MaxClientId + 1> dockingThrottle;
+		uint64_t dockRequestsIssued = 0;
+		uint64_t dockRequestsSuppressed = 0;
+		SpawnedSolarRegistry spawnedSolars;
+		//! Spawn templates compiled from the config, addressed by index
+		std::vector<SolarSpawnTemplate> spawnTemplates;
+		std::map<std::wstring, uint> spawnTemplateIndex;
+		//! Set once the server has started and IFF groups and personalities can be resolved
+		bool serverStarted = false;
+		//! Set when the plugin was loaded into a running server, in which case solars from the snapshot may still be in space
+		bool loadedIntoRunningServer = false;
+		//! Number given to the next spawned solar, which makes its nickname unique
+		uint spawnCounter = 0;
 		bool firstRun = true;
+		//! Set once the snapshot from the previous run has been respawned, before that the snapshot must not be overwritten
+		bool snapshotRestored = false;
+		//! Set when persistent solars were spawned, the snapshot is then written once at the end of the tick
+		bool snapshotDirty = false;
+		SpawnScheduler spawnScheduler {[] {
+			return static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+		}};
+		Random::Stream randomStream {"SolarControl"};
 		ReturnCode returnCode = ReturnCode::Default;
 		std::unique_ptr<Config> config = nullptr;
 		std::shared_ptr<spdlog::logger> Log = nullptr;
 		SolarCommunicator* communicator = nullptr;
 		std::map<uint, uint> pendingRedirects;
+		//! The characters that are online by name, maintained on character select and disconnect
+		PlayerIndex::Index onlinePlayers;
 	};
 } // namespace Plugins::SolarControl
\ No newline at end of file
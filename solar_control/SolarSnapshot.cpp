@@ -0,0 +1,145 @@
+#include "SolarSnapshot.h"
+#include "../common/Fnv.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace Plugins::SolarControl::Snapshot
+{
+	// Layout (little endian):
+	//   char[4]  magic "FLSS"
+	//   uint32   version
+	//   uint32   spawn counter
+	//   uint32   record count
+	//   records: uint32 space id, uint32 system, float[3] position, float[9] rotation, uint8 flags (1 mission, 2 startup), uint16 arch length,
+	//            uint16[] arch
+	//   uint32   FNV-1a hash of everything before it
+	constexpr char magic[4] = {'F', 'L', 'S', 'S'};
+	constexpr uint32_t version = 2;
+	constexpr uint8_t missionFlag = 1;
+	constexpr uint8_t startupFlag = 2;
+
+	template<typename T>
+	void Write(std::vector<char>& out, const T& value)
+	{
+		const auto* bytes = reinterpret_cast<const char*>(&value);
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+
+	template<typename T>
+	bool Read(const std::vector<char>& in, size_t& offset, size_t end, T& value)
+	{
+		if (end - offset < sizeof(T))
+			return false;
+
+		std::memcpy(&value, in.data() + offset, sizeof(T));
+		offset += sizeof(T);
+		return true;
+	}
+
+	std::vector<char> Encode(const Contents& contents)
+	{
+		const auto& records = contents.records;
+		std::vector<char> out;
+		out.reserve(16 + records.size() * 72 + 4);
+
+		out.insert(out.end(), std::begin(magic), std::end(magic));
+		Write(out, version);
+		Write(out, contents.spawnCounter);
+		Write(out, static_cast<uint32_t>(records.size()));
+
+		for (const auto& record : records)
+		{
+			Write(out, record.spaceId);
+			Write(out, record.system);
+			Write(out, record.position);
+			Write(out, record.rotation);
+			Write(out, static_cast<uint8_t>((record.mission ? missionFlag : 0) | (record.startup ? startupFlag : 0)));
+			Write(out, static_cast<uint16_t>(record.arch.size()));
+			for (const wchar_t ch : record.arch)
+				Write(out, static_cast<uint16_t>(ch));
+		}
+
+		Write(out, Fnv1a(out.data(), out.size()));
+		return out;
+	}
+
+	std::optional<Contents> Decode(const std::vector<char>& data)
+	{
+		if (data.size() < sizeof(magic) + sizeof(uint32_t) * 3 || std::memcmp(data.data(), magic, sizeof(magic)) != 0)
+			return std::nullopt;
+
+		const size_t end = data.size() - sizeof(uint32_t);
+		uint32_t storedHash;
+		std::memcpy(&storedHash, data.data() + end, sizeof(storedHash));
+		if (storedHash != Fnv1a(data.data(), end))
+			return std::nullopt;
+
+		size_t offset = sizeof(magic);
+		Contents contents;
+		uint32_t fileVersion;
+		uint32_t count;
+		if (!Read(data, offset, end, fileVersion) || fileVersion != version || !Read(data, offset, end, contents.spawnCounter) ||
+		    !Read(data, offset, end, count))
+			return std::nullopt;
+
+		auto& records = contents.records;
+		records.reserve(count);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			Record record;
+			uint8_t flags;
+			uint16_t archLength;
+			if (!Read(data, offset, end, record.spaceId) || !Read(data, offset, end, record.system) ||
+			    !Read(data, offset, end, record.position) || !Read(data, offset, end, record.rotation) || !Read(data, offset, end, flags) ||
+			    !Read(data, offset, end, archLength))
+				return std::nullopt;
+
+			record.mission = (flags & missionFlag) != 0;
+			record.startup = (flags & startupFlag) != 0;
+			record.arch.resize(archLength);
+			for (auto& ch : record.arch)
+			{
+				uint16_t unit;
+				if (!Read(data, offset, end, unit))
+					return std::nullopt;
+				ch = static_cast<wchar_t>(unit);
+			}
+
+			records.emplace_back(std::move(record));
+		}
+
+		if (offset != end)
+			return std::nullopt;
+
+		return contents;
+	}
+
+	bool Save(const std::filesystem::path& path, const Contents& contents)
+	{
+		const auto data = Encode(contents);
+		auto tempPath = path;
+		tempPath += ".tmp";
+
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file.write(data.data(), static_cast<std::streamsize>(data.size())) || !file.flush())
+				return false;
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, path, error);
+		return !error;
+	}
+
+	std::optional<Contents> Load(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			return Contents();
+
+		const std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		return Decode(data);
+	}
+} // namespace Plugins::SolarControl::Snapshot
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+// The snapshot format only depends on the standard library so it can be read and written outside of the server.
+namespace Plugins::SolarControl::Snapshot
+{
+	//! A single persisted solar. The arch is stored by name so the snapshot survives config changes that reorder arches.
+	struct Record final
+	{
+		std::wstring arch;
+		//! The space id the solar had when the snapshot was written, to tell whether it is still in space
+		uint32_t spaceId = 0;
+		uint32_t system = 0;
+		float position[3] {};
+		float rotation[3][3] {};
+		bool mission = false;
+		//! A startup solar from the config, which is only recorded to be recognised and is never respawned from the snapshot
+		bool startup = false;
+	};
+
+	//! Everything a snapshot holds
+	struct Contents final
+	{
+		//! The number the next spawned solar gets, so nicknames stay unique while solars from before a plugin reload are still in space
+		uint32_t spawnCounter = 0;
+		std::vector<Record> records;
+	};
+
+	//! Serialises the contents into the binary snapshot format
+	std::vector<char> Encode(const Contents& contents);
+
+	//! Parses a binary snapshot. Returns nullopt if the data is truncated, corrupt or of an unknown version.
+	std::optional<Contents> Decode(const std::vector<char>& data);
+
+	//! Writes the snapshot to a temporary file and renames it over the target, so a crash never leaves a partial snapshot behind
+	bool Save(const std::filesystem::path& path, const Contents& contents);
+
+	//! Loads a snapshot from disk. A missing file is treated as an empty snapshot.
+	std::optional<Contents> Load(const std::filesystem::path& path);
+} // namespace Plugins::SolarControl::Snapshot
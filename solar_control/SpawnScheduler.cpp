@@ -0,0 +1,68 @@
+#include "SpawnScheduler.h"
+
+#include <algorithm>
+
+namespace Plugins::SolarControl
+{
+	SpawnScheduler::SpawnScheduler(Clock clock) : clock(std::move(clock)) {}
+
+	uint64_t SpawnScheduler::Enqueue(int priority, Step step, Completion onComplete)
+	{
+		const uint64_t id = nextId++;
+		jobs.push({priority, id, clock(), std::move(step), std::move(onComplete)});
+
+		metrics.jobsQueued++;
+		metrics.queueDepth = jobs.size();
+		metrics.maxQueueDepth = std::max(metrics.maxQueueDepth, jobs.size());
+
+		return id;
+	}
+
+	void SpawnScheduler::Run(int64_t budgetInMicroseconds)
+	{
+		const int64_t start = clock();
+		int64_t now = start;
+		bool ranStep = false;
+
+		while (!jobs.empty())
+		{
+			if (ranStep && now - start >= budgetInMicroseconds)
+				break;
+
+			// The top of a priority queue is const, so the job is moved out and pushed back if it is not finished
+			Job job = std::move(const_cast<Job&>(jobs.top()));
+			jobs.pop();
+
+			const bool finished = job.step();
+			ranStep = true;
+			metrics.stepsRun++;
+			now = clock();
+
+			if (!finished)
+			{
+				jobs.push(std::move(job));
+				continue;
+			}
+
+			const int64_t latency = now - job.queuedAt;
+			metrics.jobsCompleted++;
+			metrics.lastLatencyInMicroseconds = latency;
+			metrics.maxLatencyInMicroseconds = std::max(metrics.maxLatencyInMicroseconds, latency);
+			metrics.totalLatencyInMicroseconds += latency;
+
+			if (job.onComplete)
+				job.onComplete();
+		}
+
+		if (now - start > budgetInMicroseconds)
+			metrics.budgetOverruns++;
+
+		metrics.queueDepth = jobs.size();
+	}
+
+	void SpawnScheduler::Clear()
+	{
+		jobs = {};
+		metrics.queueDepth = 0;
+	}
+} // namespace Plugins::SolarControl
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+// The scheduler only depends on the standard library and an injected clock so it can be driven by a fake clock outside of the server.
+namespace Plugins::SolarControl
+{
+	//! Runs queued spawn jobs across server ticks, spending at most a fixed number of microseconds per tick
+	class SpawnScheduler final
+	{
+	  public:
+		//! Monotonic time in microseconds
+		using Clock = std::function<int64_t()>;
+		//! Performs one unit of work. Returns true once the job has nothing left to do.
+		using Step = std::function<bool()>;
+		using Completion = std::function<void()>;
+
+		struct Metrics final
+		{
+			uint64_t jobsQueued = 0;
+			uint64_t jobsCompleted = 0;
+			uint64_t stepsRun = 0;
+			//! Ticks that went over budget because a single step took longer than the time that was left
+			uint64_t budgetOverruns = 0;
+			size_t queueDepth = 0;
+			size_t maxQueueDepth = 0;
+			//! Time from a job being queued to it completing
+			int64_t lastLatencyInMicroseconds = 0;
+			int64_t maxLatencyInMicroseconds = 0;
+			int64_t totalLatencyInMicroseconds = 0;
+		};
+
+		explicit SpawnScheduler(Clock clock);
+
+		//! Queues a job. Higher priorities run first, jobs of equal priority run in the order they were queued. Returns the job id.
+		uint64_t Enqueue(int priority, Step step, Completion onComplete = nullptr);
+
+		//! Runs steps until the budget is spent or the queue is empty. At least one step runs per call so the queue always makes progress.
+		void Run(int64_t budgetInMicroseconds);
+
+		//! Drops every queued job without running its completion callback
+		void Clear();
+
+		[[nodiscard]] size_t QueueDepth() const { return jobs.size(); }
+		[[nodiscard]] const Metrics& GetMetrics() const { return metrics; }
+
+	  private:
+		struct Job
+		{
+			int priority;
+			uint64_t id;
+			int64_t queuedAt;
+			Step step;
+			Completion onComplete;
+		};
+
+		struct JobOrder
+		{
+			bool operator()(const Job& a, const Job& b) const { return a.priority != b.priority ? a.priority < b.priority : a.id > b.id; }
+		};
+
+		Clock clock;
+		std::priority_queue<Job, std::vector<Job>, JobOrder> jobs;
+		uint64_t nextId = 1;
+		Metrics metrics;
+	};
+} // namespace Plugins::SolarControl
@@ -0,0 +1,132 @@
+#include "SolarControl.h"
+
+namespace Plugins::SolarControl
+{
+	/** @ingroup SolarControl
+	 * @brief Adds a solar to the registry, reusing a free slot if there is one. New solars start out dirty.
+	 */
+	SpawnedSolarHandle SpawnedSolarRegistry::Add(const SpawnedSolar& solar)
+	{
+		uint slotIndex;
+		if (!freeSlots.empty())
+		{
+			slotIndex = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else
+		{
+			slotIndex = static_cast<uint>(slots.size());
+			slots.emplace_back();
+		}
+
+		Slot& slot = slots[slotIndex];
+		slot.dense = static_cast<uint>(solars.size());
+		slot.occupied = true;
+
+		solars.emplace_back(solar);
+		denseToSlot.emplace_back(slotIndex);
+		slotById[solar.id] = slotIndex;
+		dirty.insert(solar.id);
+
+		return {slotIndex, slot.generation};
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Removes the solar the handle points to by swapping the last record into its place. Returns false if the handle is stale.
+	 */
+	bool SpawnedSolarRegistry::Remove(SpawnedSolarHandle handle)
+	{
+		if (!Get(handle))
+			return false;
+
+		Slot& slot = slots[handle.slot];
+		const uint removedId = solars[slot.dense].id;
+		const uint lastDense = static_cast<uint>(solars.size() - 1);
+
+		if (slot.dense != lastDense)
+		{
+			solars[slot.dense] = solars[lastDense];
+			denseToSlot[slot.dense] = denseToSlot[lastDense];
+			slots[denseToSlot[slot.dense]].dense = slot.dense;
+		}
+
+		solars.pop_back();
+		denseToSlot.pop_back();
+
+		slot.occupied = false;
+		slot.generation++;
+		freeSlots.emplace_back(handle.slot);
+
+		slotById.erase(removedId);
+		dirty.erase(removedId);
+
+		return true;
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Removes a solar by its space object id. Returns false if it is not tracked.
+	 */
+	bool SpawnedSolarRegistry::Remove(uint id)
+	{
+		const auto slot = slotById.find(id);
+		if (slot == slotById.end())
+			return false;
+
+		return Remove(SpawnedSolarHandle {slot->second, slots[slot->second].generation});
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Removes every solar. Slot generations are bumped so outstanding handles go stale.
+	 */
+	void SpawnedSolarRegistry::Clear()
+	{
+		freeSlots.clear();
+		for (uint i = 0; i < slots.size(); i++)
+		{
+			if (slots[i].occupied)
+			{
+				slots[i].occupied = false;
+				slots[i].generation++;
+			}
+			freeSlots.emplace_back(i);
+		}
+
+		solars.clear();
+		denseToSlot.clear();
+		slotById.clear();
+		dirty.clear();
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Returns the solar the handle points to, or nullptr if the handle is stale
+	 */
+	const SpawnedSolar* SpawnedSolarRegistry::Get(SpawnedSolarHandle handle) const
+	{
+		if (handle.slot >= slots.size())
+			return nullptr;
+
+		const Slot& slot = slots[handle.slot];
+		if (!slot.occupied || slot.generation != handle.generation)
+			return nullptr;
+
+		return &solars[slot.dense];
+	}
+
+	/** @ingroup SolarControl
+	 * @brief Returns the solar with the given space object id, or nullptr if it is not tracked
+	 */
+	const SpawnedSolar* SpawnedSolarRegistry::Find(uint id) const
+	{
+		const auto slot = slotById.find(id);
+		if (slot == slotById.end())
+			return nullptr;
+
+		return &solars[slots[slot->second].dense];
+	}
+
+	void SpawnedSolarRegistry::MarkDirty(uint id)
+	{
+		if (slotById.contains(id))
+			dirty.insert(id);
+	}
+} // namespace Plugins::SolarControl
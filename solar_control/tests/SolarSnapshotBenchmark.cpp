@@ -0,0 +1,63 @@
+// Benchmark of encoding, saving and loading a snapshot of 10,000 spawned solars:
+//   g++ -std=c++20 -O2 -o solar_snapshot_benchmark SolarSnapshotBenchmark.cpp ../SolarSnapshot.cpp
+//   ./solar_snapshot_benchmark
+// Loading happens once on startup before the snapshot is respawned, saving after every change to a persistent solar.
+
+#include "../SolarSnapshot.h"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace Plugins::SolarControl::Snapshot;
+
+namespace
+{
+	constexpr uint32_t RecordCount = 10000;
+	constexpr int Rounds = 20;
+
+	template<typename Work>
+	double Measure(Work work)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < Rounds; i++)
+			work();
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / Rounds;
+	}
+} // namespace
+
+int main()
+{
+	Contents contents;
+	contents.spawnCounter = RecordCount;
+	contents.records.reserve(RecordCount);
+	for (uint32_t i = 0; i < RecordCount; i++)
+	{
+		Record& record = contents.records.emplace_back();
+		record.arch = L"largestation" + std::to_wstring(i % 16);
+		record.spaceId = 0x10000 + i;
+		record.system = 0x80000000u | (i % 64);
+		record.position[0] = static_cast<float>(i) * 100.0f;
+		record.position[2] = -static_cast<float>(i) * 50.0f;
+		for (int row = 0; row < 3; row++)
+			record.rotation[row][row] = 1.0f;
+		record.mission = i % 3 == 0;
+	}
+
+	const auto path = std::filesystem::temp_directory_path() / "solar_snapshot_benchmark.bin";
+	size_t bytes = 0;
+	size_t loaded = 0;
+
+	const double encode = Measure([&] { bytes += Encode(contents).size(); });
+	const auto data = Encode(contents);
+	const double decode = Measure([&] { loaded += Decode(data)->records.size(); });
+	const double save = Measure([&] { Save(path, contents); });
+	const double load = Measure([&] { loaded += Load(path)->records.size(); });
+	std::filesystem::remove(path);
+
+	std::printf("%u records, %zu bytes\n", RecordCount, data.size());
+	std::printf("encode %8.3f ms\n", encode);
+	std::printf("decode %8.3f ms\n", decode);
+	std::printf("save   %8.3f ms\n", save);
+	std::printf("load   %8.3f ms\n", load);
+	return bytes && loaded ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+// Round trip and corruption tests for the spawned solar snapshot format:
+//   g++ -std=c++20 -O2 -o solar_snapshot_test SolarSnapshotTest.cpp ../SolarSnapshot.cpp
+//   ./solar_snapshot_test
+// Exits with the number of failed checks.
+
+#include "../SolarSnapshot.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace Plugins::SolarControl::Snapshot;
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			failures++;
+		}
+	}
+
+	Contents Sample()
+	{
+		Contents contents;
+		contents.spawnCounter = 4711;
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			Record& record = contents.records.emplace_back();
+			record.arch = L"largestation" + std::to_wstring(i);
+			record.spaceId = 0x4000 + i;
+			record.system = 0x80000000u | i;
+			record.position[0] = -30367.5f + static_cast<float>(i);
+			record.position[1] = 120.25f;
+			record.position[2] = -25810.0f;
+			for (int row = 0; row < 3; row++)
+				record.rotation[row][row] = 1.0f;
+			record.rotation[0][1] = 0.5f;
+			record.mission = i == 1;
+			record.startup = i == 2;
+		}
+		contents.records[0].arch = L"lärge_station";
+		return contents;
+	}
+
+	bool Equal(const Record& a, const Record& b)
+	{
+		return a.arch == b.arch && a.spaceId == b.spaceId && a.system == b.system && std::memcmp(a.position, b.position, sizeof(a.position)) == 0 &&
+		       std::memcmp(a.rotation, b.rotation, sizeof(a.rotation)) == 0 && a.mission == b.mission && a.startup == b.startup;
+	}
+
+	bool Equal(const Contents& a, const Contents& b)
+	{
+		if (a.spawnCounter != b.spawnCounter || a.records.size() != b.records.size())
+			return false;
+
+		for (size_t i = 0; i < a.records.size(); i++)
+		{
+			if (!Equal(a.records[i], b.records[i]))
+				return false;
+		}
+		return true;
+	}
+
+	void TestRoundTrip()
+	{
+		const auto contents = Sample();
+		const auto decoded = Decode(Encode(contents));
+		Check(decoded.has_value() && Equal(*decoded, contents), "encoded contents decode to the same contents");
+
+		const auto empty = Decode(Encode(Contents()));
+		Check(empty.has_value() && empty->records.empty() && empty->spawnCounter == 0, "an empty snapshot round trips");
+	}
+
+	void TestCorruption()
+	{
+		const auto data = Encode(Sample());
+
+		for (size_t size = 0; size < data.size(); size++)
+		{
+			if (Decode(std::vector<char>(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(size))).has_value())
+			{
+				Check(false, "a truncated snapshot is rejected");
+				break;
+			}
+		}
+
+		for (size_t i = 0; i < data.size(); i++)
+		{
+			auto flipped = data;
+			flipped[i] ^= 0x10;
+			if (Decode(flipped).has_value())
+			{
+				Check(false, "a snapshot with a flipped bit is rejected");
+				break;
+			}
+		}
+
+		auto newer = data;
+		newer[4] = 99;
+		Check(!Decode(newer).has_value(), "a snapshot of an unknown version is rejected");
+	}
+
+	void TestFiles()
+	{
+		const auto path = std::filesystem::temp_directory_path() / "solar_snapshot_test.bin";
+		std::filesystem::remove(path);
+
+		const auto missing = Load(path);
+		Check(missing.has_value() && missing->records.empty(), "a missing snapshot loads as empty");
+
+		const auto contents = Sample();
+		Check(Save(path, contents), "the snapshot is saved");
+		const auto loaded = Load(path);
+		Check(loaded.has_value() && Equal(*loaded, contents), "a saved snapshot loads back");
+
+		auto tempPath = path;
+		tempPath += ".tmp";
+		Check(!std::filesystem::exists(tempPath), "no temporary file is left behind");
+
+		std::filesystem::remove(path);
+	}
+} // namespace
+
+int main()
+{
+	TestRoundTrip();
+	TestCorruption();
+	TestFiles();
+
+	if (!failures)
+		std::printf("All snapshot tests passed.\n");
+	return failures;
+}
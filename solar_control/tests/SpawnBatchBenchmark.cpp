@@ -0,0 +1,164 @@
+// Benchmark of the per-solar cost of CreateSolars for batches of 1, 10 and 100 against spawning the same solars one at a time.
+// The engine calls are modelled with the standard library and POSIX so it builds outside the server:
+//   g++ -std=c++20 -O2 -o spawn_batch_benchmark SpawnBatchBenchmark.cpp
+//   ./spawn_batch_benchmark
+// WriteProcMem is modelled by an mprotect pair around a one byte write, which is what its VirtualProtect calls cost. One at a time, every
+// solar patches and unpatches server.dll and walks all online players to send its packet. A batch patches once and walks the players once.
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace
+{
+	constexpr int PlayerCount = 255;
+	constexpr int SystemCount = 16;
+	constexpr int SolarsPerRound = 2000;
+
+	//! Raw FLPACKET_CREATESOLAR as filled in by server.dll
+	struct SolarPacket
+	{
+		std::byte unknown[0x100];
+	};
+
+	struct PendingSolarPacket
+	{
+		uint32_t system;
+		SolarPacket packet;
+	};
+
+	//! Stand-in for Players.traverse_active, a linked list of the online players
+	struct PlayerData
+	{
+		uint32_t systemId;
+		uint32_t onlineId;
+		PlayerData* next;
+	};
+
+	std::vector<PlayerData> players;
+	std::byte* serverDll = nullptr;
+	size_t pageSize = 0;
+	//! Stand-in for the client interface, which copies every packet it is handed
+	std::array<uint64_t, PlayerCount + 1> bytesSent {};
+
+	void WriteProcMem(std::byte* address, char value)
+	{
+		mprotect(serverDll, pageSize, PROT_READ | PROT_WRITE);
+		memcpy(address, &value, 1);
+		mprotect(serverDll, pageSize, PROT_READ);
+	}
+
+	void SetSolarPacketHack(bool enabled) { WriteProcMem(serverDll + 0x62A, enabled ? '\xEB' : '\x74'); }
+
+	//! Stand-in for pub::SpaceObj::CreateSolar and filling the creation packet
+	uint32_t CreateSolar(uint32_t counter, uint32_t system, SolarPacket& packet)
+	{
+		memset(&packet, 0, sizeof(packet));
+		memcpy(&packet, &counter, sizeof(counter));
+		memcpy(packet.unknown + sizeof(counter), &system, sizeof(system));
+		return 0x10000 + counter;
+	}
+
+	void Send(const PlayerData& player, const SolarPacket& packet)
+	{
+		SolarPacket copy;
+		memcpy(&copy, &packet, sizeof(copy));
+		bytesSent[player.onlineId] += sizeof(copy) + static_cast<uint8_t>(copy.unknown[0]);
+	}
+
+	//! What every spawn did before batches
+	void SpawnOne(uint32_t counter, uint32_t system)
+	{
+		SetSolarPacketHack(true);
+		SolarPacket packet;
+		CreateSolar(counter, system, packet);
+		for (const PlayerData* player = players.data(); player; player = player->next)
+		{
+			if (player->systemId == system)
+				Send(*player, packet);
+		}
+		SetSolarPacketHack(false);
+	}
+
+	//! CreateSolars: one patch and one pass over the players for the whole batch
+	void SpawnBatch(uint32_t& counter, int count)
+	{
+		std::vector<PendingSolarPacket> packets(count);
+		SetSolarPacketHack(true);
+		for (auto& pending : packets)
+		{
+			pending.system = counter % SystemCount;
+			CreateSolar(counter++, pending.system, pending.packet);
+		}
+		SetSolarPacketHack(false);
+
+		std::map<uint32_t, std::vector<const SolarPacket*>> packetsBySystem;
+		for (const auto& [system, packet] : packets)
+			packetsBySystem[system].emplace_back(&packet);
+
+		for (const PlayerData* player = players.data(); player; player = player->next)
+		{
+			const auto systemPackets = packetsBySystem.find(player->systemId);
+			if (systemPackets == packetsBySystem.end())
+				continue;
+
+			for (const auto* packet : systemPackets->second)
+				Send(*player, *packet);
+		}
+	}
+
+	template<typename Spawn>
+	double NanosecondsPerSolar(Spawn&& spawn)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		spawn();
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / SolarsPerRound;
+	}
+} // namespace
+
+int main()
+{
+	pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	serverDll = static_cast<std::byte*>(mmap(nullptr, pageSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+	if (serverDll == MAP_FAILED)
+		return 1;
+
+	// A full server, spread over a few busy systems
+	players.resize(PlayerCount);
+	for (int i = 0; i < PlayerCount; i++)
+	{
+		players[i].systemId = static_cast<uint32_t>(i % SystemCount);
+		players[i].onlineId = static_cast<uint32_t>(i + 1);
+		players[i].next = i + 1 < PlayerCount ? &players[i + 1] : nullptr;
+	}
+
+	uint32_t counter = 0;
+	printf("batch   one at a time   CreateSolars   speedup\n");
+	for (const int batchSize : {1, 10, 100})
+	{
+		const double single = NanosecondsPerSolar([&] {
+			for (int i = 0; i < SolarsPerRound; i++, counter++)
+				SpawnOne(counter, counter % SystemCount);
+		});
+
+		const double batched = NanosecondsPerSolar([&] {
+			for (int i = 0; i < SolarsPerRound; i += batchSize)
+				SpawnBatch(counter, batchSize);
+		});
+
+		printf("%5d   %10.1f ns   %9.1f ns   %6.1fx\n", batchSize, single, batched, single / batched);
+	}
+
+	uint64_t sink = 0;
+	for (const auto bytes : bytesSent)
+		sink += bytes;
+	return sink == 0;
+}
@@ -0,0 +1,166 @@
+// Tests of the spawn scheduler driven by a fake clock:
+//   g++ -std=c++20 -O2 -o spawn_scheduler_test SpawnSchedulerTest.cpp ../SpawnScheduler.cpp
+//   ./spawn_scheduler_test
+// Exits with the number of failed checks.
+
+#include "../SpawnScheduler.h"
+
+#include <cstdio>
+#include <string>
+
+using namespace Plugins::SolarControl;
+
+namespace
+{
+	int failures = 0;
+
+	void Check(bool condition, const char* what)
+	{
+		if (!condition)
+		{
+			std::printf("FAILED: %s\n", what);
+			failures++;
+		}
+	}
+
+	//! Time only moves when a test moves it
+	int64_t now = 0;
+
+	SpawnScheduler MakeScheduler()
+	{
+		now = 0;
+		return SpawnScheduler([] { return now; });
+	}
+
+	//! A job that spawns one thing per step, each taking stepCost microseconds
+	SpawnScheduler::Step Spawns(int count, int64_t stepCost, int* spawned = nullptr)
+	{
+		return [count, stepCost, spawned, done = 0]() mutable {
+			now += stepCost;
+			if (spawned)
+				(*spawned)++;
+			return ++done >= count;
+		};
+	}
+
+	void TestOrder()
+	{
+		auto scheduler = MakeScheduler();
+		std::string order;
+		const auto record = [&order](char job) {
+			return [&order, job] {
+				order += job;
+				return true;
+			};
+		};
+
+		scheduler.Enqueue(0, record('a'));
+		scheduler.Enqueue(5, record('b'));
+		scheduler.Enqueue(0, record('c'));
+		scheduler.Enqueue(5, record('d'));
+		scheduler.Enqueue(-1, record('e'));
+		scheduler.Run(1000);
+
+		Check(order == "bdace", "higher priorities run first and equal priorities in the order they were queued");
+		Check(scheduler.QueueDepth() == 0, "the queue is empty after running every job");
+	}
+
+	void TestBudget()
+	{
+		auto scheduler = MakeScheduler();
+		int spawned = 0;
+		scheduler.Enqueue(0, Spawns(10, 300, &spawned));
+
+		scheduler.Run(1000);
+		Check(spawned == 4, "steps run until the budget is spent");
+		Check(scheduler.QueueDepth() == 1, "an unfinished job stays queued");
+
+		scheduler.Run(1000);
+		scheduler.Run(1000);
+		Check(spawned == 10, "the job is finished over the following ticks");
+		Check(scheduler.QueueDepth() == 0, "a finished job leaves the queue");
+		Check(scheduler.GetMetrics().stepsRun == 10, "every step is counted");
+	}
+
+	void TestProgress()
+	{
+		auto scheduler = MakeScheduler();
+		int spawned = 0;
+		scheduler.Enqueue(0, Spawns(3, 5000, &spawned));
+
+		scheduler.Run(1000);
+		Check(spawned == 1, "one step runs even when it takes longer than the whole budget");
+		Check(scheduler.GetMetrics().budgetOverruns == 1, "a step over the budget counts as an overrun");
+
+		scheduler.Run(0);
+		Check(spawned == 2, "one step runs with no budget at all");
+	}
+
+	void TestCompletion()
+	{
+		auto scheduler = MakeScheduler();
+		int completions = 0;
+		int64_t completedAt = -1;
+		scheduler.Enqueue(0, Spawns(4, 100), [&] {
+			completions++;
+			completedAt = now;
+		});
+
+		now = 500;
+		scheduler.Run(250);
+		Check(completions == 0, "the completion callback waits for the last step");
+
+		now = 2000;
+		scheduler.Run(250);
+		Check(completions == 1, "the completion callback runs once the job is finished");
+		Check(completedAt == 2100, "the completion callback runs right after the last step");
+
+		const auto& metrics = scheduler.GetMetrics();
+		Check(metrics.jobsQueued == 1 && metrics.jobsCompleted == 1, "queued and completed jobs are counted");
+		Check(metrics.lastLatencyInMicroseconds == 2100 && metrics.maxLatencyInMicroseconds == 2100 && metrics.totalLatencyInMicroseconds == 2100,
+		    "latency is measured from queueing to completion");
+
+		scheduler.Run(250);
+		Check(completions == 1, "the completion callback runs only once");
+	}
+
+	void TestQueueDepth()
+	{
+		auto scheduler = MakeScheduler();
+		for (int i = 0; i < 5; i++)
+			scheduler.Enqueue(0, Spawns(1, 400));
+
+		Check(scheduler.GetMetrics().queueDepth == 5 && scheduler.GetMetrics().maxQueueDepth == 5, "queue depth follows enqueued jobs");
+
+		scheduler.Run(1000);
+		Check(scheduler.GetMetrics().queueDepth == 2, "queue depth is updated after a tick");
+		Check(scheduler.GetMetrics().maxQueueDepth == 5, "the deepest queue is kept");
+	}
+
+	void TestClear()
+	{
+		auto scheduler = MakeScheduler();
+		int completions = 0;
+		scheduler.Enqueue(0, Spawns(2, 10), [&completions] { completions++; });
+		scheduler.Enqueue(0, Spawns(2, 10), [&completions] { completions++; });
+		scheduler.Clear();
+		scheduler.Run(1000);
+
+		Check(scheduler.QueueDepth() == 0 && scheduler.GetMetrics().queueDepth == 0, "clearing empties the queue");
+		Check(completions == 0, "cleared jobs never run their completion callback");
+	}
+} // namespace
+
+int main()
+{
+	TestOrder();
+	TestBudget();
+	TestProgress();
+	TestCompletion();
+	TestQueueDepth();
+	TestClear();
+
+	if (!failures)
+		std::printf("All spawn scheduler tests passed.\n");
+	return failures;
+}
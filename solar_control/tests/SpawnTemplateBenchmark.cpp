@@ -0,0 +1,175 @@
+// Microbenchmark of solar spawn template instantiation against resolving the arch on every spawn, as CreateUserDefinedSolar used to.
+// The engine lookups are modelled with the standard library so it builds outside the server:
+//   g++ -std=c++20 -O2 -o spawn_template_benchmark SpawnTemplateBenchmark.cpp
+//   ./spawn_template_benchmark
+// The old path copies the arch out of the map, hashes the costume, voice and reputation nicknames, and looks up the IFF group and the pilot
+// personality by name. The new path copies a precompiled template.
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+	//! Freelancer's nickname hash, which CreateID and MakeId compute
+	uint32_t CreateID(const char* nickname)
+	{
+		static const auto table = [] {
+			std::array<uint32_t, 256> t {};
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				uint32_t x = i;
+				for (int bit = 0; bit < 8; bit++)
+					x = x & 1 ? (x >> 1) ^ (0xA001u << 14) : x >> 1;
+				t[i] = x;
+			}
+			return t;
+		}();
+
+		uint32_t hash = 0;
+		for (const char* c = nickname; *c; c++)
+			hash = (hash >> 8) ^ table[static_cast<uint8_t>(hash) ^ static_cast<uint8_t>(*c | 0x20)];
+		hash = (hash >> 24) | ((hash >> 8) & 0x0000FF00) | ((hash << 8) & 0x00FF0000) | (hash << 24);
+		return (hash >> 2) | 0x80000000;
+	}
+
+	//! Stand-in for pub::SpaceObj::SolarInfo, which is about this large
+	struct SolarInfo
+	{
+		int flag;
+		uint32_t arch, system;
+		float pos[3], orientation[3][3];
+		uint32_t loadout, head, body, leftHand, rightHand, accessories, voice;
+		char nickname[64];
+		uint32_t hitPoints, rep, base, mission;
+		char padding[256];
+	};
+
+	//! Stand-in for pub::AI::SetPersonalityParams, which embeds the whole personality
+	struct Personality
+	{
+		float values[180];
+	};
+
+	struct SolarArch
+	{
+		std::string solarArch = "largestation1";
+		std::string loadout = "space_station";
+		std::string iff = "fc_uk_grp";
+		uint32_t infocard = 197808;
+		std::string base = "li01_01_base";
+		std::string pilot = "pilot_solar_hardest";
+		uint32_t solarArchId = CreateID("largestation1");
+		uint32_t loadoutId = CreateID("space_station");
+		uint32_t baseId = CreateID("li01_01_base");
+	};
+
+	struct SpawnTemplate
+	{
+		SolarInfo solarInfo;
+		uint32_t iffGroup;
+		Personality personality;
+	};
+
+	std::map<std::wstring, SolarArch> arches;
+	std::map<std::string, uint32_t> reputationGroups;
+	std::map<std::string, Personality> personalities;
+
+	void FillCommon(SolarInfo& si, const SolarArch& arch)
+	{
+		memset(&si, 0, sizeof(si));
+		si.flag = 4;
+		si.arch = arch.solarArchId;
+		si.loadout = arch.loadoutId;
+		si.hitPoints = 1000;
+		si.base = arch.baseId;
+	}
+
+	//! What every spawn did before templates
+	void ResolveOnSpawn(const std::wstring& name, SolarInfo& si, uint32_t& iffGroup, Personality& personality)
+	{
+		SolarArch arch = arches[name];
+		FillCommon(si, arch);
+		si.head = CreateID("benchmark_male_head");
+		si.body = CreateID("benchmark_male_body");
+		si.voice = CreateID("atc_leg_m01");
+		si.rep = CreateID("fc_lr_grp");
+		iffGroup = reputationGroups.at(arch.iff);
+		personality = personalities.at(arch.pilot);
+	}
+
+	SpawnTemplate Compile(const SolarArch& arch)
+	{
+		SpawnTemplate spawnTemplate {};
+		FillCommon(spawnTemplate.solarInfo, arch);
+		spawnTemplate.solarInfo.head = CreateID("benchmark_male_head");
+		spawnTemplate.solarInfo.body = CreateID("benchmark_male_body");
+		spawnTemplate.solarInfo.voice = CreateID("atc_leg_m01");
+		spawnTemplate.solarInfo.rep = CreateID("fc_lr_grp");
+		spawnTemplate.iffGroup = reputationGroups.at(arch.iff);
+		spawnTemplate.personality = personalities.at(arch.pilot);
+		return spawnTemplate;
+	}
+
+	template<typename Spawn>
+	double NanosecondsPerSpawn(int iterations, Spawn&& spawn)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++)
+			spawn(i);
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+		return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / iterations;
+	}
+} // namespace
+
+int main()
+{
+	constexpr int archCount = 64;
+	constexpr int iterations = 1'000'000;
+
+	// A config with a realistic number of arches, IFF groups and pilots to look up in
+	for (int i = 0; i < 200; i++)
+	{
+		reputationGroups["fc_grp_" + std::to_string(i)] = CreateID(("fc_grp_" + std::to_string(i)).c_str());
+		personalities["pilot_" + std::to_string(i)] = Personality {};
+	}
+	reputationGroups["fc_uk_grp"] = CreateID("fc_uk_grp");
+	personalities["pilot_solar_hardest"] = Personality {};
+
+	std::vector<std::wstring> names;
+	std::vector<SpawnTemplate> templates;
+	for (int i = 0; i < archCount; i++)
+	{
+		names.emplace_back(L"station" + std::to_wstring(i));
+		arches[names.back()] = SolarArch();
+		templates.emplace_back(Compile(arches[names.back()]));
+	}
+
+	SolarInfo si;
+	uint32_t iffGroup = 0;
+	Personality personality;
+	uint64_t sink = 0;
+
+	const double resolved = NanosecondsPerSpawn(iterations, [&](int i) {
+		ResolveOnSpawn(names[i % archCount], si, iffGroup, personality);
+		sink += si.head + iffGroup;
+	});
+
+	const double compiled = NanosecondsPerSpawn(iterations, [&](int i) {
+		const SpawnTemplate& spawnTemplate = templates[i % archCount];
+		si = spawnTemplate.solarInfo;
+		iffGroup = spawnTemplate.iffGroup;
+		personality = spawnTemplate.personality;
+		sink += si.head + iffGroup;
+	});
+
+	printf("resolved on every spawn: %7.1f ns\n", resolved);
+	printf("precompiled template:    %7.1f ns\n", compiled);
+	printf("speedup:                 %7.1fx\n", resolved / compiled);
+	return sink == 0;
+}
@@ -14,6 +14,7 @@
  * @paragraph configuration Configuration
  * @code
  * {
+ *	"randomSeed": 0,
  *	"sounds": ["dock_not_allowed", "dock_granted"]
  * }
  * @endcode
@@ -36,6 +37,7 @@ namespace Plugins::SoundManager
 		for (const auto& sound : conf.sounds)
 			conf.sound_ids.push_back(CreateID(sound.c_str()));
 
+		global->randomStream.Reseed("SoundManager", conf.randomSeed);
 		global->config = std::make_unique<Config>(std::move(conf));
 	}
 
@@ -44,7 +46,7 @@ namespace Plugins::SoundManager
 		// Player sound when player logs in
 
 		if (global->config->sound_ids.size())
-			Hk::Client::PlaySoundEffect(client, global->config->sound_ids[rand() % global->config->sound_ids.size()]);
+			Hk::Client::PlaySoundEffect(client, global->config->sound_ids[global->randomStream.Below(static_cast<uint>(global->config->sound_ids.size()))]);
 	}
 } // namespace Plugins::SoundManager
 
@@ -54,7 +56,7 @@ namespace Plugins::SoundManager
 
 using namespace Plugins::SoundManager;
 // REFL_AUTO must be global namespace
-REFL_AUTO(type(Config), field(sounds))
+REFL_AUTO(type(Config), field(sounds), field(randomSeed))
 
 DefaultDllMainSettings(LoadSettings);
 
@@ -3,6 +3,8 @@
 #include <FLHook.hpp>
 #include <plugin.h>
 
+#include "../common/Random.h"
+
 namespace Plugins::SoundManager
 {
 	//! Config data for this plugin
@@ -16,6 +18,9 @@ namespace Plugins::SoundManager
 
 		//! A vector of sounds converted to their ids
 		std::vector<uint> sound_ids;
+
+		//! Seed for picking login sounds so a session can be replayed. 0 picks a random seed on every load.
+		uint randomSeed = 0;
 	};
 
 	//! Global data for this plugin
@@ -23,5 +28,6 @@ namespace Plugins::SoundManager
 	{
 		std::unique_ptr<Config> config = nullptr;
 		ReturnCode returncode = ReturnCode::Default;
+		Random::Stream randomStream {"SoundManager"};
 	};
 } // namespace Plugins::SoundManager
@@ -45,6 +45,10 @@ namespace Plugins::SystemSensor
 			global->sensorEquip.insert(std::multimap<EquipId, Sensor>::value_type(CreateID(sensor.equipId.c_str()), s));
 			global->sensorSystem.insert(std::multimap<SystemId, Sensor>::value_type(CreateID(sensor.systemId.c_str()), s));
 		});
+
+		global->onlinePlayers.Clear();
+		for (const auto& player : Hk::Admin::GetPlayers())
+			global->onlinePlayers.Add(player.client, player.character);
 	}
 
 	void UserCmd_Net(ClientId& client, const std::wstring& param)
@@ -95,15 +99,22 @@ namespace Plugins::SystemSensor
 			return;
 		}
 
-		const auto targetClientId = Hk::Client::GetClientIdFromCharName(targetCharname);
-		if (targetClientId.has_error())
+		const auto targetClientId = global->onlinePlayers.Find(targetCharname);
+		if (!targetClientId)
+		{
+			PrintUserCmdText(client, L"ERR Player not logged in");
+			return;
+		}
+
+		const auto target = global->networks.find(targetClientId.value());
+		if (target == global->networks.end())
 		{
-			PrintUserCmdText(client, Hk::Err::ErrGetText(targetClientId.error()));
+			PrintUserCmdText(client, L"ERR Scan data not available");
 			return;
 		}
 
-		const auto& [targetSensorClientId, targetSensor] = *global->networks.find(targetClientId.value());
-		if (!targetSensorClientId || !global->networks[client].availableNetworkId || !targetSensor.lastScanNetworkId ||
+		const auto& targetSensor = target->second;
+		if (!global->networks[client].availableNetworkId || !targetSensor.lastScanNetworkId ||
 		    global->networks[client].availableNetworkId != targetSensor.lastScanNetworkId)
 		{
 			PrintUserCmdText(client, L"ERR Scan data not available");
@@ -160,6 +171,17 @@ namespace Plugins::SystemSensor
 		global->networks.erase(client);
 	}
 
+	void CharacterSelect([[maybe_unused]] const std::string& charFilename, ClientId& client)
+	{
+		if (const auto charName = (const wchar_t*)Players.GetActiveCharacterName(client))
+			global->onlinePlayers.Add(client, charName);
+	}
+
+	void DisConnect(ClientId& client, [[maybe_unused]] const enum EFLConnection& state)
+	{
+		global->onlinePlayers.Remove(client);
+	}
+
 	static void EnableSensorAccess(ClientId client)
 	{
 		// Retrieve the location and cargo list.
@@ -312,6 +334,8 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 	pi->versionMajor(PluginMajorVersion::VERSION_04);
 	pi->versionMinor(PluginMinorVersion::VERSION_00);
 	pi->emplaceHook(HookedCall::FLHook__ClearClientInfo, &ClearClientInfo, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__CharacterSelect, &CharacterSelect, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__DisConnect, &DisConnect);
 	pi->emplaceHook(HookedCall::IEngine__DockCall, &Dock_Call);
 	pi->emplaceHook(HookedCall::IServerImpl__GoTradelane, &GoTradelane);
 	pi->emplaceHook(HookedCall::IServerImpl__StopTradelane, &StopTradelane);
@@ -3,6 +3,8 @@
 #include <FLHook.hpp>
 #include <plugin.h>
 
+#include "../common/PlayerIndex.h"
+
 namespace Plugins::SystemSensor
 {
 	using NetworkId = uint;
@@ -57,5 +59,7 @@ namespace Plugins::SystemSensor
 		std::map<ClientId, ActiveNetwork> networks;
 		std::multimap<EquipId, Sensor> sensorEquip;
 		std::multimap<SystemId, Sensor> sensorSystem;
+		//! The characters that are online by name, maintained on character select and disconnect
+		PlayerIndex::Index onlinePlayers;
 	};
 } // namespace Plugins::SystemSensor
\ No newline at end of file
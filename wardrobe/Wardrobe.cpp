@@ -112,8 +112,35 @@ namespace Plugins::Wardrobe
 		}
 	}
 
+	//! Changes the head or body in a character file on the worker thread
+	void RunWardrobeChange(const CharacterJobs::Job& job)
+	{
+		const std::string characterFile = wstos(job.Arg("characterFile"));
+		CharacterJobs::CharacterFile file(characterFile);
+		file.Set("Player", wstos(job.Arg("part")), wstos(job.Arg("costume")));
+		file.Write(characterFile);
+	}
+
+	//! Unlocks the account of a wardrobe change and logs its outcome on the game thread
+	void CompleteWardrobeChange(const CharacterJobs::Job& job, const std::string& error)
+	{
+		global->accountLocks.Release(job.id);
+
+		if (!error.empty())
+		{
+			AddLog(LogType::Normal,
+			    LogLevel::Err,
+			    std::format("User {} costume change to {} ({})", wstos(job.Arg("characterName")), wstos(job.Arg("costume")), error));
+			return;
+		}
+
+		AddLog(LogType::Normal, LogLevel::Info, std::format("User {} costume change to {}", wstos(job.Arg("characterName")), wstos(job.Arg("costume"))));
+	}
+
 	void ProcessWardrobeRestarts()
 	{
+		global->jobs->Drain();
+
 		while (!global->pendingRestarts.empty())
 		{
 			Wardrobe restart = global->pendingRestarts.back();
@@ -122,33 +149,20 @@ namespace Plugins::Wardrobe
 
 			global->pendingRestarts.pop_back();
 
-			try
-			{
-				// Overwrite the existing character file
-				std::string scCharFile = CoreGlobals::c()->accPath + wstos(restart.directory) + "\\" + wstos(restart.characterFile) + ".fl";
-				FlcDecodeFile(scCharFile.c_str(), scCharFile.c_str());
-				if (restart.head)
-				{
-					IniWrite(scCharFile, "Player", "head", " " + restart.costume);
-				}
-				else
-					IniWrite(scCharFile, "Player", "body", " " + restart.costume);
-
-				if (!FLHookConfig::i()->general.disableCharfileEncryption)
-					FlcEncodeFile(scCharFile.c_str(), scCharFile.c_str());
-
-				AddLog(LogType::Normal, LogLevel::Info, std::format("User {} costume change to {}", wstos(restart.characterFile).c_str(), restart.costume));
-			}
-			catch (char* err)
-			{
-				AddLog(LogType::Normal,
-				    LogLevel::Err,
-				    std::format("User {} costume change to {} ({})", wstos(restart.characterName).c_str(), restart.costume, err));
-			}
-			catch (...)
+			const auto account = Hk::Client::GetAccountByCharName(restart.characterName);
+			if (account.has_error())
 			{
-				AddLog(LogType::Normal, LogLevel::Err, std::format("User {} costume change to {}", wstos(restart.characterName).c_str(), restart.costume));
+				AddLog(LogType::Normal, LogLevel::Err, std::format("User {} costume change to {} (no acc)", wstos(restart.characterName), restart.costume));
+				continue;
 			}
+
+			CharacterJobs::Job job;
+			job.kind = "wardrobe";
+			job.args = {{"characterName", restart.characterName},
+			    {"characterFile", stows(CoreGlobals::c()->accPath) + restart.directory + L"\\" + restart.characterFile + L".fl"},
+			    {"part", restart.head ? L"head" : L"body"},
+			    {"costume", stows(restart.costume)}};
+			global->accountLocks.Lock(global->jobs->Submit(std::move(job)), account.value());
 		}
 	}
 
@@ -180,10 +194,22 @@ namespace Plugins::Wardrobe
 
 	const std::vector<Timer> timers = {{ProcessWardrobeRestarts, 1}};
 
+	//! Stops the job worker on the game thread, before the plugin is unloaded with the server
+	void Shutdown()
+	{
+		if (global->jobs)
+			global->jobs->Stop();
+	}
+
 	void LoadSettings()
 	{
 		auto config = Serializer::JsonToObject<Config>();
 		global->config = std::make_unique<Config>(config);
+
+		// Stop the worker of a previous load first, whatever it did not get to stays in the journal for the new one
+		if (global->jobs)
+			global->jobs->Stop();
+		global->jobs = std::make_unique<CharacterJobs::Queue>(CoreGlobals::c()->accPath + "wardrobe_jobs.log", RunWardrobeChange, CompleteWardrobeChange);
 	}
 
 	///////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -208,11 +234,12 @@ extern "C" EXPORT void ExportPluginInfo(PluginInfo* pi)
 {
 	pi->name("Wardrobe Plugin");
 	pi->shortName("wardrobe");
-	pi->mayUnload(true);
+	pi->mayUnload(false);
 	pi->commands(&commands);
 	pi->timers(&timers);
 	pi->returnCode(&global->returncode);
 	pi->versionMajor(PluginMajorVersion::VERSION_04);
 	pi->versionMinor(PluginMinorVersion::VERSION_00);
 	pi->emplaceHook(HookedCall::FLHook__LoadSettings, &LoadSettings, HookStep::After);
+	pi->emplaceHook(HookedCall::IServerImpl__Shutdown, &Shutdown);
 }
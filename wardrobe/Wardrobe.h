@@ -2,6 +2,8 @@
 #include <FLHook.hpp>
 #include <plugin.h>
 
+#include "../common/CharacterJobs.h"
+
 namespace Plugins::Wardrobe
 {
 	//! Struct that holds a pending wardrobe change
@@ -32,5 +34,10 @@ namespace Plugins::Wardrobe
 
 		//! A vector containing the restarts (wardrobe changes) that are currently pending
 		std::vector<Wardrobe> pendingRestarts;
+
+		//! Applies the wardrobe changes once the characters are offline
+		std::unique_ptr<CharacterJobs::Queue> jobs;
+		//! The accounts of characters whose files are being rewritten
+		CharacterJobs::AccountLocks accountLocks;
 	};
 } // namespace Plugins::Wardrobe
\ No newline at end of file
@@ -20,7 +20,7 @@
  * 
  * @paragraph ipc IPC Interfaces Used
  * NpcCommunicator: uses CreateNpc method with parameters (const std::wstring& name, Vector position, const Matrix& rotation, SystemId systemId, bool varyPosition)
- * SolarCommunicator: uses CreateUserDefinedSolar method with parameters (const std::wstring& name, Vector pos, const Matrix& rot, uint iSystem, bool varyPosition, bool mission)
+ * SolarCommunicator: uses CreateSolars method with parameters (std::span<const SolarSpawnRequest> requests)
  */
 
 #include "WaveDefence.h"
@@ -212,11 +212,17 @@ namespace Plugins::WaveDefence
 			}
 		}
 
-		// Spawn solars
+		// Spawn solars in a single batch
+		std::vector<Plugins::SolarControl::SolarSpawnRequest> solarRequests;
 		for (auto const& solar : wave.solars)
 		{
-			game.spawnedSolars.push_back(
-			    global->solarCommunicator->CreateSolar(solar, game.system.positionVector, rotation, game.system.systemId, true, true));
+			solarRequests.push_back({solar, game.system.positionVector, rotation, game.system.systemId, true, true});
+		}
+
+		for (auto const& solar : global->solarCommunicator->CreateSolars(solarRequests))
+		{
+			if (solar)
+				game.spawnedSolars.push_back(solar);
 		}
 
 		// Actions for all players in group